@@ -0,0 +1,266 @@
+// Copyright 2022 IOTA Stiftung
+// SPDX-License-Identifier: Apache-2.0
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "client/api/json_parser/json_stream.h"
+
+#define JSON_STREAM_KEY_MAX 32
+
+typedef enum {
+  JS_BEGIN = 0,     ///< expect the opening brace of the document
+  JS_MEMBER,        ///< expect a member name or the closing brace
+  JS_KEY,           ///< inside a member name
+  JS_COLON,         ///< expect the name separator
+  JS_VALUE,         ///< expect a member value
+  JS_ITEM,          ///< expect an array element or the closing bracket
+  JS_CAPTURE,       ///< inside a value
+  JS_AFTER_ITEM,    ///< expect a comma or the closing bracket
+  JS_AFTER_MEMBER,  ///< expect a comma or the closing brace
+  JS_END,           ///< the document is complete
+  JS_ERROR,         ///< the document is invalid or the stream was aborted
+} json_stream_state_e;
+
+struct json_stream {
+  json_stream_state_e state;      ///< the parser state
+  json_stream_handler_t handler;  ///< the callbacks
+  char key[JSON_STREAM_KEY_MAX];  ///< the name of the current top-level member
+  size_t key_len;                 ///< the length of the member name
+  bool first;                     ///< no member or element was parsed yet in the current object or array
+  bool in_array;                  ///< the captured value is an array element
+  char kind;                      ///< the first character of the captured value
+  size_t depth;                   ///< the nesting level inside the captured value
+  bool in_str;                    ///< inside a string of the captured value
+  bool escape;                    ///< the previous character was a backslash
+  size_t len;                     ///< the length of the captured value
+  size_t max;                     ///< the capacity of the value buffer
+  char value[];                   ///< the captured value
+};
+
+static bool is_ws(char c) { return c == ' ' || c == '\t' || c == '\r' || c == '\n'; }
+
+static bool is_value_start(char c) {
+  return c == '"' || c == '{' || c == '[' || c == '-' || (c >= '0' && c <= '9') || c == 't' || c == 'f' || c == 'n';
+}
+
+static int value_append(json_stream_t* js, char c) {
+  if (js->len >= js->max) {
+    printf("[%s:%d] value of %s exceeds %zu bytes\n", __func__, __LINE__, js->key, js->max);
+    return -1;
+  }
+  js->value[js->len++] = c;
+  return 0;
+}
+
+static int capture_start(json_stream_t* js, char c, bool in_array) {
+  if (!is_value_start(c)) {
+    printf("[%s:%d] unexpected character '%c'\n", __func__, __LINE__, c);
+    return -1;
+  }
+  js->in_array = in_array;
+  js->kind = c;
+  js->depth = (c == '{' || c == '[') ? 1 : 0;
+  js->in_str = false;
+  js->escape = false;
+  js->len = 0;
+  js->state = JS_CAPTURE;
+  return value_append(js, c);
+}
+
+static int capture_end(json_stream_t* js) {
+  js->value[js->len] = '\0';
+  json_stream_cb cb = js->in_array ? js->handler.on_element : js->handler.on_field;
+  js->state = js->in_array ? JS_AFTER_ITEM : JS_AFTER_MEMBER;
+  if (cb && cb(js->key, js->value, js->len, js->handler.ctx) != 0) {
+    return -1;
+  }
+  return 0;
+}
+
+// returns 1 if the character was consumed, 0 if it ends a number or literal and needs to be processed again
+static int capture_char(json_stream_t* js, char c) {
+  if (js->kind != '"' && js->kind != '{' && js->kind != '[') {
+    if (is_ws(c) || c == ',' || c == '}' || c == ']') {
+      return capture_end(js) == 0 ? 0 : -1;
+    }
+    return value_append(js, c) == 0 ? 1 : -1;
+  }
+
+  if (value_append(js, c) != 0) {
+    return -1;
+  }
+  if (js->kind == '"') {
+    if (js->escape) {
+      js->escape = false;
+    } else if (c == '\\') {
+      js->escape = true;
+    } else if (c == '"') {
+      return capture_end(js) == 0 ? 1 : -1;
+    }
+    return 1;
+  }
+
+  if (js->in_str) {
+    if (js->escape) {
+      js->escape = false;
+    } else if (c == '\\') {
+      js->escape = true;
+    } else if (c == '"') {
+      js->in_str = false;
+    }
+  } else if (c == '"') {
+    js->in_str = true;
+  } else if (c == '{' || c == '[') {
+    js->depth++;
+  } else if (c == '}' || c == ']') {
+    if (--js->depth == 0) {
+      return capture_end(js) == 0 ? 1 : -1;
+    }
+  }
+  return 1;
+}
+
+static int parse_char(json_stream_t* js, char c) {
+  switch (js->state) {
+    case JS_BEGIN:
+      if (c == '{') {
+        js->state = JS_MEMBER;
+        js->first = true;
+      } else if (!is_ws(c)) {
+        return -1;
+      }
+      return 1;
+    case JS_MEMBER:
+      if (c == '"') {
+        js->state = JS_KEY;
+        js->key_len = 0;
+        js->escape = false;
+      } else if (c == '}' && js->first) {
+        js->state = JS_END;
+      } else if (!is_ws(c)) {
+        return -1;
+      }
+      return 1;
+    case JS_KEY:
+      if (c == '"' && !js->escape) {
+        js->key[js->key_len] = '\0';
+        js->state = JS_COLON;
+        return 1;
+      }
+      js->escape = !js->escape && c == '\\';
+      if (js->key_len + 1 >= sizeof(js->key)) {
+        printf("[%s:%d] member name is too long\n", __func__, __LINE__);
+        return -1;
+      }
+      js->key[js->key_len++] = c;
+      return 1;
+    case JS_COLON:
+      if (c == ':') {
+        js->state = JS_VALUE;
+      } else if (!is_ws(c)) {
+        return -1;
+      }
+      return 1;
+    case JS_VALUE:
+      if (is_ws(c)) {
+        return 1;
+      }
+      if (c == '[') {
+        js->state = JS_ITEM;
+        js->first = true;
+        return 1;
+      }
+      return capture_start(js, c, false) == 0 ? 1 : -1;
+    case JS_ITEM:
+      if (is_ws(c)) {
+        return 1;
+      }
+      if (c == ']' && js->first) {
+        js->state = JS_AFTER_MEMBER;
+        return 1;
+      }
+      return capture_start(js, c, true) == 0 ? 1 : -1;
+    case JS_CAPTURE:
+      return capture_char(js, c);
+    case JS_AFTER_ITEM:
+      if (c == ',') {
+        js->state = JS_ITEM;
+        js->first = false;
+      } else if (c == ']') {
+        js->state = JS_AFTER_MEMBER;
+      } else if (!is_ws(c)) {
+        return -1;
+      }
+      return 1;
+    case JS_AFTER_MEMBER:
+      if (c == ',') {
+        js->state = JS_MEMBER;
+        js->first = false;
+      } else if (c == '}') {
+        js->state = JS_END;
+      } else if (!is_ws(c)) {
+        return -1;
+      }
+      return 1;
+    case JS_END:
+      return is_ws(c) ? 1 : -1;
+    case JS_ERROR:
+    default:
+      return -1;
+  }
+}
+
+json_stream_t* json_stream_new(size_t value_max, json_stream_handler_t const* const handler) {
+  if (value_max == 0 || handler == NULL) {
+    printf("[%s:%d] invalid parameters\n", __func__, __LINE__);
+    return NULL;
+  }
+
+  json_stream_t* js = malloc(sizeof(json_stream_t) + value_max + 1);
+  if (js) {
+    memset(js, 0, sizeof(json_stream_t));
+    js->state = JS_BEGIN;
+    js->handler = *handler;
+    js->max = value_max;
+  }
+  return js;
+}
+
+int json_stream_feed(json_stream_t* js, char const* data, size_t len) {
+  if (js == NULL || (data == NULL && len > 0)) {
+    printf("[%s:%d] invalid parameters\n", __func__, __LINE__);
+    return -1;
+  }
+
+  size_t i = 0;
+  while (i < len) {
+    int ret = parse_char(js, data[i]);
+    if (ret < 0) {
+      js->state = JS_ERROR;
+      return -1;
+    }
+    i += ret;
+  }
+  return 0;
+}
+
+int json_stream_finish(json_stream_t* js) {
+  if (js == NULL || js->state != JS_END) {
+    return -1;
+  }
+  return 0;
+}
+
+void json_stream_free(json_stream_t* js) { free(js); }
+
+int json_stream_str(char const* value, size_t len, char buf[], size_t buf_len) {
+  if (value == NULL || buf == NULL || len < 2 || value[0] != '"' || value[len - 1] != '"' || len - 2 >= buf_len) {
+    return -1;
+  }
+  memcpy(buf, value + 1, len - 2);
+  buf[len - 2] = '\0';
+  return 0;
+}
@@ -0,0 +1,98 @@
+// Copyright 2022 IOTA Stiftung
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef __CLIENT_API_JSON_PARSER_JSON_STREAM_H__
+#define __CLIENT_API_JSON_PARSER_JSON_STREAM_H__
+
+#include <stdbool.h>
+#include <stddef.h>
+
+/**
+ * @brief Receives a value from the JSON stream
+ *
+ * The value is the raw JSON text of a single value, strings keep their quotes. It is NULL terminated and only valid
+ * during the call.
+ *
+ * @param[in] key The name of the top-level member
+ * @param[in] value The JSON text of the value
+ * @param[in] len The length of the value
+ * @param[in] ctx The user context
+ * @return int 0 on success, non-zero aborts the stream
+ */
+typedef int (*json_stream_cb)(char const* key, char const* value, size_t len, void* ctx);
+
+/**
+ * @brief Callbacks of the JSON stream parser
+ *
+ */
+typedef struct {
+  json_stream_cb on_field;    ///< called for each top-level member that is not an array
+  json_stream_cb on_element;  ///< called for each element of a top-level array member
+  void* ctx;                  ///< user context passed to the callbacks
+} json_stream_handler_t;
+
+/**
+ * @brief An incremental parser of a JSON object
+ *
+ * The object can be fed in chunks of any size. Only one value is kept in memory at a time, so the memory used does not
+ * depend on the size of the document but on the size of its largest element.
+ *
+ */
+typedef struct json_stream json_stream_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Create a JSON stream parser
+ *
+ * @param[in] value_max The maximum length of a single value
+ * @param[in] handler The callbacks
+ * @return json_stream_t* NULL on errors
+ */
+json_stream_t* json_stream_new(size_t value_max, json_stream_handler_t const* const handler);
+
+/**
+ * @brief Feed a chunk of the document to the parser
+ *
+ * @param[in] js The parser
+ * @param[in] data A chunk of the document
+ * @param[in] len The length of the chunk
+ * @return int 0 on success, -1 on malformed documents, oversized values or aborted streams
+ */
+int json_stream_feed(json_stream_t* js, char const* data, size_t len);
+
+/**
+ * @brief Check that a complete document was parsed
+ *
+ * @param[in] js The parser
+ * @return int 0 if the document was complete, otherwise -1
+ */
+int json_stream_finish(json_stream_t* js);
+
+/**
+ * @brief Free a JSON stream parser
+ *
+ * @param[in] js The parser
+ */
+void json_stream_free(json_stream_t* js);
+
+/**
+ * @brief Copy a JSON string value without its quotes
+ *
+ * Escape sequences are not decoded, it is meant for IDs, hex strings and other plain values.
+ *
+ * @param[in] value The JSON text of a string value
+ * @param[in] len The length of the value
+ * @param[out] buf The buffer for the string
+ * @param[in] buf_len The length of the buffer
+ * @return int 0 on success, -1 if the value is not a string or does not fit
+ */
+int json_stream_str(char const* value, size_t len, char buf[], size_t buf_len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,235 @@
+// Copyright 2022 IOTA Stiftung
+// SPDX-License-Identifier: Apache-2.0
+
+#include <stdint.h>
+#include <string.h>
+
+#include "client/api/json_parser/json_tokens.h"
+#include "core/utils/byte_buffer.h"
+
+typedef enum {
+  JT_VALUE = 0,  ///< expect a value, or the closing bracket of an empty array
+  JT_KEY,        ///< expect a member name, or the closing brace of an empty object
+  JT_COLON,      ///< expect the name separator
+  JT_NEXT,       ///< expect a comma or the closing brace or bracket
+} json_tok_expect_e;
+
+static bool is_ws(char c) { return c == ' ' || c == '\t' || c == '\r' || c == '\n'; }
+
+static bool is_delim(char c) { return is_ws(c) || c == ',' || c == ']' || c == '}' || c == ':'; }
+
+static bool is_literal(char const js[], size_t start, size_t end) {
+  static char const* const literals[] = {"true", "false", "null"};
+  for (size_t i = 0; i < sizeof(literals) / sizeof(literals[0]); i++) {
+    if (end - start == strlen(literals[i]) && memcmp(js + start, literals[i], end - start) == 0) {
+      return true;
+    }
+  }
+  for (size_t i = start; i < end; i++) {
+    char c = js[i];
+    if (!((c >= '0' && c <= '9') || c == '-' || c == '+' || c == '.' || c == 'e' || c == 'E')) {
+      return false;
+    }
+  }
+  return js[start] == '-' || (js[start] >= '0' && js[start] <= '9');
+}
+
+// returns the offset of the closing quote
+static int string_end(char const js[], size_t len, size_t pos) {
+  for (; pos < len; pos++) {
+    if (js[pos] == '"') {
+      return pos;
+    }
+    if ((unsigned char)js[pos] < 0x20) {
+      return -1;
+    }
+    if (js[pos] == '\\') {
+      // escapes are kept as they are, the escaped character can not end the string
+      pos++;
+    }
+  }
+  return -1;
+}
+
+int json_tokenize(char const js[], size_t len, json_tok_t toks[], size_t max_toks) {
+  if (js == NULL || toks == NULL || len > UINT32_MAX) {
+    return JSON_TOK_ERR_INVALID;
+  }
+  if (max_toks > UINT16_MAX) {
+    max_toks = UINT16_MAX;
+  }
+
+  size_t count = 0;
+  // the innermost open object or array, its next field holds the index of its parent plus one until it is closed
+  int open = -1;
+  json_tok_expect_e expect = JT_VALUE;
+  for (size_t pos = 0; pos < len; pos++) {
+    char c = js[pos];
+    if (is_ws(c)) {
+      continue;
+    }
+
+    if (c == ',') {
+      if (expect != JT_NEXT || open < 0) {
+        return JSON_TOK_ERR_INVALID;
+      }
+      expect = toks[open].type == JSON_TOK_OBJECT ? JT_KEY : JT_VALUE;
+      continue;
+    }
+    if (c == ':') {
+      if (expect != JT_COLON) {
+        return JSON_TOK_ERR_INVALID;
+      }
+      expect = JT_VALUE;
+      continue;
+    }
+    if (c == '}' || c == ']') {
+      json_tok_type_t type = c == '}' ? JSON_TOK_OBJECT : JSON_TOK_ARRAY;
+      if (open < 0 || toks[open].type != type) {
+        return JSON_TOK_ERR_INVALID;
+      }
+      // a comma must be followed by a member or an element
+      bool empty = toks[open].size == 0 && expect == (type == JSON_TOK_OBJECT ? JT_KEY : JT_VALUE);
+      if (expect != JT_NEXT && !empty) {
+        return JSON_TOK_ERR_INVALID;
+      }
+      int parent = (int)toks[open].next - 1;
+      toks[open].end = pos + 1;
+      toks[open].next = count;
+      open = parent;
+      expect = JT_NEXT;
+      continue;
+    }
+
+    // a key or a value starts here
+    if ((expect != JT_VALUE && expect != JT_KEY) || (open < 0 && count > 0)) {
+      return JSON_TOK_ERR_INVALID;
+    }
+    if (expect == JT_KEY && c != '"') {
+      return JSON_TOK_ERR_INVALID;
+    }
+    if (count == max_toks) {
+      return JSON_TOK_ERR_NOMEM;
+    }
+    json_tok_t* tok = &toks[count];
+    memset(tok, 0, sizeof(json_tok_t));
+    tok->start = pos;
+    if (c == '{' || c == '[') {
+      tok->type = c == '{' ? JSON_TOK_OBJECT : JSON_TOK_ARRAY;
+      tok->next = open + 1;
+    } else if (c == '"') {
+      int end = string_end(js, len, pos + 1);
+      if (end < 0) {
+        return JSON_TOK_ERR_INVALID;
+      }
+      tok->type = JSON_TOK_STRING;
+      tok->start = pos + 1;
+      tok->end = end;
+      pos = end;
+    } else {
+      size_t end = pos;
+      while (end < len && !is_delim(js[end])) {
+        end++;
+      }
+      if (!is_literal(js, pos, end)) {
+        return JSON_TOK_ERR_INVALID;
+      }
+      tok->type = JSON_TOK_PRIMITIVE;
+      tok->end = end;
+      pos = end - 1;
+    }
+
+    // keys and elements are counted by their container, values of members by their key
+    if (open >= 0 && (expect == JT_KEY || toks[open].type == JSON_TOK_ARRAY)) {
+      toks[open].size++;
+    }
+    if (tok->type == JSON_TOK_OBJECT || tok->type == JSON_TOK_ARRAY) {
+      open = count;
+      expect = tok->type == JSON_TOK_OBJECT ? JT_KEY : JT_VALUE;
+    } else {
+      expect = expect == JT_KEY ? JT_COLON : JT_NEXT;
+      tok->next = count + 1;
+    }
+    count++;
+  }
+
+  if (open >= 0 || count == 0 || expect != JT_NEXT) {
+    return JSON_TOK_ERR_INVALID;
+  }
+  return count;
+}
+
+int json_tok_get(char const js[], json_tok_t const toks[], int obj, char const key[]) {
+  if (obj < 0 || toks[obj].type != JSON_TOK_OBJECT) {
+    return -1;
+  }
+  int i = obj + 1;
+  for (uint16_t m = 0; m < toks[obj].size; m++) {
+    if (json_tok_eq(js, &toks[i], key)) {
+      return i + 1;
+    }
+    i = toks[i + 1].next;
+  }
+  return -1;
+}
+
+int json_tok_at(json_tok_t const toks[], int arr, size_t idx) {
+  if (arr < 0 || toks[arr].type != JSON_TOK_ARRAY || idx >= toks[arr].size) {
+    return -1;
+  }
+  int i = arr + 1;
+  while (idx--) {
+    i = toks[i].next;
+  }
+  return i;
+}
+
+bool json_tok_eq(char const js[], json_tok_t const* tok, char const str[]) {
+  size_t len = tok->end - tok->start;
+  return (tok->type == JSON_TOK_STRING || tok->type == JSON_TOK_PRIMITIVE) && strlen(str) == len &&
+         memcmp(js + tok->start, str, len) == 0;
+}
+
+int json_tok_u64(char const js[], json_tok_t const* tok, uint64_t* value) {
+  if ((tok->type != JSON_TOK_STRING && tok->type != JSON_TOK_PRIMITIVE) || tok->end == tok->start) {
+    return -1;
+  }
+  uint64_t v = 0;
+  for (uint32_t i = tok->start; i < tok->end; i++) {
+    char c = js[i];
+    if (c < '0' || c > '9' || v > (UINT64_MAX - (c - '0')) / 10) {
+      return -1;
+    }
+    v = v * 10 + (c - '0');
+  }
+  *value = v;
+  return 0;
+}
+
+int json_tok_u32(char const js[], json_tok_t const* tok, uint32_t* value) {
+  uint64_t v = 0;
+  if (json_tok_u64(js, tok, &v) != 0 || v > UINT32_MAX) {
+    return -1;
+  }
+  *value = (uint32_t)v;
+  return 0;
+}
+
+int json_tok_bool(char const js[], json_tok_t const* tok, bool* value) {
+  if (tok->type != JSON_TOK_PRIMITIVE) {
+    return -1;
+  }
+  if (json_tok_eq(js, tok, "true") || json_tok_eq(js, tok, "false")) {
+    *value = js[tok->start] == 't';
+    return 0;
+  }
+  return -1;
+}
+
+int json_tok_hex(char const js[], json_tok_t const* tok, uint8_t buf[], size_t buf_len) {
+  size_t len = tok->end - tok->start;
+  if (tok->type != JSON_TOK_STRING || len != 2 + buf_len * 2) {
+    return -1;
+  }
+  return hex_2_bin(js + tok->start, len, "0x", buf, buf_len) == 0 ? 0 : -1;
+}
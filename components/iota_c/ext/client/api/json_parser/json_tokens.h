@@ -0,0 +1,133 @@
+// Copyright 2022 IOTA Stiftung
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef __CLIENT_API_JSON_PARSER_JSON_TOKENS_H__
+#define __CLIENT_API_JSON_PARSER_JSON_TOKENS_H__
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// the document is malformed
+#define JSON_TOK_ERR_INVALID -1
+// the document has more values than the token array can hold
+#define JSON_TOK_ERR_NOMEM -2
+
+/**
+ * @brief The type of a token
+ *
+ */
+typedef enum {
+  JSON_TOK_OBJECT = 1,  ///< an object, followed by its keys and values
+  JSON_TOK_ARRAY,       ///< an array, followed by its elements
+  JSON_TOK_STRING,      ///< a string or an object key, without the quotes
+  JSON_TOK_PRIMITIVE,   ///< a number, true, false or null
+} json_tok_type_t;
+
+/**
+ * @brief A value of the document, it refers to the text of the document instead of holding a copy
+ *
+ */
+typedef struct {
+  uint32_t start;  ///< the offset of the first character
+  uint32_t end;    ///< the offset after the last character
+  uint16_t size;   ///< the number of members of an object or elements of an array
+  uint16_t next;   ///< the index of the token after the value and all its children
+  uint8_t type;    ///< the json_tok_type_t of the value
+} json_tok_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Split a JSON document into tokens
+ *
+ * The document is not modified and nothing is allocated, the tokens are written to the array of the caller in
+ * document order. Objects are followed by their keys, each key by its value.
+ *
+ * @param[in] js The document
+ * @param[in] len The length of the document
+ * @param[out] toks The tokens
+ * @param[in] max_toks The length of the token array
+ * @return int The number of tokens, JSON_TOK_ERR_INVALID or JSON_TOK_ERR_NOMEM
+ */
+int json_tokenize(char const js[], size_t len, json_tok_t toks[], size_t max_toks);
+
+/**
+ * @brief Find the value of an object member
+ *
+ * @param[in] js The document
+ * @param[in] toks The tokens of the document
+ * @param[in] obj The index of the object
+ * @param[in] key The name of the member
+ * @return int The index of the value, -1 if the object has no such member
+ */
+int json_tok_get(char const js[], json_tok_t const toks[], int obj, char const key[]);
+
+/**
+ * @brief Find an element of an array
+ *
+ * @param[in] toks The tokens of the document
+ * @param[in] arr The index of the array
+ * @param[in] idx The position of the element
+ * @return int The index of the element, -1 if the array is shorter
+ */
+int json_tok_at(json_tok_t const toks[], int arr, size_t idx);
+
+/**
+ * @brief Compare a string or primitive with a C string
+ *
+ * @param[in] js The document
+ * @param[in] tok The token
+ * @param[in] str The string to compare with
+ * @return bool true if the text of the token is the string
+ */
+bool json_tok_eq(char const js[], json_tok_t const* tok, char const str[]);
+
+/**
+ * @brief Read an unsigned integer, numbers and strings of digits (e.g. amounts) are accepted
+ *
+ * @param[in] js The document
+ * @param[in] tok The token
+ * @param[out] value The integer
+ * @return int 0 on success, -1 if the value is not an unsigned 64-bit integer
+ */
+int json_tok_u64(char const js[], json_tok_t const* tok, uint64_t* value);
+
+/**
+ * @brief Read an unsigned 32-bit integer
+ *
+ * @param[in] js The document
+ * @param[in] tok The token
+ * @param[out] value The integer
+ * @return int 0 on success, -1 if the value is not an unsigned 32-bit integer
+ */
+int json_tok_u32(char const js[], json_tok_t const* tok, uint32_t* value);
+
+/**
+ * @brief Read a boolean
+ *
+ * @param[in] js The document
+ * @param[in] tok The token
+ * @param[out] value The boolean
+ * @return int 0 on success, -1 if the value is not true or false
+ */
+int json_tok_bool(char const js[], json_tok_t const* tok, bool* value);
+
+/**
+ * @brief Decode a 0x prefixed hex string of a fixed length, e.g. an ID
+ *
+ * @param[in] js The document
+ * @param[in] tok The token
+ * @param[out] buf The decoded bytes
+ * @param[in] buf_len The expected number of bytes
+ * @return int 0 on success, -1 if the value is not a hex string of buf_len bytes
+ */
+int json_tok_hex(char const js[], json_tok_t const* tok, uint8_t buf[], size_t buf_len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
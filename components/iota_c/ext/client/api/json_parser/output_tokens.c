@@ -0,0 +1,172 @@
+// Copyright 2022 IOTA Stiftung
+// SPDX-License-Identifier: Apache-2.0
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "sdkconfig.h"
+
+#include "client/api/json_parser/json_tokens.h"
+#include "client/api/json_parser/output_tokens.h"
+#include "core/models/outputs/outputs.h"
+
+// the Ed25519 public key hash, the alias ID and the NFT ID of addresses
+#define ADDRESS_HASH_BYTES 32
+
+// the members of the output metadata, the spent fields are only present on spent outputs
+static int parse_meta(char const json[], json_tok_t const toks[], int meta, get_output_t* data) {
+  int spent = json_tok_get(json, toks, meta, "isSpent");
+  int idx = json_tok_get(json, toks, meta, "outputIndex");
+  int booked = json_tok_get(json, toks, meta, "milestoneIndexBooked");
+  int booked_time = json_tok_get(json, toks, meta, "milestoneTimestampBooked");
+  int ledger = json_tok_get(json, toks, meta, "ledgerIndex");
+  int blk_id = json_tok_get(json, toks, meta, "blockId");
+  int tx_id = json_tok_get(json, toks, meta, "transactionId");
+  if (spent < 0 || idx < 0 || booked < 0 || booked_time < 0 || ledger < 0 || blk_id < 0 || tx_id < 0) {
+    return -1;
+  }
+
+  uint32_t output_index = 0;
+  if (json_tok_bool(json, &toks[spent], &data->meta.is_spent) != 0 ||
+      json_tok_u32(json, &toks[idx], &output_index) != 0 || output_index > UINT16_MAX ||
+      json_tok_u32(json, &toks[booked], &data->meta.ml_index_booked) != 0 ||
+      json_tok_u32(json, &toks[booked_time], &data->meta.ml_time_booked) != 0 ||
+      json_tok_u32(json, &toks[ledger], &data->meta.ledger_index) != 0 ||
+      json_tok_hex(json, &toks[blk_id], data->meta.block_id, sizeof(data->meta.block_id)) != 0 ||
+      json_tok_hex(json, &toks[tx_id], data->meta.tx_id, sizeof(data->meta.tx_id)) != 0) {
+    return -1;
+  }
+  data->meta.output_index = (uint16_t)output_index;
+  if (!data->meta.is_spent) {
+    return 0;
+  }
+
+  int spent_idx = json_tok_get(json, toks, meta, "milestoneIndexSpent");
+  int spent_time = json_tok_get(json, toks, meta, "milestoneTimestampSpent");
+  int spent_tx = json_tok_get(json, toks, meta, "transactionIdSpent");
+  if (spent_idx < 0 || spent_time < 0 || spent_tx < 0 ||
+      json_tok_u32(json, &toks[spent_idx], &data->meta.ml_index_spent) != 0 ||
+      json_tok_u32(json, &toks[spent_time], &data->meta.ml_time_spent) != 0 ||
+      json_tok_hex(json, &toks[spent_tx], data->meta.tx_id_spent, sizeof(data->meta.tx_id_spent)) != 0) {
+    return -1;
+  }
+  return 0;
+}
+
+static int parse_address(char const json[], json_tok_t const toks[], int obj, address_t* addr) {
+  uint32_t type = 0;
+  int type_tok = json_tok_get(json, toks, obj, "type");
+  if (type_tok < 0 || toks[obj].size != 2 || json_tok_u32(json, &toks[type_tok], &type) != 0) {
+    return -1;
+  }
+  char const* key = NULL;
+  switch (type) {
+    case ADDRESS_TYPE_ED25519:
+      key = "pubKeyHash";
+      break;
+    case ADDRESS_TYPE_ALIAS:
+      key = "aliasId";
+      break;
+    case ADDRESS_TYPE_NFT:
+      key = "nftId";
+      break;
+    default:
+      return -1;
+  }
+  int hash = json_tok_get(json, toks, obj, key);
+  if (hash < 0 || json_tok_hex(json, &toks[hash], addr->address, ADDRESS_HASH_BYTES) != 0) {
+    return -1;
+  }
+  addr->type = type;
+  return 0;
+}
+
+// true if the member is absent or an empty array
+static bool empty_list(char const json[], json_tok_t const toks[], int obj, char const key[], size_t* members) {
+  int list = json_tok_get(json, toks, obj, key);
+  if (list < 0) {
+    return true;
+  }
+  (*members)++;
+  return toks[list].type == JSON_TOK_ARRAY && toks[list].size == 0;
+}
+
+// reads a basic output with a single address unlock condition, anything else is left to cJSON
+static int parse_basic(char const json[], json_tok_t const toks[], int out, uint64_t* amount, address_t* addr) {
+  uint32_t type = 0;
+  int type_tok = json_tok_get(json, toks, out, "type");
+  int amount_tok = json_tok_get(json, toks, out, "amount");
+  int conds = json_tok_get(json, toks, out, "unlockConditions");
+  if (type_tok < 0 || amount_tok < 0 || conds < 0 || json_tok_u32(json, &toks[type_tok], &type) != 0 ||
+      type != OUTPUT_BASIC || json_tok_u64(json, &toks[amount_tok], amount) != 0) {
+    return -1;
+  }
+  // unknown members would be lost
+  size_t members = 3;
+  if (!empty_list(json, toks, out, "nativeTokens", &members) || !empty_list(json, toks, out, "features", &members) ||
+      toks[out].size != members) {
+    return -1;
+  }
+
+  int cond = json_tok_at(toks, conds, 0);
+  int cond_type = json_tok_get(json, toks, cond, "type");
+  int cond_addr = json_tok_get(json, toks, cond, "address");
+  if (toks[conds].size != 1 || cond_type < 0 || cond_addr < 0 || toks[cond].size != 2 ||
+      json_tok_u32(json, &toks[cond_type], &type) != 0 || type != UNLOCK_COND_ADDRESS) {
+    return -1;
+  }
+  return parse_address(json, toks, cond_addr, addr);
+}
+
+static utxo_output_t* basic_output_new(uint64_t amount, address_t const* addr) {
+  utxo_output_t* output = malloc(sizeof(utxo_output_t));
+  unlock_cond_list_t* conds = condition_list_new();
+  unlock_cond_t* cond = condition_addr_new(addr);
+  output_basic_t* basic = NULL;
+  if (output && cond && condition_list_add(&conds, cond) == 0) {
+    basic = output_basic_new(amount, NULL, conds, NULL);
+  }
+  condition_free(cond);
+  condition_list_free(conds);
+  if (basic == NULL) {
+    free(output);
+    return NULL;
+  }
+  output->output_type = OUTPUT_BASIC;
+  output->output = basic;
+  return output;
+}
+
+int output_tokens_parse(char const json[], size_t len, res_output_t* res) {
+  if (json == NULL || res == NULL) {
+    printf("[%s:%d] invalid parameters\n", __func__, __LINE__);
+    return -1;
+  }
+
+  json_tok_t toks[CONFIG_IOTA_JSON_TOKENIZER_MAX_TOKENS];
+  if (json_tokenize(json, len, toks, CONFIG_IOTA_JSON_TOKENIZER_MAX_TOKENS) <= 0) {
+    // larger documents and invalid ones, cJSON reports the errors
+    return OUTPUT_TOKENS_UNSUPPORTED;
+  }
+  int meta = json_tok_get(json, toks, 0, "metadata");
+  int out = json_tok_get(json, toks, 0, "output");
+  uint64_t amount = 0;
+  address_t addr = {};
+  get_output_t data = {};
+  if (meta < 0 || out < 0 || toks[0].size != 2 || parse_basic(json, toks, out, &amount, &addr) != 0 ||
+      parse_meta(json, toks, meta, &data) != 0) {
+    return OUTPUT_TOKENS_UNSUPPORTED;
+  }
+
+  res->u.data = malloc(sizeof(get_output_t));
+  if (res->u.data == NULL || (data.output = basic_output_new(amount, &addr)) == NULL) {
+    printf("[%s:%d] OOM\n", __func__, __LINE__);
+    free(res->u.data);
+    res->u.data = NULL;
+    return -1;
+  }
+  memcpy(res->u.data, &data, sizeof(get_output_t));
+  res->is_error = false;
+  return 0;
+}
@@ -0,0 +1,36 @@
+// Copyright 2022 IOTA Stiftung
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef __CLIENT_API_JSON_PARSER_OUTPUT_TOKENS_H__
+#define __CLIENT_API_JSON_PARSER_OUTPUT_TOKENS_H__
+
+#include <stddef.h>
+
+#include "client/api/restful/get_output.h"
+
+// the response is valid but not handled by the tokenizer, it has to be parsed with cJSON
+#define OUTPUT_TOKENS_UNSUPPORTED 1
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Parse an output response without building a cJSON tree
+ *
+ * The response is tokenized in place and the output is created from the tokens. Basic outputs whose only unlock
+ * condition is an address, without native tokens and features, are handled. They are what wallets and the ledger sync
+ * fetch by far the most, any other output and error responses are left to parse_get_output().
+ *
+ * @param[in] json The response body
+ * @param[in] len The length of the response body
+ * @param[out] res The output response
+ * @return int 0 on success, OUTPUT_TOKENS_UNSUPPORTED if the response has to be parsed with cJSON, -1 on errors
+ */
+int output_tokens_parse(char const json[], size_t len, res_output_t* res);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,447 @@
+// Copyright 2022 IOTA Stiftung
+// SPDX-License-Identifier: Apache-2.0
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "freertos/task.h"
+#include "sdkconfig.h"
+#include "uthash.h"
+
+#include "client/api/restful/confirm_tracker.h"
+#include "client/api/restful/get_json_stream.h"
+#include "client/api/restful/get_milestone_utxo_changes.h"
+#include "client/api/restful/rest_async.h"
+#include "core/models/block.h"
+
+#define BLOCK_ID_HEX_LEN (2 + IOTA_BLOCK_ID_BYTES * 2)
+// the HTTP timeouts a batch waits for a metadata request before the block is reported as unresolved
+#define CONFIRM_MAX_WAITS 3
+
+typedef struct pending_block {
+  byte_t id[IOTA_BLOCK_ID_BYTES];  ///< the block ID, the key of the table
+  uint32_t checked;                ///< the confirmed milestone index of the last check
+  bool retry;                      ///< the last check failed, check again without a new milestone
+  int64_t deadline;                ///< the time the block expires in microseconds, 0 for none
+  confirm_cb cb;                   ///< the callback of the final state
+  void* ctx;                       ///< the user context of the callback
+  confirm_state_e state;           ///< the final state
+  uint32_t milestone_index;        ///< the milestone that referenced the block
+  struct pending_block* next;      ///< the list of completed blocks
+  UT_hash_handle hh;               ///< the table of pending blocks
+} pending_block_t;
+
+// the result of a block metadata request
+typedef struct {
+  char blk_id[BLOCK_ID_HEX_LEN + 1];  ///< the block ID
+  uint32_t referenced;                ///< the referencing milestone index, 0 if not referenced yet
+  char inclusion[16];                 ///< the ledger inclusion state
+  bool reattach;                      ///< the node asks to reattach the block
+} meta_poll_t;
+
+// a metadata request of a batch, the worker writes into it until the request completed
+typedef struct {
+  meta_poll_t poll;            ///< the argument of the request, the first member
+  int ret;                     ///< the result of the request
+  bool completed;              ///< the request completed, ret is set
+  bool abandoned;              ///< the batch stopped waiting, the completion frees the request
+  SemaphoreHandle_t done;      ///< given on completion unless the request was abandoned
+  StaticSemaphore_t done_buf;  ///< the storage of done
+} poll_req_t;
+
+static struct {
+  iota_client_conf_t conf;        ///< the node the blocks are checked on
+  uint32_t interval_ms;           ///< the time between two checks of the confirmed milestone
+  bool running;                   ///< the task keeps tracking while set
+  TaskHandle_t task;              ///< the tracker task
+  pending_block_t* blocks;        ///< the pending blocks
+  int64_t fed_at;                 ///< the time of the last milestone fed by confirm_tracker_milestone()
+  confirm_tracker_stats_t stats;  ///< the counters
+} tracker = {};
+// guards the tracker, requests and callbacks are made without it
+static SemaphoreHandle_t tracker_lock = NULL;
+// wakes the tracker task early
+static SemaphoreHandle_t tracker_wake = NULL;
+
+char const* confirm_state_str(confirm_state_e state) {
+  switch (state) {
+    case CONFIRM_INCLUDED:
+      return "included";
+    case CONFIRM_NO_TRANSACTION:
+      return "noTransaction";
+    case CONFIRM_CONFLICTING:
+      return "conflicting";
+    case CONFIRM_REATTACH:
+      return "reattach";
+    case CONFIRM_EXPIRED:
+      return "expired";
+    case CONFIRM_CANCELLED:
+      return "cancelled";
+  }
+  return "unknown";
+}
+
+static int on_meta_field(char const* key, char const* value, size_t len, void* ctx) {
+  meta_poll_t* poll = (meta_poll_t*)ctx;
+  if (strcmp(key, "referencedByMilestoneIndex") == 0) {
+    poll->referenced = strtoul(value, NULL, 10);
+  } else if (strcmp(key, "ledgerInclusionState") == 0) {
+    json_stream_str(value, len, poll->inclusion, sizeof(poll->inclusion));
+  } else if (strcmp(key, "shouldReattach") == 0) {
+    poll->reattach = strcmp(value, "true") == 0;
+  }
+  return 0;
+}
+
+// runs on a worker of the asynchronous requests
+static int poll_metadata(iota_client_conf_t const* conf, void* arg) {
+  meta_poll_t* poll = (meta_poll_t*)arg;
+  char path[sizeof("/api/core/v2/blocks//metadata") + BLOCK_ID_HEX_LEN];
+  snprintf(path, sizeof(path), "/api/core/v2/blocks/%s/metadata", poll->blk_id);
+
+  // the parents are not needed, only the fields of the state are kept
+  json_stream_handler_t handler = {.on_field = on_meta_field, .on_element = NULL, .ctx = poll};
+  res_err_t* error = NULL;
+  int ret = get_json_stream(conf, path, &handler, &error);
+  if (error) {
+    // e.g. the node has not seen the block yet
+    res_err_free(error);
+    ret = -1;
+  }
+  return ret;
+}
+
+// removes a pending block with a final state and appends it to the list of completed blocks
+static void complete_block(pending_block_t* blk, confirm_state_e state, uint32_t milestone_index,
+                           pending_block_t** done) {
+  HASH_DEL(tracker.blocks, blk);
+  blk->state = state;
+  blk->milestone_index = milestone_index;
+  blk->next = *done;
+  *done = blk;
+
+  tracker.stats.pending--;
+  if (state == CONFIRM_REATTACH) {
+    tracker.stats.reattach++;
+  } else if (state == CONFIRM_EXPIRED) {
+    tracker.stats.expired++;
+  } else if (state != CONFIRM_CANCELLED) {
+    tracker.stats.confirmed++;
+  }
+}
+
+static void apply_poll(meta_poll_t const* poll, bool ok, pending_block_t** done) {
+  byte_t id[IOTA_BLOCK_ID_BYTES];
+  if (hex_2_bin(poll->blk_id, BLOCK_ID_HEX_LEN, "0x", id, sizeof(id)) != 0) {
+    return;
+  }
+  pending_block_t* blk = NULL;
+  HASH_FIND(hh, tracker.blocks, id, sizeof(id), blk);
+  if (blk == NULL) {
+    return;
+  }
+
+  if (!ok) {
+    blk->retry = true;
+  } else if (poll->referenced) {
+    confirm_state_e state = CONFIRM_INCLUDED;
+    if (strcmp(poll->inclusion, "conflicting") == 0) {
+      state = CONFIRM_CONFLICTING;
+    } else if (strcmp(poll->inclusion, "noTransaction") == 0) {
+      state = CONFIRM_NO_TRANSACTION;
+    }
+    complete_block(blk, state, poll->referenced, done);
+  } else if (poll->reattach) {
+    complete_block(blk, CONFIRM_REATTACH, 0, done);
+  }
+}
+
+static void notify_done(pending_block_t* done) {
+  char blk_id[BLOCK_ID_HEX_LEN + 1];
+  while (done) {
+    pending_block_t* next = done->next;
+    if (done->cb && bin_2_hex(done->id, sizeof(done->id), "0x", blk_id, sizeof(blk_id)) == 0) {
+      done->cb(blk_id, done->state, done->milestone_index, done->ctx);
+    }
+    free(done);
+    done = next;
+  }
+}
+
+// runs on the worker that made the request
+static void poll_complete(int ret, void* arg) {
+  // the argument of the request is the first member
+  poll_req_t* req = (poll_req_t*)arg;
+  xSemaphoreTake(tracker_lock, portMAX_DELAY);
+  req->ret = ret;
+  req->completed = true;
+  bool abandoned = req->abandoned;
+  xSemaphoreGive(tracker_lock);
+  if (abandoned) {
+    free(req);
+  } else {
+    xSemaphoreGive(req->done);
+  }
+}
+
+// waits for a request of a batch and copies its result, false if the request was given up
+static bool poll_wait(poll_req_t* req, rest_async_req_t* handle, meta_poll_t* result, int* ret) {
+  for (int waits = 0; xSemaphoreTake(req->done, pdMS_TO_TICKS(CONFIG_IOTA_HTTP_TIMEOUT_MS)) != pdTRUE;) {
+    if (++waits == 1 && handle) {
+      // it fails at its next network operation
+      rest_async_cancel(handle);
+    }
+    if (waits < CONFIRM_MAX_WAITS) {
+      continue;
+    }
+    xSemaphoreTake(tracker_lock, portMAX_DELAY);
+    bool abandoned = !req->completed;
+    if (abandoned) {
+      memcpy(result->blk_id, req->poll.blk_id, sizeof(result->blk_id));
+      // the worker still owns the request, its completion frees it
+      req->abandoned = true;
+    }
+    xSemaphoreGive(tracker_lock);
+    if (abandoned) {
+      return false;
+    }
+    // completed right now, the semaphore is given next
+  }
+  memcpy(result, &req->poll, sizeof(meta_poll_t));
+  *ret = req->ret;
+  free(req);
+  return true;
+}
+
+// polls the metadata of the blocks that were not checked since the last confirmed milestone, batch by batch
+static void check_pending(iota_client_conf_t const* conf) {
+  poll_req_t* polls[CONFIG_IOTA_CONFIRM_BATCH];
+  rest_async_req_t* reqs[CONFIG_IOTA_CONFIRM_BATCH];
+  meta_poll_t results[CONFIG_IOTA_CONFIRM_BATCH];
+  int rets[CONFIG_IOTA_CONFIRM_BATCH];
+  bool resolved[CONFIG_IOTA_CONFIRM_BATCH];
+
+  for (;;) {
+    size_t n = 0;
+    xSemaphoreTake(tracker_lock, portMAX_DELAY);
+    uint32_t index = tracker.stats.milestone;
+    pending_block_t *blk, *tmp;
+    HASH_ITER(hh, tracker.blocks, blk, tmp) {
+      if (n == CONFIG_IOTA_CONFIRM_BATCH) {
+        break;
+      }
+      if (blk->checked < index && !blk->retry) {
+        poll_req_t* req = calloc(1, sizeof(poll_req_t));
+        if (req == NULL) {
+          break;
+        }
+        bin_2_hex(blk->id, sizeof(blk->id), "0x", req->poll.blk_id, sizeof(req->poll.blk_id));
+        req->done = xSemaphoreCreateBinaryStatic(&req->done_buf);
+        blk->checked = index;
+        polls[n++] = req;
+      }
+    }
+    tracker.stats.polls += n;
+    xSemaphoreGive(tracker_lock);
+    if (n == 0) {
+      return;
+    }
+
+    // the requests of a batch are in flight at once, if the queue is full they are made on this task
+    for (size_t i = 0; i < n; i++) {
+      reqs[i] = rest_async_submit(conf, poll_metadata, &polls[i]->poll, poll_complete, CONFIG_IOTA_HTTP_TIMEOUT_MS);
+      if (reqs[i] == NULL) {
+        poll_complete(poll_metadata(conf, &polls[i]->poll), polls[i]);
+      }
+    }
+    for (size_t i = 0; i < n; i++) {
+      rets[i] = -1;
+      resolved[i] = poll_wait(polls[i], reqs[i], &results[i], &rets[i]);
+      if (reqs[i]) {
+        rest_async_release(reqs[i]);
+      }
+    }
+
+    pending_block_t* done = NULL;
+    xSemaphoreTake(tracker_lock, portMAX_DELAY);
+    for (size_t i = 0; i < n; i++) {
+      if (!resolved[i]) {
+        // checked again with the next milestone or interval
+        printf("[%s:%d] block %s unresolved, no metadata after %d timeouts\n", __func__, __LINE__, results[i].blk_id,
+               CONFIRM_MAX_WAITS);
+        tracker.stats.unresolved++;
+      }
+      apply_poll(&results[i], resolved[i] && rets[i] == 0, &done);
+    }
+    xSemaphoreGive(tracker_lock);
+    notify_done(done);
+  }
+}
+
+static void tracker_task(void* arg) {
+  iota_client_conf_t conf;
+  for (;;) {
+    xSemaphoreTake(tracker_lock, portMAX_DELAY);
+    uint32_t interval_ms = tracker.interval_ms;
+    xSemaphoreGive(tracker_lock);
+    // woken up early by confirm_tracker_milestone() and confirm_tracker_stop()
+    xSemaphoreTake(tracker_wake, pdMS_TO_TICKS(interval_ms));
+
+    pending_block_t* done = NULL;
+    pending_block_t *blk, *tmp;
+    xSemaphoreTake(tracker_lock, portMAX_DELAY);
+    if (!tracker.running) {
+      HASH_ITER(hh, tracker.blocks, blk, tmp) { complete_block(blk, CONFIRM_CANCELLED, 0, &done); }
+      tracker.task = NULL;
+      xSemaphoreGive(tracker_lock);
+      notify_done(done);
+      vTaskDelete(NULL);
+      return;
+    }
+    memcpy(&conf, &tracker.conf, sizeof(conf));
+    // without milestone events, the confirmed milestone comes from the node info
+    bool poll_info = tracker.blocks && esp_timer_get_time() - tracker.fed_at > (int64_t)interval_ms * 2000;
+    HASH_ITER(hh, tracker.blocks, blk, tmp) {
+      if (blk->retry) {
+        blk->retry = false;
+        blk->checked = 0;
+      }
+    }
+    xSemaphoreGive(tracker_lock);
+
+    uint32_t index = 0;
+    if (poll_info && get_confirmed_milestone_index(&conf, &index) == 0) {
+      xSemaphoreTake(tracker_lock, portMAX_DELAY);
+      tracker.stats.info_polls++;
+      if (index > tracker.stats.milestone) {
+        tracker.stats.milestone = index;
+      }
+      xSemaphoreGive(tracker_lock);
+    }
+
+    check_pending(&conf);
+
+    int64_t now = esp_timer_get_time();
+    xSemaphoreTake(tracker_lock, portMAX_DELAY);
+    HASH_ITER(hh, tracker.blocks, blk, tmp) {
+      if (blk->deadline && now >= blk->deadline) {
+        complete_block(blk, CONFIRM_EXPIRED, 0, &done);
+      }
+    }
+    xSemaphoreGive(tracker_lock);
+    notify_done(done);
+  }
+}
+
+int confirm_tracker_start(iota_client_conf_t const* conf, uint32_t interval_ms) {
+  if (conf == NULL || interval_ms == 0) {
+    printf("[%s:%d] invalid parameters\n", __func__, __LINE__);
+    return -1;
+  }
+  if (tracker_wake == NULL && (tracker_wake = xSemaphoreCreateBinary()) == NULL) {
+    printf("[%s:%d] OOM\n", __func__, __LINE__);
+    return -1;
+  }
+  if (tracker_lock == NULL && (tracker_lock = xSemaphoreCreateMutex()) == NULL) {
+    printf("[%s:%d] OOM\n", __func__, __LINE__);
+    return -1;
+  }
+
+  int ret = 0;
+  xSemaphoreTake(tracker_lock, portMAX_DELAY);
+  memcpy(&tracker.conf, conf, sizeof(iota_client_conf_t));
+  tracker.interval_ms = interval_ms;
+  tracker.running = true;
+  if (tracker.task == NULL && xTaskCreate(tracker_task, "confirm_tracker", CONFIG_IOTA_CLIENT_TASK_STACK_SIZE, NULL,
+                                          tskIDLE_PRIORITY + 3, &tracker.task) != pdPASS) {
+    printf("[%s:%d] create tracker task failed\n", __func__, __LINE__);
+    tracker.running = false;
+    tracker.task = NULL;
+    ret = -1;
+  }
+  xSemaphoreGive(tracker_lock);
+  return ret;
+}
+
+void confirm_tracker_stop() {
+  if (tracker_lock == NULL) {
+    return;
+  }
+  xSemaphoreTake(tracker_lock, portMAX_DELAY);
+  tracker.running = false;
+  if (tracker.task) {
+    xSemaphoreGive(tracker_wake);
+  }
+  xSemaphoreGive(tracker_lock);
+}
+
+int confirm_tracker_add(char const blk_id[], uint32_t timeout_s, confirm_cb cb, void* ctx) {
+  if (blk_id == NULL || cb == NULL || tracker_lock == NULL) {
+    printf("[%s:%d] invalid parameters\n", __func__, __LINE__);
+    return -1;
+  }
+
+  pending_block_t* blk = calloc(1, sizeof(pending_block_t));
+  if (blk == NULL) {
+    printf("[%s:%d] OOM\n", __func__, __LINE__);
+    return -1;
+  }
+  if (strlen(blk_id) != BLOCK_ID_HEX_LEN || hex_2_bin(blk_id, BLOCK_ID_HEX_LEN, "0x", blk->id, sizeof(blk->id)) != 0) {
+    printf("[%s:%d] invalid block ID\n", __func__, __LINE__);
+    free(blk);
+    return -1;
+  }
+  blk->deadline = timeout_s ? esp_timer_get_time() + (int64_t)timeout_s * 1000000 : 0;
+  blk->cb = cb;
+  blk->ctx = ctx;
+
+  int ret = -1;
+  pending_block_t* found = NULL;
+  xSemaphoreTake(tracker_lock, portMAX_DELAY);
+  HASH_FIND(hh, tracker.blocks, blk->id, sizeof(blk->id), found);
+  if (tracker.running && found == NULL) {
+    // a block sent now can only be referenced by a later milestone
+    blk->checked = tracker.stats.milestone;
+    HASH_ADD(hh, tracker.blocks, id, sizeof(blk->id), blk);
+    tracker.stats.pending++;
+    ret = 0;
+  }
+  xSemaphoreGive(tracker_lock);
+  if (ret != 0) {
+    printf("[%s:%d] %s\n", __func__, __LINE__, found ? "block is already tracked" : "tracker is not running");
+    free(blk);
+  }
+  return ret;
+}
+
+void confirm_tracker_milestone(uint32_t index) {
+  if (tracker_lock == NULL) {
+    return;
+  }
+  xSemaphoreTake(tracker_lock, portMAX_DELAY);
+  tracker.fed_at = esp_timer_get_time();
+  if (index > tracker.stats.milestone) {
+    tracker.stats.milestone = index;
+    if (tracker.running && tracker.task && tracker.blocks) {
+      xSemaphoreGive(tracker_wake);
+    }
+  }
+  xSemaphoreGive(tracker_lock);
+}
+
+void confirm_tracker_get_stats(confirm_tracker_stats_t* stats) {
+  if (stats == NULL) {
+    return;
+  }
+  memset(stats, 0, sizeof(confirm_tracker_stats_t));
+  if (tracker_lock == NULL) {
+    return;
+  }
+  xSemaphoreTake(tracker_lock, portMAX_DELAY);
+  *stats = tracker.stats;
+  xSemaphoreGive(tracker_lock);
+}
@@ -0,0 +1,114 @@
+// Copyright 2022 IOTA Stiftung
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef __CLIENT_API_RESTFUL_CONFIRM_TRACKER_H__
+#define __CLIENT_API_RESTFUL_CONFIRM_TRACKER_H__
+
+#include <stdint.h>
+
+#include "client/client_service.h"
+
+/**
+ * @brief The final state of a tracked block
+ *
+ */
+typedef enum {
+  CONFIRM_INCLUDED = 0,    ///< referenced by a milestone, its transaction was applied to the ledger
+  CONFIRM_NO_TRANSACTION,  ///< referenced by a milestone, it has no transaction
+  CONFIRM_CONFLICTING,     ///< referenced by a milestone, its transaction conflicts with the ledger
+  CONFIRM_REATTACH,        ///< the node will not reference it anymore, it has to be reattached
+  CONFIRM_EXPIRED,         ///< not final before the timeout of the block
+  CONFIRM_CANCELLED,       ///< removed by confirm_tracker_stop()
+} confirm_state_e;
+
+/**
+ * @brief Receives the final state of a tracked block
+ *
+ * It is called on the tracker task once per block, the block is no longer tracked.
+ *
+ * @param[in] blk_id The 0x prefixed hex string of the block ID
+ * @param[in] state The final state
+ * @param[in] milestone_index The index of the milestone that referenced the block, 0 if it was not referenced
+ * @param[in] ctx The user context
+ */
+typedef void (*confirm_cb)(char const blk_id[], confirm_state_e state, uint32_t milestone_index, void* ctx);
+
+/**
+ * @brief Counters of the confirmation tracker
+ *
+ */
+typedef struct {
+  uint32_t pending;     ///< blocks waiting for a final state
+  uint32_t confirmed;   ///< blocks referenced by a milestone
+  uint32_t reattach;    ///< blocks that have to be reattached
+  uint32_t expired;     ///< blocks that timed out
+  uint32_t polls;       ///< block metadata requests
+  uint32_t unresolved;  ///< block metadata requests given up after repeated timeouts, the blocks stay pending
+  uint32_t info_polls;  ///< node info requests for the confirmed milestone
+  uint32_t milestone;   ///< the last confirmed milestone index
+} confirm_tracker_stats_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Start the tracker task
+ *
+ * A block can only become final when a milestone is confirmed, so the metadata of the pending blocks is polled once
+ * per new confirmed milestone instead of once per interval. Blocks are checked with up to CONFIG_IOTA_CONFIRM_BATCH
+ * requests in flight on the asynchronous request workers. The confirmed milestone is taken from the node info every
+ * interval unless it is fed by confirm_tracker_milestone().
+ *
+ * @param[in] conf The client endpoint configuration, it is copied
+ * @param[in] interval_ms The time between two checks of the confirmed milestone
+ * @return int 0 on success
+ */
+int confirm_tracker_start(iota_client_conf_t const* conf, uint32_t interval_ms);
+
+/**
+ * @brief Stop the tracker task, pending blocks complete with CONFIRM_CANCELLED
+ *
+ */
+void confirm_tracker_stop();
+
+/**
+ * @brief Track a block until its state is final
+ *
+ * @param[in] blk_id The 0x prefixed hex string of the block ID
+ * @param[in] timeout_s The time after which the block completes with CONFIRM_EXPIRED, 0 for none
+ * @param[in] cb The callback of the final state
+ * @param[in] ctx The user context of the callback
+ * @return int 0 on success, -1 if the block is already tracked, the tracker is not running or on errors
+ */
+int confirm_tracker_add(char const blk_id[], uint32_t timeout_s, confirm_cb cb, void* ctx);
+
+/**
+ * @brief Feed a confirmed milestone, e.g. from the milestones/confirmed event topic
+ *
+ * The pending blocks are checked right away and the node info is not polled.
+ *
+ * @param[in] index The index of the confirmed milestone
+ */
+void confirm_tracker_milestone(uint32_t index);
+
+/**
+ * @brief Get a snapshot of the tracker counters
+ *
+ * @param[out] stats The counters
+ */
+void confirm_tracker_get_stats(confirm_tracker_stats_t* stats);
+
+/**
+ * @brief Get the name of a state
+ *
+ * @param[in] state The state
+ * @return char const* The name
+ */
+char const* confirm_state_str(confirm_state_e state);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,83 @@
+// Copyright 2022 IOTA Stiftung
+// SPDX-License-Identifier: Apache-2.0
+
+#include <stdio.h>
+#include <string.h>
+
+#include "cJSON.h"
+#include "esp_timer.h"
+
+#include "client/api/restful/get_block_binary.h"
+#include "client/network/http_request.h"
+#include "client/network/http_stats.h"
+#include "core/models/block_binary.h"
+
+#define BLOCKS_PATH "/api/core/v2/blocks/"
+// 0x prefixed hex string of a block ID
+#define BLOCK_ID_HEX_LEN (2 + IOTA_BLOCK_ID_BYTES * 2)
+
+int get_block_by_id_binary(iota_client_conf_t const* conf, char const blk_id[], res_block_t* res) {
+  if (conf == NULL || blk_id == NULL || res == NULL) {
+    printf("[%s:%d] invalid parameters\n", __func__, __LINE__);
+    return -1;
+  }
+
+  if (strlen(blk_id) != BLOCK_ID_HEX_LEN) {
+    printf("[%s:%d] incorrect length of the block ID\n", __func__, __LINE__);
+    return -1;
+  }
+
+  char path[sizeof(BLOCKS_PATH) + BLOCK_ID_HEX_LEN] = {};
+  snprintf(path, sizeof(path), "%s%s", BLOCKS_PATH, blk_id);
+
+  byte_buf_t* http_res = byte_buf_new();
+  if (http_res == NULL) {
+    printf("[%s:%d] OOM\n", __func__, __LINE__);
+    return -1;
+  }
+
+  http_client_config_t http_conf = {.host = conf->host, .path = path, .use_tls = conf->use_tls, .port = conf->port};
+  http_request_opts_t opts = {.accept = IOTA_BINARY_MEDIA_TYPE};
+  long st = 0;
+  int ret = http_client_get_ex(&http_conf, &opts, http_res, &st);
+  if (ret != 0) {
+    goto end;
+  }
+
+  // error responses and nodes without binary support respond with JSON
+  if (st < 200 || st >= 300 || (http_res->len > 0 && http_res->data[0] == '{')) {
+    if (!byte_buf2str(http_res)) {
+      ret = -1;
+      goto end;
+    }
+    if (st >= 200 && st < 300) {
+      ret = deser_get_block((char const*)http_res->data, res);
+      goto end;
+    }
+    cJSON* json_obj = http_stats_parse_json((char const*)http_res->data);
+    if (json_obj) {
+      res->u.error = deser_error(json_obj);
+      cJSON_Delete(json_obj);
+    }
+    if (res->u.error) {
+      res->is_error = true;
+    } else {
+      printf("[%s:%d] HTTP status %ld\n", __func__, __LINE__, st);
+      ret = -1;
+    }
+    goto end;
+  }
+
+  int64_t start = esp_timer_get_time();
+  ret = core_block_from_binary(http_res->data, http_res->len, &res->u.blk);
+  http_stats_record_parse(esp_timer_get_time() - start);
+  if (ret == 1) {
+    // e.g. milestone payloads, fall back to the JSON API
+    byte_buf_free(http_res);
+    return get_block_by_id(conf, blk_id, res);
+  }
+
+end:
+  byte_buf_free(http_res);
+  return ret;
+}
@@ -0,0 +1,31 @@
+// Copyright 2022 IOTA Stiftung
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef __CLIENT_API_RESTFUL_GET_BLOCK_BINARY_H__
+#define __CLIENT_API_RESTFUL_GET_BLOCK_BINARY_H__
+
+#include "client/api/restful/get_block.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Get a block from a given block ID in its binary form
+ *
+ * Same as get_block_by_id() but the node responds with the binary serialized block, which is about a third of the
+ * JSON size and needs no hex decoding. Blocks with a payload the binary deserializer does not support are requested
+ * again as JSON.
+ *
+ * @param[in] conf The client endpoint configuration
+ * @param[in] blk_id A block ID in hex string format
+ * @param[out] res A block object
+ * @return int 0 on success
+ */
+int get_block_by_id_binary(iota_client_conf_t const* conf, char const blk_id[], res_block_t* res);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
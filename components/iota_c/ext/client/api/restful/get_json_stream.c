@@ -0,0 +1,65 @@
+// Copyright 2022 IOTA Stiftung
+// SPDX-License-Identifier: Apache-2.0
+
+#include <stdio.h>
+
+#include "cJSON.h"
+#include "sdkconfig.h"
+
+#include "client/api/restful/get_json_stream.h"
+#include "client/network/http_request.h"
+#include "client/network/http_stats.h"
+
+static int feed_stream(byte_t const* data, size_t len, void* ctx) {
+  return json_stream_feed((json_stream_t*)ctx, (char const*)data, len);
+}
+
+int get_json_stream(iota_client_conf_t const* conf, char const path[], json_stream_handler_t const* handler,
+                    res_err_t** error) {
+  if (conf == NULL || path == NULL || handler == NULL || error == NULL) {
+    printf("[%s:%d] invalid parameters\n", __func__, __LINE__);
+    return -1;
+  }
+  *error = NULL;
+
+  int ret = -1;
+  json_stream_t* js = json_stream_new(CONFIG_IOTA_JSON_STREAM_VALUE_MAX, handler);
+  byte_buf_t* http_res = byte_buf_new();
+  if (js == NULL || http_res == NULL) {
+    printf("[%s:%d] OOM\n", __func__, __LINE__);
+    goto end;
+  }
+
+  // http client configuration
+  http_client_config_t http_conf = {.host = conf->host, .path = path, .use_tls = conf->use_tls, .port = conf->port};
+  http_request_opts_t opts = {.on_body = feed_stream, .ctx = js};
+  long st = 0;
+  if ((ret = http_client_get_ex(&http_conf, &opts, http_res, &st)) != 0) {
+    goto end;
+  }
+
+  if (st >= 200 && st < 300) {
+    if ((ret = json_stream_finish(js)) != 0) {
+      printf("[%s:%d] incomplete JSON response\n", __func__, __LINE__);
+    }
+    goto end;
+  }
+
+  // the error response is small and buffered
+  if (http_res->len > 0 && byte_buf2str(http_res)) {
+    cJSON* json_obj = http_stats_parse_json((char const*)http_res->data);
+    if (json_obj) {
+      *error = deser_error(json_obj);
+      cJSON_Delete(json_obj);
+    }
+  }
+  if (*error == NULL) {
+    printf("[%s:%d] HTTP status %ld\n", __func__, __LINE__, st);
+    ret = -1;
+  }
+
+end:
+  json_stream_free(js);
+  byte_buf_free(http_res);
+  return ret;
+}
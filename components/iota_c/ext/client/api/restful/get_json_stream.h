@@ -0,0 +1,33 @@
+// Copyright 2022 IOTA Stiftung
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef __CLIENT_API_RESTFUL_GET_JSON_STREAM_H__
+#define __CLIENT_API_RESTFUL_GET_JSON_STREAM_H__
+
+#include "client/api/json_parser/json_stream.h"
+#include "client/api/restful/response_error.h"
+#include "client/client_service.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Perform a GET request and parse the JSON response while it is received
+ *
+ * The body is never buffered as a whole, the handler gets the top-level members and array elements one by one.
+ *
+ * @param[in] conf The client endpoint configuration
+ * @param[in] path The API path including the query string
+ * @param[in] handler The JSON stream callbacks
+ * @param[out] error The error object if the node responded with an error, must be freed by res_err_free()
+ * @return int 0 on success
+ */
+int get_json_stream(iota_client_conf_t const* conf, char const path[], json_stream_handler_t const* handler,
+                    res_err_t** error);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,81 @@
+// Copyright 2022 IOTA Stiftung
+// SPDX-License-Identifier: Apache-2.0
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "cJSON.h"
+
+#include "client/api/restful/get_json_stream.h"
+#include "client/api/restful/get_milestone_utxo_changes.h"
+#include "client/api/restful/get_outputs_id_stream.h"
+#include "client/network/http_request.h"
+#include "client/network/http_stats.h"
+
+#define NODE_INFO_PATH "/api/core/v2/info"
+#define MILESTONE_UTXO_CHANGES_PATH "/api/core/v2/milestones/by-index/%" PRIu32 "/utxo-changes"
+
+typedef struct {
+  utxo_changes_cb cb;
+  void* ctx;
+} utxo_changes_ctx_t;
+
+static int on_changes_element(char const* key, char const* value, size_t len, void* ctx) {
+  utxo_changes_ctx_t* changes = (utxo_changes_ctx_t*)ctx;
+  bool created = strcmp(key, "createdOutputs") == 0;
+  if (!created && strcmp(key, "consumedOutputs") != 0) {
+    return 0;
+  }
+
+  char output_id[OUTPUTS_ID_HEX_LEN + 1];
+  if (json_stream_str(value, len, output_id, sizeof(output_id)) != 0) {
+    printf("[%s:%d] invalid output ID\n", __func__, __LINE__);
+    return -1;
+  }
+  return changes->cb ? changes->cb(output_id, created, changes->ctx) : 0;
+}
+
+int get_milestone_utxo_changes_stream(iota_client_conf_t const* conf, uint32_t index, utxo_changes_cb cb, void* ctx,
+                                      res_err_t** error) {
+  if (conf == NULL || error == NULL) {
+    printf("[%s:%d] invalid parameters\n", __func__, __LINE__);
+    return -1;
+  }
+
+  char path[sizeof(MILESTONE_UTXO_CHANGES_PATH) + 10];
+  snprintf(path, sizeof(path), MILESTONE_UTXO_CHANGES_PATH, index);
+  utxo_changes_ctx_t changes = {.cb = cb, .ctx = ctx};
+  json_stream_handler_t handler = {.on_element = on_changes_element, .ctx = &changes};
+  return get_json_stream(conf, path, &handler, error);
+}
+
+int get_confirmed_milestone_index(iota_client_conf_t const* conf, uint32_t* index) {
+  if (conf == NULL || index == NULL) {
+    printf("[%s:%d] invalid parameters\n", __func__, __LINE__);
+    return -1;
+  }
+  byte_buf_t* http_res = byte_buf_new();
+  if (http_res == NULL) {
+    printf("[%s:%d] OOM\n", __func__, __LINE__);
+    return -1;
+  }
+
+  int ret = -1;
+  http_client_config_t http_conf = {
+      .host = conf->host, .path = NODE_INFO_PATH, .use_tls = conf->use_tls, .port = conf->port};
+  long st = 0;
+  if (http_client_get(&http_conf, http_res, &st) == 0 && st == 200 && byte_buf2str(http_res)) {
+    cJSON* json_obj = http_stats_parse_json((char const*)http_res->data);
+    cJSON* status = cJSON_GetObjectItemCaseSensitive(json_obj, "status");
+    cJSON* milestone = cJSON_GetObjectItemCaseSensitive(status, "confirmedMilestone");
+    cJSON* idx = cJSON_GetObjectItemCaseSensitive(milestone, "index");
+    if (cJSON_IsNumber(idx)) {
+      *index = (uint32_t)idx->valuedouble;
+      ret = 0;
+    }
+    cJSON_Delete(json_obj);
+  }
+  byte_buf_free(http_res);
+  return ret;
+}
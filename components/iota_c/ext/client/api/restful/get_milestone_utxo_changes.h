@@ -0,0 +1,55 @@
+// Copyright 2022 IOTA Stiftung
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef __CLIENT_API_RESTFUL_GET_MILESTONE_UTXO_CHANGES_H__
+#define __CLIENT_API_RESTFUL_GET_MILESTONE_UTXO_CHANGES_H__
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "client/api/restful/response_error.h"
+#include "client/client_service.h"
+
+/**
+ * @brief Receives an output ID of the UTXO changes of a milestone
+ *
+ * @param[in] output_id The 0x prefixed hex string of the output ID
+ * @param[in] created true for outputs created by the milestone, false for consumed ones
+ * @param[in] ctx The user context
+ * @return int 0 on success, non-zero aborts the request
+ */
+typedef int (*utxo_changes_cb)(char const output_id[], bool created, void* ctx);
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Get the output IDs created and consumed by a milestone without buffering the response
+ *
+ * @param[in] conf The client endpoint configuration
+ * @param[in] index The milestone index
+ * @param[in] cb The output ID callback
+ * @param[in] ctx The user context of the callback
+ * @param[out] error The error object if the node responded with an error, must be freed by res_err_free()
+ * @return int 0 on success
+ */
+int get_milestone_utxo_changes_stream(iota_client_conf_t const* conf, uint32_t index, utxo_changes_cb cb, void* ctx,
+                                      res_err_t** error);
+
+/**
+ * @brief Get the index of the latest confirmed milestone from the node info
+ *
+ * Only the index is parsed, the other members of the node info are skipped.
+ *
+ * @param[in] conf The client endpoint configuration
+ * @param[out] index The confirmed milestone index
+ * @return int 0 on success
+ */
+int get_confirmed_milestone_index(iota_client_conf_t const* conf, uint32_t* index);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
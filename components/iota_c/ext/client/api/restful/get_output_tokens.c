@@ -0,0 +1,65 @@
+// Copyright 2022 IOTA Stiftung
+// SPDX-License-Identifier: Apache-2.0
+
+#include <stdio.h>
+#include <string.h>
+
+#include "esp_timer.h"
+
+#include "client/api/json_parser/output_tokens.h"
+#include "client/api/restful/get_outputs_id_stream.h"
+#include "client/network/http_request.h"
+#include "client/network/http_stats.h"
+
+#define OUTPUTS_PATH "/api/core/v2/outputs/"
+
+// get_output() and parse_get_output() are wrapped at link time, see CMakeLists.txt
+int __real_parse_get_output(char const* const j_str, res_output_t* res);
+
+int __wrap_parse_get_output(char const* const j_str, res_output_t* res) {
+  if (j_str == NULL || res == NULL) {
+    return __real_parse_get_output(j_str, res);
+  }
+  int64_t start = esp_timer_get_time();
+  int ret = output_tokens_parse(j_str, strlen(j_str), res);
+  if (ret == OUTPUT_TOKENS_UNSUPPORTED) {
+    return __real_parse_get_output(j_str, res);
+  }
+  http_stats_record_parse(esp_timer_get_time() - start);
+  return ret;
+}
+
+// the same request as get_output(), the response is parsed by the wrapper above
+int __wrap_get_output(iota_client_conf_t const* conf, char const output_id[], res_output_t* res) {
+  if (conf == NULL || output_id == NULL || res == NULL) {
+    printf("[%s:%d] invalid parameters\n", __func__, __LINE__);
+    return -1;
+  }
+  // the output ID with or without its 0x prefix
+  char const* prefix = strncmp(output_id, "0x", 2) == 0 ? "" : "0x";
+  if (strlen(prefix) + strlen(output_id) != OUTPUTS_ID_HEX_LEN) {
+    printf("[%s:%d] incorrect length of the output ID\n", __func__, __LINE__);
+    return -1;
+  }
+
+  char path[sizeof(OUTPUTS_PATH) + OUTPUTS_ID_HEX_LEN] = {};
+  snprintf(path, sizeof(path), "%s%s%s", OUTPUTS_PATH, prefix, output_id);
+  byte_buf_t* http_res = byte_buf_new();
+  if (http_res == NULL) {
+    printf("[%s:%d] OOM\n", __func__, __LINE__);
+    return -1;
+  }
+
+  http_client_config_t http_conf = {.host = conf->host, .path = path, .use_tls = conf->use_tls, .port = conf->port};
+  long st = 0;
+  int ret = http_client_get(&http_conf, http_res, &st);
+  if (ret == 0) {
+    if (byte_buf2str(http_res)) {
+      ret = __wrap_parse_get_output((char const*)http_res->data, res);
+    } else {
+      ret = -1;
+    }
+  }
+  byte_buf_free(http_res);
+  return ret;
+}
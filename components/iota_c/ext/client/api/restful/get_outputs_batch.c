@@ -0,0 +1,135 @@
+// Copyright 2022 IOTA Stiftung
+// SPDX-License-Identifier: Apache-2.0
+
+#include <stdio.h>
+#include <string.h>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "freertos/task.h"
+#include "sdkconfig.h"
+
+#include "client/api/restful/get_outputs_batch.h"
+#if CONFIG_IOTA_RESPONSE_ARENA
+#include "client/api/restful/response_arena.h"
+#endif
+
+typedef struct {
+  iota_client_conf_t const* conf;  ///< the node endpoint
+  char const* const* output_ids;   ///< the output IDs of the batch
+  output_batch_item_t* results;    ///< the result of each output ID
+  size_t count;                    ///< the number of output IDs
+  size_t next;                     ///< the next output ID to fetch
+  SemaphoreHandle_t lock;          ///< protects next
+  SemaphoreHandle_t done;          ///< given by each worker task when it is finished
+} outputs_batch_t;
+
+static void batch_run(outputs_batch_t* batch) {
+  for (;;) {
+    xSemaphoreTake(batch->lock, portMAX_DELAY);
+    size_t idx = batch->next++;
+    xSemaphoreGive(batch->lock);
+    if (idx >= batch->count) {
+      return;
+    }
+
+    output_batch_item_t* item = &batch->results[idx];
+#if CONFIG_IOTA_RESPONSE_ARENA
+    item->ret = get_output_arena(batch->conf, batch->output_ids[idx], &item->res);
+#else
+    item->res = get_output_response_new();
+    if (item->res == NULL) {
+      printf("[%s:%d] OOM\n", __func__, __LINE__);
+      item->ret = -1;
+      continue;
+    }
+    item->ret = get_output(batch->conf, batch->output_ids[idx], item->res);
+#endif
+  }
+}
+
+static void batch_worker(void* arg) {
+  outputs_batch_t* batch = (outputs_batch_t*)arg;
+  batch_run(batch);
+  xSemaphoreGive(batch->done);
+  vTaskDelete(NULL);
+}
+
+int get_outputs_batch(iota_client_conf_t const* conf, char const* const output_ids[], size_t count,
+                      uint8_t concurrency, output_batch_item_t results[]) {
+  if (conf == NULL || output_ids == NULL || results == NULL) {
+    printf("[%s:%d] invalid parameters\n", __func__, __LINE__);
+    return -1;
+  }
+  memset(results, 0, count * sizeof(output_batch_item_t));
+  if (count == 0) {
+    return 0;
+  }
+
+  if (concurrency == 0) {
+    concurrency = CONFIG_IOTA_OUTPUTS_BATCH_CONCURRENCY;
+  }
+  // more requests than pooled connections would only wait for a free connection
+#if CONFIG_IOTA_HTTP2
+  // unless they are streams of a HTTP/2 connection
+  size_t max_concurrency = CONFIG_IOTA_HTTP2_MAX_STREAMS > CONFIG_IOTA_HTTP_POOL_MAX_CONNS
+                               ? CONFIG_IOTA_HTTP2_MAX_STREAMS
+                               : CONFIG_IOTA_HTTP_POOL_MAX_CONNS;
+#else
+  size_t max_concurrency = CONFIG_IOTA_HTTP_POOL_MAX_CONNS;
+#endif
+  if (concurrency > max_concurrency) {
+    concurrency = max_concurrency;
+  }
+  if (concurrency > count) {
+    concurrency = count;
+  }
+
+  outputs_batch_t batch = {.conf = conf, .output_ids = output_ids, .results = results, .count = count};
+  batch.lock = xSemaphoreCreateMutex();
+  batch.done = xSemaphoreCreateCounting(concurrency, 0);
+  if (batch.lock == NULL || batch.done == NULL) {
+    printf("[%s:%d] OOM\n", __func__, __LINE__);
+    if (batch.lock) {
+      vSemaphoreDelete(batch.lock);
+    }
+    if (batch.done) {
+      vSemaphoreDelete(batch.done);
+    }
+    return -1;
+  }
+
+  // the calling task is one of the workers, the batch continues with fewer workers if a task cannot be created
+  size_t workers = 0;
+  for (size_t i = 1; i < concurrency; i++) {
+    if (xTaskCreate(batch_worker, "outputs_batch", CONFIG_IOTA_CLIENT_TASK_STACK_SIZE, &batch,
+                    uxTaskPriorityGet(NULL), NULL) != pdPASS) {
+      printf("[%s:%d] create worker task failed\n", __func__, __LINE__);
+      break;
+    }
+    workers++;
+  }
+  batch_run(&batch);
+
+  while (workers--) {
+    xSemaphoreTake(batch.done, portMAX_DELAY);
+  }
+  vSemaphoreDelete(batch.lock);
+  vSemaphoreDelete(batch.done);
+  return 0;
+}
+
+void get_outputs_batch_free(output_batch_item_t results[], size_t count) {
+  if (results) {
+    for (size_t i = 0; i < count; i++) {
+      if (results[i].res) {
+#if CONFIG_IOTA_RESPONSE_ARENA
+        get_output_response_arena_free(results[i].res);
+#else
+        get_output_response_free(results[i].res);
+#endif
+        results[i].res = NULL;
+      }
+    }
+  }
+}
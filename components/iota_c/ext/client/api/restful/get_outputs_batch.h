@@ -0,0 +1,54 @@
+// Copyright 2022 IOTA Stiftung
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef __CLIENT_API_RESTFUL_GET_OUTPUTS_BATCH_H__
+#define __CLIENT_API_RESTFUL_GET_OUTPUTS_BATCH_H__
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "client/api/restful/get_output.h"
+
+/**
+ * @brief The result of a single output ID in a batch
+ *
+ */
+typedef struct {
+  int ret;            ///< the return value of get_output() for this output ID
+  res_output_t* res;  ///< the output or the error response of the node, NULL if it was not fetched
+} output_batch_item_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Get the output objects of a list of output IDs
+ *
+ * The outputs are fetched by up to concurrency requests in flight, the calling task runs one of them and the others run
+ * in worker tasks. The concurrency is capped by the size of the HTTP connection pool, or by the concurrent streams of
+ * HTTP/2 if they are more.
+ *
+ * @param[in] conf The client endpoint configuration
+ * @param[in] output_ids The output IDs in hex string format
+ * @param[in] count The number of output IDs
+ * @param[in] concurrency The maximum number of requests in flight, 0 for CONFIG_IOTA_OUTPUTS_BATCH_CONCURRENCY
+ * @param[out] results count items, in the order of output_ids, free them with get_outputs_batch_free()
+ * @return int 0 if all output IDs were processed, the result of each one is in its item
+ */
+int get_outputs_batch(iota_client_conf_t const* conf, char const* const output_ids[], size_t count,
+                      uint8_t concurrency, output_batch_item_t results[]);
+
+/**
+ * @brief Free the responses of a batch
+ *
+ * @param[in] results The items of a batch
+ * @param[in] count The number of items
+ */
+void get_outputs_batch_free(output_batch_item_t results[], size_t count);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
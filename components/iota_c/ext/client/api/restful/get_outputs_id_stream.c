@@ -0,0 +1,70 @@
+// Copyright 2022 IOTA Stiftung
+// SPDX-License-Identifier: Apache-2.0
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "client/api/restful/get_json_stream.h"
+#include "client/api/restful/get_outputs_id_stream.h"
+
+#define INDEXER_BASIC_OUTPUTS_PATH "/api/indexer/v1/outputs/basic"
+
+typedef struct {
+  outputs_id_cb cb;
+  void* ctx;
+  outputs_id_page_t* page;
+} outputs_stream_ctx_t;
+
+static int on_outputs_field(char const* key, char const* value, size_t len, void* ctx) {
+  outputs_id_page_t* page = ((outputs_stream_ctx_t*)ctx)->page;
+  if (strcmp(key, "ledgerIndex") == 0) {
+    page->ledger_idx = strtoul(value, NULL, 10);
+  } else if (strcmp(key, "pageSize") == 0) {
+    page->page_size = strtoul(value, NULL, 10);
+  } else if (strcmp(key, "cursor") == 0) {
+    // the cursor is null on the last page
+    if (json_stream_str(value, len, page->cursor, sizeof(page->cursor)) != 0) {
+      page->cursor[0] = '\0';
+    }
+  }
+  return 0;
+}
+
+static int on_outputs_element(char const* key, char const* value, size_t len, void* ctx) {
+  outputs_stream_ctx_t* stream_ctx = (outputs_stream_ctx_t*)ctx;
+  if (strcmp(key, "items") != 0) {
+    return 0;
+  }
+
+  char output_id[OUTPUTS_ID_HEX_LEN + 1];
+  if (json_stream_str(value, len, output_id, sizeof(output_id)) != 0) {
+    printf("[%s:%d] invalid output ID\n", __func__, __LINE__);
+    return -1;
+  }
+  stream_ctx->page->count++;
+  return stream_ctx->cb ? stream_ctx->cb(output_id, stream_ctx->ctx) : 0;
+}
+
+int get_basic_outputs_id_stream(iota_client_conf_t const* conf, char const query[], outputs_id_cb cb, void* ctx,
+                                outputs_id_page_t* page, res_err_t** error) {
+  if (conf == NULL || query == NULL || page == NULL || error == NULL) {
+    printf("[%s:%d] invalid parameters\n", __func__, __LINE__);
+    return -1;
+  }
+  memset(page, 0, sizeof(outputs_id_page_t));
+
+  size_t path_len = strlen(INDEXER_BASIC_OUTPUTS_PATH) + strlen(query) + 2;
+  char* path = malloc(path_len);
+  if (path == NULL) {
+    printf("[%s:%d] OOM\n", __func__, __LINE__);
+    return -1;
+  }
+  snprintf(path, path_len, "%s?%s", INDEXER_BASIC_OUTPUTS_PATH, query);
+
+  outputs_stream_ctx_t stream_ctx = {.cb = cb, .ctx = ctx, .page = page};
+  json_stream_handler_t handler = {.on_field = on_outputs_field, .on_element = on_outputs_element, .ctx = &stream_ctx};
+  int ret = get_json_stream(conf, path, &handler, error);
+  free(path);
+  return ret;
+}
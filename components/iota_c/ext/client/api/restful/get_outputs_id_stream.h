@@ -0,0 +1,63 @@
+// Copyright 2022 IOTA Stiftung
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef __CLIENT_API_RESTFUL_GET_OUTPUTS_ID_STREAM_H__
+#define __CLIENT_API_RESTFUL_GET_OUTPUTS_ID_STREAM_H__
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "client/api/restful/response_error.h"
+#include "client/client_service.h"
+
+// 0x prefixed hex string of a 34 bytes output ID
+#define OUTPUTS_ID_HEX_LEN 70
+// the maximum length of an indexer cursor
+#define OUTPUTS_CURSOR_MAX_LEN 128
+
+/**
+ * @brief Receives an output ID from the indexer response
+ *
+ * @param[in] output_id The 0x prefixed hex string of the output ID
+ * @param[in] ctx The user context
+ * @return int 0 on success, non-zero aborts the request
+ */
+typedef int (*outputs_id_cb)(char const output_id[], void* ctx);
+
+/**
+ * @brief The members of an indexer response other than the output IDs
+ *
+ */
+typedef struct {
+  uint32_t ledger_idx;                      ///< the ledger index at which the output IDs were collected
+  uint32_t page_size;                       ///< the maximum number of output IDs in a page
+  char cursor[OUTPUTS_CURSOR_MAX_LEN + 1];  ///< the cursor of the next page, empty on the last page
+  size_t count;                             ///< the number of output IDs received
+} outputs_id_page_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Get basic output IDs from the indexer without buffering the response
+ *
+ * Output IDs are passed to the callback while the response is received, the memory used does not depend on the
+ * number of outputs.
+ *
+ * @param[in] conf The client endpoint configuration
+ * @param[in] query The query string without the leading question mark, e.g. "address=iota1..."
+ * @param[in] cb The output ID callback
+ * @param[in] ctx The user context of the callback
+ * @param[out] page The other members of the response
+ * @param[out] error The error object if the node responded with an error, must be freed by res_err_free()
+ * @return int 0 on success
+ */
+int get_basic_outputs_id_stream(iota_client_conf_t const* conf, char const query[], outputs_id_cb cb, void* ctx,
+                                outputs_id_page_t* page, res_err_t** error);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,284 @@
+// Copyright 2022 IOTA Stiftung
+// SPDX-License-Identifier: Apache-2.0
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "uthash.h"
+
+#include "client/api/restful/get_milestone_utxo_changes.h"
+#include "client/api/restful/get_outputs_batch.h"
+#include "client/api/restful/get_outputs_id_stream.h"
+#include "client/api/restful/ledger_sync.h"
+#include "core/models/outputs/outputs.h"
+#include "core/utils/byte_buffer.h"
+
+// the binary length of an output ID
+#define OUTPUT_ID_BYTES 34
+// created outputs fetched by one get_outputs_batch() call
+#define LEDGER_SYNC_BATCH 16
+
+typedef struct {
+  byte_t id[OUTPUT_ID_BYTES];  ///< the output ID, the key of the table
+  uint64_t amount;             ///< the amount of the output
+  UT_hash_handle hh;           ///< the table of watched outputs
+} watched_output_t;
+
+struct ledger_sync {
+  iota_client_conf_t conf;                     ///< the node the changes are fetched from
+  uint32_t index;                              ///< the last applied milestone index
+  address_t addrs[LEDGER_SYNC_MAX_ADDRESSES];  ///< the watched addresses
+  size_t addrs_len;                            ///< the number of watched addresses
+  watched_output_t* outputs;                   ///< the watched outputs
+  uint64_t balance;                            ///< the sum of the amounts of the watched outputs
+  ledger_sync_cb cb;                           ///< the callback of changes
+  void* ctx;                                   ///< the user context of the callback
+  ledger_sync_stats_t stats;                   ///< the counters
+};
+
+// the changes of the milestone being applied
+typedef struct {
+  ledger_sync_t* ls;                        ///< the ledger sync
+  uint32_t index;                           ///< the milestone index
+  char (*created)[OUTPUTS_ID_HEX_LEN + 1];  ///< the created outputs that have to be fetched
+  size_t created_len;                       ///< the number of created outputs to fetch
+  size_t created_cap;                       ///< the capacity of the created outputs
+  uint32_t created_count;                   ///< the number of created outputs
+  uint32_t consumed_count;                  ///< the number of consumed outputs
+} milestone_changes_t;
+
+static int watch_add(ledger_sync_t* ls, char const output_id[], uint64_t amount, uint32_t index, bool notify) {
+  watched_output_t* out = calloc(1, sizeof(watched_output_t));
+  if (out == NULL) {
+    printf("[%s:%d] OOM\n", __func__, __LINE__);
+    return -1;
+  }
+  if (hex_2_bin(output_id, strlen(output_id), "0x", out->id, sizeof(out->id)) != 0) {
+    printf("[%s:%d] invalid output ID\n", __func__, __LINE__);
+    free(out);
+    return -1;
+  }
+
+  watched_output_t* old = NULL;
+  HASH_FIND(hh, ls->outputs, out->id, sizeof(out->id), old);
+  if (old) {
+    // a milestone that failed half way is applied again
+    free(out);
+    return 0;
+  }
+  out->amount = amount;
+  HASH_ADD(hh, ls->outputs, id, sizeof(out->id), out);
+  ls->balance += amount;
+  if (notify) {
+    ls->stats.added++;
+    if (ls->cb) {
+      ls->cb(output_id, amount, false, index, ls->ctx);
+    }
+  }
+  return 0;
+}
+
+// returns true for basic outputs whose only unlock condition is a watched address
+static bool output_owned(ledger_sync_t const* ls, utxo_output_t const* output, uint64_t* amount) {
+  if (output->output_type != OUTPUT_BASIC) {
+    return false;
+  }
+  output_basic_t const* basic = (output_basic_t const*)output->output;
+  if (condition_list_len(basic->unlock_conditions) != 1) {
+    return false;
+  }
+  unlock_cond_t* cond = condition_list_get_type(basic->unlock_conditions, UNLOCK_COND_ADDRESS);
+  if (cond == NULL) {
+    return false;
+  }
+  for (size_t i = 0; i < ls->addrs_len; i++) {
+    if (address_equal(&ls->addrs[i], (address_t*)cond->obj)) {
+      *amount = basic->amount;
+      return true;
+    }
+  }
+  return false;
+}
+
+static int add_created(ledger_sync_t* ls, char const (*output_ids)[OUTPUTS_ID_HEX_LEN + 1], size_t count,
+                       uint32_t index) {
+  char const* batch[LEDGER_SYNC_BATCH];
+  for (size_t i = 0; i < count; i++) {
+    batch[i] = output_ids[i];
+  }
+  output_batch_item_t results[LEDGER_SYNC_BATCH] = {};
+  int ret = get_outputs_batch(&ls->conf, batch, count, 0, results);
+  ls->stats.fetched += count;
+  for (size_t i = 0; ret == 0 && i < count; i++) {
+    uint64_t amount = 0;
+    if (results[i].ret != 0 || results[i].res->is_error) {
+      printf("[%s:%d] get output %s failed\n", __func__, __LINE__, batch[i]);
+      ret = -1;
+    } else if (!results[i].res->u.data->meta.is_spent && output_owned(ls, results[i].res->u.data->output, &amount)) {
+      // outputs already spent when the sync is behind the node are skipped, their consumption is not watched either
+      ret = watch_add(ls, batch[i], amount, index, true);
+    }
+  }
+  get_outputs_batch_free(results, count);
+  return ret;
+}
+
+static void watch_remove(ledger_sync_t* ls, char const output_id[], uint32_t index) {
+  byte_t id[OUTPUT_ID_BYTES];
+  if (hex_2_bin(output_id, strlen(output_id), "0x", id, sizeof(id)) != 0) {
+    return;
+  }
+  watched_output_t* out = NULL;
+  HASH_FIND(hh, ls->outputs, id, sizeof(id), out);
+  if (out) {
+    HASH_DEL(ls->outputs, out);
+    ls->balance -= out->amount;
+    ls->stats.spent++;
+    if (ls->cb) {
+      ls->cb(output_id, out->amount, true, index, ls->ctx);
+    }
+    free(out);
+  }
+}
+
+static int on_utxo_change(char const output_id[], bool created, void* ctx) {
+  milestone_changes_t* changes = (milestone_changes_t*)ctx;
+  if (!created) {
+    // consumed outputs are matched right away, removing them again has no effect
+    changes->consumed_count++;
+    watch_remove(changes->ls, output_id, changes->index);
+    return 0;
+  }
+
+  changes->created_count++;
+  if (changes->ls->addrs_len == 0) {
+    return 0;
+  }
+  if (changes->created_len == changes->created_cap) {
+    size_t cap = changes->created_cap ? changes->created_cap * 2 : LEDGER_SYNC_BATCH;
+    void* created = realloc(changes->created, cap * sizeof(changes->created[0]));
+    if (created == NULL) {
+      printf("[%s:%d] OOM\n", __func__, __LINE__);
+      return -1;
+    }
+    changes->created = created;
+    changes->created_cap = cap;
+  }
+  strcpy(changes->created[changes->created_len++], output_id);
+  return 0;
+}
+
+static int apply_milestone(ledger_sync_t* ls, uint32_t index) {
+  milestone_changes_t changes = {.ls = ls, .index = index};
+  res_err_t* error = NULL;
+  int ret = get_milestone_utxo_changes_stream(&ls->conf, index, on_utxo_change, &changes, &error);
+  if (error) {
+    printf("[%s:%d] milestone %" PRIu32 ": %s\n", __func__, __LINE__, index, error->msg);
+    res_err_free(error);
+    ret = -1;
+  }
+
+  for (size_t i = 0; ret == 0 && i < changes.created_len; i += LEDGER_SYNC_BATCH) {
+    size_t count = changes.created_len - i < LEDGER_SYNC_BATCH ? changes.created_len - i : LEDGER_SYNC_BATCH;
+    ret = add_created(ls, changes.created + i, count, index);
+  }
+  free(changes.created);
+
+  if (ret == 0) {
+    ls->index = index;
+    ls->stats.milestones++;
+    ls->stats.created += changes.created_count;
+    ls->stats.consumed += changes.consumed_count;
+  }
+  return ret;
+}
+
+ledger_sync_t* ledger_sync_new(iota_client_conf_t const* conf, ledger_sync_cb cb, void* ctx) {
+  if (conf == NULL) {
+    printf("[%s:%d] invalid parameters\n", __func__, __LINE__);
+    return NULL;
+  }
+  ledger_sync_t* ls = calloc(1, sizeof(ledger_sync_t));
+  if (ls == NULL) {
+    printf("[%s:%d] OOM\n", __func__, __LINE__);
+    return NULL;
+  }
+  memcpy(&ls->conf, conf, sizeof(iota_client_conf_t));
+  ls->cb = cb;
+  ls->ctx = ctx;
+  return ls;
+}
+
+int ledger_sync_watch_address(ledger_sync_t* ls, address_t const* addr) {
+  if (ls == NULL || addr == NULL) {
+    printf("[%s:%d] invalid parameters\n", __func__, __LINE__);
+    return -1;
+  }
+  for (size_t i = 0; i < ls->addrs_len; i++) {
+    if (address_equal(&ls->addrs[i], (address_t*)addr)) {
+      return 0;
+    }
+  }
+  if (ls->addrs_len == LEDGER_SYNC_MAX_ADDRESSES) {
+    printf("[%s:%d] too many addresses\n", __func__, __LINE__);
+    return -1;
+  }
+  memcpy(&ls->addrs[ls->addrs_len++], addr, sizeof(address_t));
+  return 0;
+}
+
+int ledger_sync_watch_output(ledger_sync_t* ls, char const output_id[], uint64_t amount) {
+  if (ls == NULL || output_id == NULL) {
+    printf("[%s:%d] invalid parameters\n", __func__, __LINE__);
+    return -1;
+  }
+  return watch_add(ls, output_id, amount, ls->index, false);
+}
+
+void ledger_sync_set_index(ledger_sync_t* ls, uint32_t ledger_index) {
+  if (ls) {
+    ls->index = ledger_index;
+  }
+}
+
+int ledger_sync_catch_up(ledger_sync_t* ls, uint32_t index) {
+  if (ls == NULL) {
+    printf("[%s:%d] invalid parameters\n", __func__, __LINE__);
+    return -1;
+  }
+  if (index == 0 && get_confirmed_milestone_index(&ls->conf, &index) != 0) {
+    printf("[%s:%d] get confirmed milestone failed\n", __func__, __LINE__);
+    return -1;
+  }
+
+  int ret = 0;
+  while (ret == 0 && ls->index < index) {
+    ret = apply_milestone(ls, ls->index + 1);
+  }
+  return ret;
+}
+
+uint32_t ledger_sync_index(ledger_sync_t const* ls) { return ls ? ls->index : 0; }
+
+uint64_t ledger_sync_balance(ledger_sync_t const* ls) { return ls ? ls->balance : 0; }
+
+size_t ledger_sync_outputs(ledger_sync_t const* ls) { return ls ? HASH_COUNT(ls->outputs) : 0; }
+
+void ledger_sync_get_stats(ledger_sync_t const* ls, ledger_sync_stats_t* stats) {
+  if (ls && stats) {
+    *stats = ls->stats;
+  }
+}
+
+void ledger_sync_free(ledger_sync_t* ls) {
+  if (ls) {
+    watched_output_t *out, *tmp;
+    HASH_ITER(hh, ls->outputs, out, tmp) {
+      HASH_DEL(ls->outputs, out);
+      free(out);
+    }
+    free(ls);
+  }
+}
@@ -0,0 +1,153 @@
+// Copyright 2022 IOTA Stiftung
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef __CLIENT_API_RESTFUL_LEDGER_SYNC_H__
+#define __CLIENT_API_RESTFUL_LEDGER_SYNC_H__
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "client/client_service.h"
+#include "core/address.h"
+
+// the maximum number of addresses watched by a ledger sync
+#define LEDGER_SYNC_MAX_ADDRESSES 8
+
+/**
+ * @brief Keeps a set of watched outputs current with the UTXO changes of each milestone
+ *
+ * The set is seeded with the outputs of the watched addresses at a ledger index, e.g. from the indexer, and is then
+ * updated milestone by milestone. Consumed outputs are matched against the set without further requests, created
+ * outputs are fetched and added if they belong to a watched address, so the cost of a milestone does not depend on the
+ * number of addresses. A sync is not thread safe.
+ *
+ */
+typedef struct ledger_sync ledger_sync_t;
+
+/**
+ * @brief Receives a change of the watched outputs
+ *
+ * @param[in] output_id The 0x prefixed hex string of the output ID
+ * @param[in] amount The amount of the output
+ * @param[in] spent true if the output was consumed, false if it was added
+ * @param[in] milestone_index The milestone of the change
+ * @param[in] ctx The user context
+ */
+typedef void (*ledger_sync_cb)(char const output_id[], uint64_t amount, bool spent, uint32_t milestone_index,
+                               void* ctx);
+
+/**
+ * @brief Counters of a ledger sync
+ *
+ */
+typedef struct {
+  uint32_t milestones;  ///< milestones applied
+  uint32_t created;     ///< outputs created by the applied milestones
+  uint32_t consumed;    ///< outputs consumed by the applied milestones
+  uint32_t fetched;     ///< created outputs fetched to check their address
+  uint32_t added;       ///< outputs added to the watched set
+  uint32_t spent;       ///< outputs removed from the watched set
+} ledger_sync_stats_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Create a ledger sync
+ *
+ * @param[in] conf The client endpoint configuration, it is copied
+ * @param[in] cb The callback of changes of the watched outputs, can be NULL
+ * @param[in] ctx The user context of the callback
+ * @return ledger_sync_t* NULL on errors
+ */
+ledger_sync_t* ledger_sync_new(iota_client_conf_t const* conf, ledger_sync_cb cb, void* ctx);
+
+/**
+ * @brief Watch the outputs created for an address
+ *
+ * Only basic outputs whose single unlock condition is the address are added, outputs with storage deposit return,
+ * timelock or expiration conditions are left out like in outputs_query_spendable().
+ *
+ * @param[in] ls The ledger sync
+ * @param[in] addr The address
+ * @return int 0 on success, -1 if LEDGER_SYNC_MAX_ADDRESSES addresses are watched
+ */
+int ledger_sync_watch_address(ledger_sync_t* ls, address_t const* addr);
+
+/**
+ * @brief Add an output to the watched set, e.g. from the indexer
+ *
+ * @param[in] ls The ledger sync
+ * @param[in] output_id The 0x prefixed hex string of the output ID
+ * @param[in] amount The amount of the output
+ * @return int 0 on success
+ */
+int ledger_sync_watch_output(ledger_sync_t* ls, char const output_id[], uint64_t amount);
+
+/**
+ * @brief Set the ledger index of the seeded outputs, the next milestone applied is the one after it
+ *
+ * @param[in] ls The ledger sync
+ * @param[in] ledger_index The ledger index, e.g. of the indexer response the outputs were taken from
+ */
+void ledger_sync_set_index(ledger_sync_t* ls, uint32_t ledger_index);
+
+/**
+ * @brief Apply the UTXO changes of the milestones up to an index
+ *
+ * Milestones are applied in order, one request per milestone plus the requests of created outputs that may belong to
+ * a watched address. It stops at the first failed milestone, a later call continues from there. Milestones pruned by
+ * the node cannot be applied, the set has to be seeded again.
+ *
+ * @param[in] ls The ledger sync
+ * @param[in] index The last milestone index to apply, 0 for the confirmed milestone of the node
+ * @return int 0 on success
+ */
+int ledger_sync_catch_up(ledger_sync_t* ls, uint32_t index);
+
+/**
+ * @brief Get the index of the last applied milestone
+ *
+ * @param[in] ls The ledger sync
+ * @return uint32_t The milestone index
+ */
+uint32_t ledger_sync_index(ledger_sync_t const* ls);
+
+/**
+ * @brief Get the sum of the amounts of the watched outputs
+ *
+ * @param[in] ls The ledger sync
+ * @return uint64_t The balance
+ */
+uint64_t ledger_sync_balance(ledger_sync_t const* ls);
+
+/**
+ * @brief Get the number of watched outputs
+ *
+ * @param[in] ls The ledger sync
+ * @return size_t The number of outputs
+ */
+size_t ledger_sync_outputs(ledger_sync_t const* ls);
+
+/**
+ * @brief Get the counters of a ledger sync
+ *
+ * @param[in] ls The ledger sync
+ * @param[out] stats The counters
+ */
+void ledger_sync_get_stats(ledger_sync_t const* ls, ledger_sync_stats_t* stats);
+
+/**
+ * @brief Free a ledger sync
+ *
+ * @param[in] ls The ledger sync
+ */
+void ledger_sync_free(ledger_sync_t* ls);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,204 @@
+// Copyright 2022 IOTA Stiftung
+// SPDX-License-Identifier: Apache-2.0
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "freertos/task.h"
+#include "sdkconfig.h"
+
+#include "client/api/restful/outputs_id_iter.h"
+#include "core/utils/byte_buffer.h"
+
+// the binary length of an output ID
+#define OUTPUT_ID_BYTES 34
+// "&pageSize=65535&cursor=" and the terminator
+#define OUTPUTS_PAGING_PARAMS_LEN 24
+
+typedef struct {
+  byte_t* ids;             ///< output IDs in binary form
+  size_t cap;              ///< the number of output IDs the buffer can hold
+  size_t count;            ///< the number of output IDs in this page
+  outputs_id_page_t info;  ///< the cursor and ledger index of this page
+  res_err_t* error;        ///< the error response of the node
+  int ret;                 ///< the result of the request
+} outputs_page_t;
+
+struct outputs_id_iter {
+  iota_client_conf_t conf;                       ///< the node endpoint
+  char* query;                                   ///< the base query string
+  uint16_t page_size;                            ///< the number of output IDs per request
+  bool prefetch;                                 ///< fetch the next page in the background
+  outputs_page_t pages[2];                       ///< the current and the next page
+  uint8_t front;                                 ///< the index of the current page
+  size_t pos;                                    ///< the next output ID in the current page
+  bool started;                                  ///< the first page was fetched
+  bool prefetching;                              ///< a prefetch task is filling the next page
+  char next_cursor[OUTPUTS_CURSOR_MAX_LEN + 1];  ///< the cursor of the page being fetched
+  SemaphoreHandle_t prefetch_done;               ///< given by the prefetch task when it is done
+};
+
+static int store_output_id(char const output_id[], void* ctx) {
+  outputs_page_t* page = (outputs_page_t*)ctx;
+  if (page->count >= page->cap) {
+    printf("[%s:%d] page exceeds the requested size\n", __func__, __LINE__);
+    return -1;
+  }
+  return hex_2_bin(output_id, strlen(output_id), "0x", page->ids + page->count++ * OUTPUT_ID_BYTES, OUTPUT_ID_BYTES);
+}
+
+static void page_fetch(outputs_id_iter_t* it, outputs_page_t* page, char const cursor[]) {
+  size_t query_len = strlen(it->query) + OUTPUTS_PAGING_PARAMS_LEN + strlen(cursor);
+  char* query = malloc(query_len);
+  page->count = 0;
+  page->error = NULL;
+  if (query == NULL) {
+    printf("[%s:%d] OOM\n", __func__, __LINE__);
+    page->ret = -1;
+    return;
+  }
+
+  if (cursor[0]) {
+    snprintf(query, query_len, "%s&pageSize=%u&cursor=%s", it->query, it->page_size, cursor);
+  } else {
+    snprintf(query, query_len, "%s&pageSize=%u", it->query, it->page_size);
+  }
+  page->ret = get_basic_outputs_id_stream(&it->conf, query, store_output_id, page, &page->info, &page->error);
+  free(query);
+}
+
+static void prefetch_task(void* arg) {
+  outputs_id_iter_t* it = (outputs_id_iter_t*)arg;
+  page_fetch(it, &it->pages[it->front ^ 1], it->next_cursor);
+  xSemaphoreGive(it->prefetch_done);
+  vTaskDelete(NULL);
+}
+
+static void prefetch_start(outputs_id_iter_t* it) {
+  outputs_page_t* front = &it->pages[it->front];
+  if (!it->prefetch || front->info.cursor[0] == '\0') {
+    return;
+  }
+  strcpy(it->next_cursor, front->info.cursor);
+  if (xTaskCreate(prefetch_task, "outputs_prefetch", CONFIG_IOTA_CLIENT_TASK_STACK_SIZE, it, tskIDLE_PRIORITY + 5,
+                  NULL) == pdPASS) {
+    it->prefetching = true;
+  }
+}
+
+static void page_reset(outputs_page_t* page) {
+  if (page->error) {
+    res_err_free(page->error);
+    page->error = NULL;
+  }
+  page->count = 0;
+}
+
+outputs_id_iter_t* outputs_id_iter_new(iota_client_conf_t const* conf, char const query[], uint16_t page_size,
+                                       bool prefetch) {
+  if (conf == NULL || query == NULL || page_size == 0) {
+    printf("[%s:%d] invalid parameters\n", __func__, __LINE__);
+    return NULL;
+  }
+
+  outputs_id_iter_t* it = calloc(1, sizeof(outputs_id_iter_t));
+  if (it == NULL) {
+    printf("[%s:%d] OOM\n", __func__, __LINE__);
+    return NULL;
+  }
+  memcpy(&it->conf, conf, sizeof(iota_client_conf_t));
+  it->page_size = page_size;
+  it->prefetch = prefetch;
+  it->query = strdup(query);
+  it->pages[0].ids = malloc(page_size * OUTPUT_ID_BYTES);
+  it->pages[0].cap = it->pages[1].cap = page_size;
+  if (prefetch) {
+    it->pages[1].ids = malloc(page_size * OUTPUT_ID_BYTES);
+    it->prefetch_done = xSemaphoreCreateBinary();
+  } else {
+    // without prefetching both pages share the same buffer
+    it->pages[1].ids = it->pages[0].ids;
+  }
+
+  if (it->query == NULL || it->pages[0].ids == NULL || it->pages[1].ids == NULL ||
+      (prefetch && it->prefetch_done == NULL)) {
+    printf("[%s:%d] OOM\n", __func__, __LINE__);
+    outputs_id_iter_free(it);
+    return NULL;
+  }
+  return it;
+}
+
+int outputs_id_iter_next(outputs_id_iter_t* it, char output_id[]) {
+  if (it == NULL || output_id == NULL) {
+    printf("[%s:%d] invalid parameters\n", __func__, __LINE__);
+    return -1;
+  }
+
+  if (!it->started) {
+    it->started = true;
+    page_fetch(it, &it->pages[it->front], "");
+    if (it->pages[it->front].ret != 0 || it->pages[it->front].error) {
+      return -1;
+    }
+    prefetch_start(it);
+  }
+
+  outputs_page_t* page = &it->pages[it->front];
+  while (it->pos >= page->count) {
+    if (page->info.cursor[0] == '\0') {
+      return 1;
+    }
+    if (it->prefetching) {
+      xSemaphoreTake(it->prefetch_done, portMAX_DELAY);
+      it->prefetching = false;
+    } else {
+      strcpy(it->next_cursor, page->info.cursor);
+      page_fetch(it, &it->pages[it->front ^ 1], it->next_cursor);
+    }
+    page_reset(page);
+    it->front ^= 1;
+    it->pos = 0;
+    page = &it->pages[it->front];
+    if (page->ret != 0 || page->error) {
+      return -1;
+    }
+    prefetch_start(it);
+  }
+
+  if (bin_2_hex(page->ids + it->pos++ * OUTPUT_ID_BYTES, OUTPUT_ID_BYTES, "0x", output_id, OUTPUTS_ID_HEX_LEN + 1) !=
+      0) {
+    return -1;
+  }
+  return 0;
+}
+
+res_err_t const* outputs_id_iter_error(outputs_id_iter_t const* it) {
+  return it ? it->pages[it->front].error : NULL;
+}
+
+uint32_t outputs_id_iter_ledger_index(outputs_id_iter_t const* it) {
+  return it ? it->pages[it->front].info.ledger_idx : 0;
+}
+
+void outputs_id_iter_free(outputs_id_iter_t* it) {
+  if (it) {
+    if (it->prefetching) {
+      xSemaphoreTake(it->prefetch_done, portMAX_DELAY);
+    }
+    if (it->prefetch_done) {
+      vSemaphoreDelete(it->prefetch_done);
+    }
+    page_reset(&it->pages[0]);
+    page_reset(&it->pages[1]);
+    if (it->pages[1].ids != it->pages[0].ids) {
+      free(it->pages[1].ids);
+    }
+    free(it->pages[0].ids);
+    free(it->query);
+    free(it);
+  }
+}
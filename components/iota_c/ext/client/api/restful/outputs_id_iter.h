@@ -0,0 +1,75 @@
+// Copyright 2022 IOTA Stiftung
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef __CLIENT_API_RESTFUL_OUTPUTS_ID_ITER_H__
+#define __CLIENT_API_RESTFUL_OUTPUTS_ID_ITER_H__
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "client/api/restful/get_outputs_id_stream.h"
+
+/**
+ * @brief An iterator over the output IDs of an indexer query
+ *
+ * Output IDs are fetched page by page with the indexer cursor, only one page (two with prefetching) is held in memory
+ * no matter how many outputs match the query.
+ *
+ */
+typedef struct outputs_id_iter outputs_id_iter_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Create an output ID iterator of a basic outputs query
+ *
+ * @param[in] conf The client endpoint configuration
+ * @param[in] query The query string without paging parameters, e.g. "address=iota1..."
+ * @param[in] page_size The number of output IDs fetched per request
+ * @param[in] prefetch Fetch the next page in the background while the current one is processed
+ * @return outputs_id_iter_t* NULL on errors
+ */
+outputs_id_iter_t* outputs_id_iter_new(iota_client_conf_t const* conf, char const query[], uint16_t page_size,
+                                       bool prefetch);
+
+/**
+ * @brief Get the next output ID
+ *
+ * @param[in] it The iterator
+ * @param[out] output_id A buffer of OUTPUTS_ID_HEX_LEN + 1 bytes for the 0x prefixed hex string of the output ID
+ * @return int 0 on success, 1 if there are no more output IDs, -1 on errors
+ */
+int outputs_id_iter_next(outputs_id_iter_t* it, char output_id[]);
+
+/**
+ * @brief Get the error response of the node after outputs_id_iter_next() failed
+ *
+ * @param[in] it The iterator
+ * @return res_err_t const* NULL if the node did not respond with an error
+ */
+res_err_t const* outputs_id_iter_error(outputs_id_iter_t const* it);
+
+/**
+ * @brief Get the ledger index of the last fetched page
+ *
+ * @param[in] it The iterator
+ * @return uint32_t The ledger index
+ */
+uint32_t outputs_id_iter_ledger_index(outputs_id_iter_t const* it);
+
+/**
+ * @brief Free an output ID iterator
+ *
+ * Waits for a running prefetch to complete.
+ *
+ * @param[in] it The iterator
+ */
+void outputs_id_iter_free(outputs_id_iter_t* it);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
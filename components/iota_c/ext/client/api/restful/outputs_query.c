@@ -0,0 +1,102 @@
+// Copyright 2022 IOTA Stiftung
+// SPDX-License-Identifier: Apache-2.0
+
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "client/api/restful/outputs_query.h"
+
+typedef struct {
+  char* buf;
+  size_t buf_len;
+  size_t len;
+  bool failed;
+} query_buf_t;
+
+// values are written as they are, so they must not need URL encoding
+static bool plain_token(char const* value) {
+  for (char const* p = value; *p; p++) {
+    if (!((*p >= '0' && *p <= '9') || (*p >= 'a' && *p <= 'z') || (*p >= 'A' && *p <= 'Z'))) {
+      return false;
+    }
+  }
+  return *value != '\0';
+}
+
+static void append_str(query_buf_t* q, char const* name, char const* value) {
+  if (value == NULL || q->failed) {
+    return;
+  }
+  if (!plain_token(value)) {
+    printf("[%s:%d] invalid %s\n", __func__, __LINE__, name);
+    q->failed = true;
+    return;
+  }
+  int n = snprintf(q->buf + q->len, q->buf_len - q->len, "%s%s=%s", q->len ? "&" : "", name, value);
+  if (n < 0 || (size_t)n >= q->buf_len - q->len) {
+    printf("[%s:%d] query buffer too small\n", __func__, __LINE__);
+    q->failed = true;
+    return;
+  }
+  q->len += n;
+}
+
+static void append_u32(query_buf_t* q, char const* name, uint32_t value) {
+  if (value) {
+    char str[11];
+    snprintf(str, sizeof(str), "%" PRIu32, value);
+    append_str(q, name, str);
+  }
+}
+
+static void append_filter(query_buf_t* q, char const* name, outputs_filter_e filter) {
+  if (filter != OUTPUTS_FILTER_ANY) {
+    append_str(q, name, filter == OUTPUTS_FILTER_WITH ? "true" : "false");
+  }
+}
+
+void outputs_query_spendable(outputs_query_t* query, char const* address) {
+  if (query == NULL) {
+    return;
+  }
+  memset(query, 0, sizeof(outputs_query_t));
+  query->address = address;
+  query->storage_deposit_return = OUTPUTS_FILTER_WITHOUT;
+  query->timelock = OUTPUTS_FILTER_WITHOUT;
+  query->expiration = OUTPUTS_FILTER_WITHOUT;
+}
+
+int outputs_query_str(outputs_query_t const* query, char buf[], size_t buf_len) {
+  if (query == NULL || buf == NULL || buf_len == 0) {
+    printf("[%s:%d] invalid parameters\n", __func__, __LINE__);
+    return -1;
+  }
+  buf[0] = '\0';
+
+  query_buf_t q = {.buf = buf, .buf_len = buf_len};
+  append_str(&q, "address", query->address);
+  append_filter(&q, "hasNativeTokens", query->native_tokens);
+  append_u32(&q, "minNativeTokenCount", query->min_native_token_count);
+  append_u32(&q, "maxNativeTokenCount", query->max_native_token_count);
+  append_filter(&q, "hasStorageDepositReturn", query->storage_deposit_return);
+  append_str(&q, "storageDepositReturnAddress", query->storage_deposit_return_address);
+  append_filter(&q, "hasTimelock", query->timelock);
+  append_u32(&q, "timelockedBefore", query->timelocked_before);
+  append_u32(&q, "timelockedAfter", query->timelocked_after);
+  append_filter(&q, "hasExpiration", query->expiration);
+  append_u32(&q, "expiresBefore", query->expires_before);
+  append_u32(&q, "expiresAfter", query->expires_after);
+  append_str(&q, "expirationReturnAddress", query->expiration_return_address);
+  append_str(&q, "sender", query->sender);
+  append_str(&q, "tag", query->tag);
+  append_u32(&q, "createdBefore", query->created_before);
+  append_u32(&q, "createdAfter", query->created_after);
+
+  if (q.failed) {
+    buf[0] = '\0';
+    return -1;
+  }
+  return (int)q.len;
+}
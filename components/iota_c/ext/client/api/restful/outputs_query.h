@@ -0,0 +1,78 @@
+// Copyright 2022 IOTA Stiftung
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef __CLIENT_API_RESTFUL_OUTPUTS_QUERY_H__
+#define __CLIENT_API_RESTFUL_OUTPUTS_QUERY_H__
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @brief A filter on the presence of an output feature
+ *
+ */
+typedef enum {
+  OUTPUTS_FILTER_ANY = 0,  ///< outputs with and without it
+  OUTPUTS_FILTER_WITH,     ///< only outputs that have it
+  OUTPUTS_FILTER_WITHOUT,  ///< only outputs that do not have it
+} outputs_filter_e;
+
+/**
+ * @brief The filters of an indexer basic outputs query
+ *
+ * Zeroed members are not sent, the node applies all filters that are set. Addresses are bech32 strings and the tag is
+ * a 0x prefixed hex string. Times are Unix timestamps in seconds.
+ *
+ */
+typedef struct {
+  char const* address;                         ///< outputs unlockable by this address
+  outputs_filter_e native_tokens;              ///< outputs with or without native tokens
+  uint32_t min_native_token_count;             ///< outputs with at least this number of native tokens
+  uint32_t max_native_token_count;             ///< outputs with at most this number of native tokens
+  outputs_filter_e storage_deposit_return;     ///< outputs with or without a storage deposit return condition
+  char const* storage_deposit_return_address;  ///< outputs that return the storage deposit to this address
+  outputs_filter_e timelock;                   ///< outputs with or without a timelock condition
+  uint32_t timelocked_before;                  ///< outputs whose timelock ends before this time
+  uint32_t timelocked_after;                   ///< outputs whose timelock ends after this time
+  outputs_filter_e expiration;                 ///< outputs with or without an expiration condition
+  uint32_t expires_before;                     ///< outputs that expire before this time
+  uint32_t expires_after;                      ///< outputs that expire after this time
+  char const* expiration_return_address;       ///< outputs that return to this address once expired
+  char const* sender;                          ///< outputs with this sender feature
+  char const* tag;                             ///< outputs with this tag feature
+  uint32_t created_before;                     ///< outputs created before this time
+  uint32_t created_after;                      ///< outputs created after this time
+} outputs_query_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Set up a query for the outputs of an address that it can spend without checking their conditions
+ *
+ * Outputs with a storage deposit return, a timelock or an expiration condition are filtered out by the node, so the
+ * amount of every output ID returned belongs to the address.
+ *
+ * @param[out] query The query
+ * @param[in] address The bech32 address, it is referenced by the query
+ */
+void outputs_query_spendable(outputs_query_t* query, char const* address);
+
+/**
+ * @brief Build the query string of the filters
+ *
+ * The result is passed to get_basic_outputs_id_stream() and outputs_id_iter_new().
+ *
+ * @param[in] query The filters
+ * @param[out] buf The buffer of the query string without the leading question mark
+ * @param[in] buf_len The size of the buffer
+ * @return int The length of the query string, -1 if a value is not a plain token or the buffer is too small
+ */
+int outputs_query_str(outputs_query_t const* query, char buf[], size_t buf_len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
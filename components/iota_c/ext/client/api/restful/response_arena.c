@@ -0,0 +1,132 @@
+// Copyright 2022 IOTA Stiftung
+// SPDX-License-Identifier: Apache-2.0
+
+#include <stdio.h>
+#include <string.h>
+
+#include "sdkconfig.h"
+
+#include "client/api/restful/get_outputs_id_stream.h"
+#include "client/api/restful/response_arena.h"
+#include "client/network/http_request.h"
+#include "core/utils/arena.h"
+
+#define NODE_INFO_PATH "/api/core/v2/info"
+#define OUTPUTS_PATH "/api/core/v2/outputs/"
+#define BLOCKS_PATH "/api/core/v2/blocks/"
+// 0x prefixed hex string of a block ID
+#define BLOCK_ID_HEX_LEN (2 + IOTA_BLOCK_ID_BYTES * 2)
+
+#if CONFIG_IOTA_RESPONSE_ARENA_PSRAM
+#define ARENA_PSRAM true
+#else
+#define ARENA_PSRAM false
+#endif
+
+typedef void* (*response_new_fn)(void);
+typedef int (*response_parse_fn)(char const* json, void* res);
+
+static void* output_new(void) { return get_output_response_new(); }
+
+static int output_parse(char const* json, void* res) { return parse_get_output(json, (res_output_t*)res); }
+
+static void* block_new(void) { return res_block_new(); }
+
+static int block_parse(char const* json, void* res) { return deser_get_block(json, (res_block_t*)res); }
+
+static void* node_info_new(void) { return res_node_info_new(); }
+
+static int node_info_parse(char const* json, void* res) { return deser_node_info(json, (res_node_info_t*)res); }
+
+// the response is received into the heap and parsed with the arena entered. cJSON is not routed, its tree is freed
+// on the heap when the parser deletes it, only the response objects stay in the arena.
+static int arena_get(iota_client_conf_t const* conf, char const path[], response_new_fn res_new,
+                     response_parse_fn parse, void** res) {
+  *res = NULL;
+  byte_buf_t* http_res = byte_buf_new();
+  if (http_res == NULL) {
+    printf("[%s:%d] OOM\n", __func__, __LINE__);
+    return -1;
+  }
+
+  http_client_config_t http_conf = {.host = conf->host, .path = path, .use_tls = conf->use_tls, .port = conf->port};
+  long st = 0;
+  int ret = http_client_get(&http_conf, http_res, &st);
+  if (ret != 0 || !byte_buf2str(http_res)) {
+    ret = -1;
+    goto end;
+  }
+
+  arena_t* arena = arena_new(http_res->len * CONFIG_IOTA_RESPONSE_ARENA_FACTOR, ARENA_PSRAM);
+  if (arena == NULL) {
+    printf("[%s:%d] OOM\n", __func__, __LINE__);
+    ret = -1;
+    goto end;
+  }
+  // the response object is the first allocation, arena_of() finds the arena from it
+  arena_t* prev = arena_enter(arena);
+  void* r = res_new();
+  ret = r ? parse((char const*)http_res->data, r) : -1;
+  arena_enter(prev);
+  if (ret == 0) {
+    *res = r;
+  } else {
+    arena_free(arena);
+  }
+
+end:
+  byte_buf_free(http_res);
+  return ret;
+}
+
+static void arena_response_free(void* res) {
+  arena_t* arena = arena_of(res);
+  if (arena) {
+    arena_free(arena);
+  } else if (res) {
+    printf("[%s:%d] not an arena response\n", __func__, __LINE__);
+  }
+}
+
+int get_output_arena(iota_client_conf_t const* conf, char const output_id[], res_output_t** res) {
+  if (conf == NULL || output_id == NULL || res == NULL) {
+    printf("[%s:%d] invalid parameters\n", __func__, __LINE__);
+    return -1;
+  }
+  char const* prefix = strncmp(output_id, "0x", 2) == 0 ? "" : "0x";
+  if (strlen(prefix) + strlen(output_id) != OUTPUTS_ID_HEX_LEN) {
+    printf("[%s:%d] incorrect length of the output ID\n", __func__, __LINE__);
+    return -1;
+  }
+  char path[sizeof(OUTPUTS_PATH) + OUTPUTS_ID_HEX_LEN] = {};
+  snprintf(path, sizeof(path), "%s%s%s", OUTPUTS_PATH, prefix, output_id);
+  return arena_get(conf, path, output_new, output_parse, (void**)res);
+}
+
+void get_output_response_arena_free(res_output_t* res) { arena_response_free(res); }
+
+int get_block_by_id_arena(iota_client_conf_t const* conf, char const blk_id[], res_block_t** res) {
+  if (conf == NULL || blk_id == NULL || res == NULL) {
+    printf("[%s:%d] invalid parameters\n", __func__, __LINE__);
+    return -1;
+  }
+  if (strlen(blk_id) != BLOCK_ID_HEX_LEN) {
+    printf("[%s:%d] incorrect length of the block ID\n", __func__, __LINE__);
+    return -1;
+  }
+  char path[sizeof(BLOCKS_PATH) + BLOCK_ID_HEX_LEN] = {};
+  snprintf(path, sizeof(path), "%s%s", BLOCKS_PATH, blk_id);
+  return arena_get(conf, path, block_new, block_parse, (void**)res);
+}
+
+void res_block_arena_free(res_block_t* res) { arena_response_free(res); }
+
+int get_node_info_arena(iota_client_conf_t const* conf, res_node_info_t** res) {
+  if (conf == NULL || res == NULL) {
+    printf("[%s:%d] invalid parameters\n", __func__, __LINE__);
+    return -1;
+  }
+  return arena_get(conf, NODE_INFO_PATH, node_info_new, node_info_parse, (void**)res);
+}
+
+void res_node_info_arena_free(res_node_info_t* res) { arena_response_free(res); }
@@ -0,0 +1,73 @@
+// Copyright 2022 IOTA Stiftung
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef __CLIENT_API_RESTFUL_RESPONSE_ARENA_H__
+#define __CLIENT_API_RESTFUL_RESPONSE_ARENA_H__
+
+#include "client/api/restful/get_block.h"
+#include "client/api/restful/get_node_info.h"
+#include "client/api/restful/get_output.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Get an output, the response is allocated from a single arena
+ *
+ * The same as get_output() but every allocation of the response object is taken from one region of
+ * CONFIG_IOTA_RESPONSE_ARENA_FACTOR times the response length. The region grows if that is not enough. The cJSON tree
+ * is built on the heap and freed once the response is parsed.
+ *
+ * @param[in] conf The client endpoint configuration
+ * @param[in] output_id The output ID in hex string format
+ * @param[out] res The output or the error response of the node, free it with get_output_response_arena_free()
+ * @return int 0 on success
+ */
+int get_output_arena(iota_client_conf_t const* conf, char const output_id[], res_output_t** res);
+
+/**
+ * @brief Free an output response of get_output_arena(), all its memory is released at once
+ *
+ * @param[in] res The output response
+ */
+void get_output_response_arena_free(res_output_t* res);
+
+/**
+ * @brief Get a block, the response is allocated from a single arena
+ *
+ * @param[in] conf The client endpoint configuration
+ * @param[in] blk_id The block ID in hex string format
+ * @param[out] res The block or the error response of the node, free it with res_block_arena_free()
+ * @return int 0 on success
+ */
+int get_block_by_id_arena(iota_client_conf_t const* conf, char const blk_id[], res_block_t** res);
+
+/**
+ * @brief Free a block response of get_block_by_id_arena(), all its memory is released at once
+ *
+ * @param[in] res The block response
+ */
+void res_block_arena_free(res_block_t* res);
+
+/**
+ * @brief Get the node info, the response is allocated from a single arena
+ *
+ * @param[in] conf The client endpoint configuration
+ * @param[out] res The node info or the error response of the node, free it with res_node_info_arena_free()
+ * @return int 0 on success
+ */
+int get_node_info_arena(iota_client_conf_t const* conf, res_node_info_t** res);
+
+/**
+ * @brief Free a node info response of get_node_info_arena(), all its memory is released at once
+ *
+ * @param[in] res The node info response
+ */
+void res_node_info_arena_free(res_node_info_t* res);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
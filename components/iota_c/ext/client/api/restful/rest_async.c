@@ -0,0 +1,212 @@
+// Copyright 2022 IOTA Stiftung
+// SPDX-License-Identifier: Apache-2.0
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/queue.h"
+#include "freertos/semphr.h"
+#include "freertos/task.h"
+#include "sdkconfig.h"
+
+#include "client/api/restful/rest_async.h"
+#include "client/network/http_request.h"
+
+typedef enum {
+  REQ_QUEUED = 0,  ///< waiting for a worker
+  REQ_RUNNING,     ///< a worker performs the call
+  REQ_DONE,        ///< the worker is finished with the user argument and delivered the result
+} req_state_e;
+
+struct rest_async_req {
+  iota_client_conf_t conf;  ///< the node endpoint
+  rest_async_call_t call;   ///< the blocking call
+  void* arg;                ///< the user argument
+  rest_async_cb cb;         ///< the completion callback, can be NULL
+  TaskHandle_t owner;       ///< notified on completion if there is no callback
+  int64_t deadline;         ///< the time the request times out in microseconds, 0 for none
+  req_state_e state;        ///< the state of the request
+  bool cancelled;           ///< the call is not made or its result is replaced by REST_ASYNC_ERR_CANCELLED
+  int ret;                  ///< the result of the call
+  uint8_t refs;             ///< the references of the caller and the worker
+};
+
+static QueueHandle_t req_queue = NULL;
+// guards the state and the references of the requests
+static SemaphoreHandle_t req_lock = NULL;
+
+static void req_unref(rest_async_req_t* req) {
+  xSemaphoreTake(req_lock, portMAX_DELAY);
+  bool last = --req->refs == 0;
+  xSemaphoreGive(req_lock);
+  if (last) {
+    free(req);
+  }
+}
+
+// every request completes exactly once, also a cancelled one, which tells the caller that the argument is free
+static void req_complete(rest_async_req_t* req, int ret) {
+  xSemaphoreTake(req_lock, portMAX_DELAY);
+  if (req->cancelled) {
+    ret = REST_ASYNC_ERR_CANCELLED;
+  }
+  req->state = REQ_DONE;
+  req->ret = ret;
+  xSemaphoreGive(req_lock);
+
+  if (req->cb) {
+    req->cb(ret, req->arg);
+  } else {
+    xTaskNotifyGive(req->owner);
+  }
+}
+
+static bool req_expired(rest_async_req_t const* req) {
+  return req->deadline && esp_timer_get_time() >= req->deadline;
+}
+
+static void worker_task(void* arg) {
+  for (;;) {
+    rest_async_req_t* req = NULL;
+    if (xQueueReceive(req_queue, &req, portMAX_DELAY) != pdTRUE) {
+      continue;
+    }
+
+    xSemaphoreTake(req_lock, portMAX_DELAY);
+    bool run = !req->cancelled;
+    req->state = REQ_RUNNING;
+    xSemaphoreGive(req_lock);
+
+    int ret = REST_ASYNC_ERR_CANCELLED;
+    if (run) {
+      ret = REST_ASYNC_ERR_TIMEOUT;
+      if (!req_expired(req)) {
+        // all HTTP requests of the call share the deadline of the request
+        http_client_set_deadline(req->deadline);
+        ret = req->call(&req->conf, req->arg);
+        http_client_set_deadline(0);
+        if (ret != 0 && req_expired(req)) {
+          ret = REST_ASYNC_ERR_TIMEOUT;
+        }
+      }
+    }
+    req_complete(req, ret);
+    req_unref(req);
+  }
+}
+
+// not thread safe, the application calls it at startup before any task submits requests
+int rest_async_init() {
+  if (req_queue) {
+    return 0;
+  }
+
+  req_lock = xSemaphoreCreateMutex();
+  req_queue = xQueueCreate(CONFIG_IOTA_REST_ASYNC_QUEUE_LEN, sizeof(rest_async_req_t*));
+  if (req_lock == NULL || req_queue == NULL) {
+    printf("[%s:%d] OOM\n", __func__, __LINE__);
+    return -1;
+  }
+
+  for (int i = 0; i < CONFIG_IOTA_REST_ASYNC_WORKERS; i++) {
+    if (xTaskCreate(worker_task, "rest_async", CONFIG_IOTA_CLIENT_TASK_STACK_SIZE, NULL, tskIDLE_PRIORITY + 5, NULL) !=
+        pdPASS) {
+      printf("[%s:%d] create worker task failed\n", __func__, __LINE__);
+      // the workers that were started serve the queue
+      return i > 0 ? 0 : -1;
+    }
+  }
+  return 0;
+}
+
+rest_async_req_t* rest_async_submit(iota_client_conf_t const* conf, rest_async_call_t call, void* arg, rest_async_cb cb,
+                                    uint32_t timeout_ms) {
+  if (conf == NULL || call == NULL) {
+    printf("[%s:%d] invalid parameters\n", __func__, __LINE__);
+    return NULL;
+  }
+  if (req_queue == NULL) {
+    printf("[%s:%d] rest_async_init() was not called\n", __func__, __LINE__);
+    return NULL;
+  }
+
+  rest_async_req_t* req = calloc(1, sizeof(rest_async_req_t));
+  if (req == NULL) {
+    printf("[%s:%d] OOM\n", __func__, __LINE__);
+    return NULL;
+  }
+  memcpy(&req->conf, conf, sizeof(iota_client_conf_t));
+  req->call = call;
+  req->arg = arg;
+  req->cb = cb;
+  req->owner = xTaskGetCurrentTaskHandle();
+  req->deadline = timeout_ms ? esp_timer_get_time() + (int64_t)timeout_ms * 1000 : 0;
+  req->state = REQ_QUEUED;
+  req->refs = 2;
+
+  if (xQueueSend(req_queue, &req, 0) != pdTRUE) {
+    printf("[%s:%d] request queue is full\n", __func__, __LINE__);
+    free(req);
+    return NULL;
+  }
+  return req;
+}
+
+int rest_async_wait(rest_async_req_t* req, uint32_t wait_ms, int* ret) {
+  if (req == NULL || ret == NULL) {
+    printf("[%s:%d] invalid parameters\n", __func__, __LINE__);
+    return -1;
+  }
+
+  int64_t until = esp_timer_get_time() + (int64_t)wait_ms * 1000;
+  for (;;) {
+    xSemaphoreTake(req_lock, portMAX_DELAY);
+    req_state_e state = req->state;
+    *ret = req->ret;
+    xSemaphoreGive(req_lock);
+    if (state == REQ_DONE) {
+      return 0;
+    }
+
+    int64_t left_us = until - esp_timer_get_time();
+    if (left_us <= 0) {
+      return -1;
+    }
+    // the notification can also come from another request of this task, the state tells
+    ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS((left_us + 999) / 1000));
+  }
+}
+
+int rest_async_cancel(rest_async_req_t* req) {
+  if (req == NULL) {
+    return -1;
+  }
+
+  xSemaphoreTake(req_lock, portMAX_DELAY);
+  int ret = -1;
+  if (req->state != REQ_DONE && !req->cancelled) {
+    req->cancelled = true;
+    ret = 0;
+  }
+  xSemaphoreGive(req_lock);
+  return ret;
+}
+
+bool rest_async_done(rest_async_req_t const* req) {
+  if (req == NULL) {
+    return false;
+  }
+  xSemaphoreTake(req_lock, portMAX_DELAY);
+  bool done = req->state == REQ_DONE;
+  xSemaphoreGive(req_lock);
+  return done;
+}
+
+void rest_async_release(rest_async_req_t* req) {
+  if (req) {
+    req_unref(req);
+  }
+}
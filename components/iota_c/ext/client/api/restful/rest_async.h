@@ -0,0 +1,125 @@
+// Copyright 2022 IOTA Stiftung
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef __CLIENT_API_RESTFUL_REST_ASYNC_H__
+#define __CLIENT_API_RESTFUL_REST_ASYNC_H__
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "client/client_service.h"
+
+// the result of a request that did not complete before its timeout
+#define REST_ASYNC_ERR_TIMEOUT -2
+// the result of a cancelled request
+#define REST_ASYNC_ERR_CANCELLED -3
+
+/**
+ * @brief Performs a blocking REST API call on a worker task
+ *
+ * @param[in] conf The client endpoint configuration
+ * @param[in] arg The user argument of the request, e.g. the parameters and the response object of the call
+ * @return int The result of the API call, 0 on success
+ */
+typedef int (*rest_async_call_t)(iota_client_conf_t const* conf, void* arg);
+
+/**
+ * @brief Receives the result of a request on the worker task
+ *
+ * It is called exactly once for every request, also for a cancelled one. The worker does not touch the user argument
+ * afterwards, the callback may free it.
+ *
+ * @param[in] ret The result of the call, REST_ASYNC_ERR_TIMEOUT or REST_ASYNC_ERR_CANCELLED
+ * @param[in] arg The user argument of the request
+ */
+typedef void (*rest_async_cb)(int ret, void* arg);
+
+/**
+ * @brief A queued REST API call
+ *
+ */
+typedef struct rest_async_req rest_async_req_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Start the worker tasks of asynchronous requests
+ *
+ * CONFIG_IOTA_REST_ASYNC_WORKERS tasks serve the queue, so that many requests can be in flight at once. It must be
+ * called once at startup, before any task submits requests, further calls do nothing.
+ *
+ * @return int 0 on success
+ */
+int rest_async_init();
+
+/**
+ * @brief Queue a REST API call to the worker tasks
+ *
+ * The result is passed to the callback on a worker task. Without a callback, the submitting task gets a task
+ * notification when the request completes and rest_async_wait() returns the result.
+ *
+ * The user argument belongs to the request until it completed, i.e. until the callback was called or rest_async_wait()
+ * returned 0. Cancelling a request does not end that earlier.
+ *
+ * The request holds a reference for the caller, it must be released with rest_async_release() in any case. A request
+ * that is only handled by its callback can be released right after it was submitted.
+ *
+ * A timeout bounds the time from submission until completion. Requests that are still queued at the timeout complete
+ * without running, running requests fail at their next network operation after the timeout.
+ *
+ * @param[in] conf The client endpoint configuration, it is copied
+ * @param[in] call The blocking API call
+ * @param[in] arg The user argument of the call and the callback
+ * @param[in] cb The completion callback, NULL to notify the submitting task
+ * @param[in] timeout_ms The timeout, 0 for the timeout of each HTTP request only
+ * @return rest_async_req_t* NULL if rest_async_init() was not called, the queue is full or on errors
+ */
+rest_async_req_t* rest_async_submit(iota_client_conf_t const* conf, rest_async_call_t call, void* arg, rest_async_cb cb,
+                                    uint32_t timeout_ms);
+
+/**
+ * @brief Wait for a request submitted without a callback
+ *
+ * @param[in] req The request
+ * @param[in] wait_ms The maximum time to wait
+ * @param[out] ret The result of the call, REST_ASYNC_ERR_TIMEOUT or REST_ASYNC_ERR_CANCELLED
+ * @return int 0 if the request completed and the user argument is free, -1 if it is still pending
+ */
+int rest_async_wait(rest_async_req_t* req, uint32_t wait_ms, int* ret);
+
+/**
+ * @brief Cancel a request
+ *
+ * A queued request is not run, a running one completes its network operation in the background and its result is
+ * discarded. Either way the request still completes with REST_ASYNC_ERR_CANCELLED once a worker is finished with it,
+ * only then the user argument may be freed.
+ *
+ * @param[in] req The request
+ * @return int 0 if the request was cancelled, -1 if it has already completed
+ */
+int rest_async_cancel(rest_async_req_t* req);
+
+/**
+ * @brief Check if a request has completed
+ *
+ * @param[in] req The request
+ * @return true The result was delivered and the user argument is free
+ */
+bool rest_async_done(rest_async_req_t const* req);
+
+/**
+ * @brief Release the caller reference of a request
+ *
+ * The request is freed once it has also been completed or dropped by the worker. The user argument is not touched.
+ *
+ * @param[in] req The request
+ */
+void rest_async_release(rest_async_req_t* req);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,105 @@
+// Copyright 2022 IOTA Stiftung
+// SPDX-License-Identifier: Apache-2.0
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "sdkconfig.h"
+
+#include "client/api/restful/get_tips.h"
+#include "client/api/restful/send_block_binary.h"
+#include "client/api/restful/tip_pool.h"
+#include "client/network/http_request.h"
+#include "core/models/block_binary.h"
+
+#define BLOCKS_PATH "/api/core/v2/blocks"
+
+static int add_tips(iota_client_conf_t const* const conf, core_block_t* blk) {
+  // prefetched tips save a round trip to the node
+  byte_t parents[BLOCK_MAX_PARENTS][IOTA_BLOCK_ID_BYTES];
+  size_t parents_len = tip_pool_take(parents, BLOCK_MAX_PARENTS);
+  if (parents_len > 0) {
+    for (size_t i = 0; i < parents_len; i++) {
+      core_block_add_parent(blk, parents[i]);
+    }
+    return 0;
+  }
+
+  res_tips_t* tips = res_tips_new();
+  if (tips == NULL) {
+    printf("[%s:%d] OOM\n", __func__, __LINE__);
+    return -1;
+  }
+
+  int ret = get_tips(conf, tips);
+  if (ret == 0 && tips->is_error) {
+    printf("[%s:%d] %s\n", __func__, __LINE__, tips->u.error->msg);
+    ret = -1;
+  }
+  byte_t tip[IOTA_BLOCK_ID_BYTES] = {};
+  for (size_t i = 0; ret == 0 && i < get_tips_id_count(tips) && i < BLOCK_MAX_PARENTS; i++) {
+    char const* tip_str = get_tips_id(tips, i);
+    if ((ret = hex_2_bin(tip_str, strlen(tip_str), "0x", tip, sizeof(tip))) == 0) {
+      core_block_add_parent(blk, tip);
+    }
+  }
+  res_tips_free(tips);
+  return ret;
+}
+
+int send_core_block_binary(iota_client_conf_t const* const conf, core_block_t* blk, res_send_block_t* res) {
+  if (conf == NULL || blk == NULL || res == NULL) {
+    printf("[%s:%d] invalid parameters\n", __func__, __LINE__);
+    return -1;
+  }
+
+  if (core_block_get_parents_len(blk) == 0 && add_tips(conf, blk) != 0) {
+    printf("[%s:%d] get tips failed\n", __func__, __LINE__);
+    return -1;
+  }
+
+  size_t blk_len = core_block_serialize_len(blk);
+  byte_t* blk_buf = malloc(blk_len);
+  byte_buf_t* http_res = byte_buf_new();
+  int ret = -1;
+  if (blk_buf == NULL || http_res == NULL) {
+    printf("[%s:%d] OOM\n", __func__, __LINE__);
+    goto end;
+  }
+  if (core_block_serialize(blk, blk_buf, blk_len) != blk_len) {
+    printf("[%s:%d] serialize block failed\n", __func__, __LINE__);
+    goto end;
+  }
+
+  // the request body points to the serialized block, no copy is made
+  byte_buf_t http_req = {.data = blk_buf, .len = blk_len, .cap = blk_len};
+  http_client_config_t http_conf = {
+      .host = conf->host, .path = BLOCKS_PATH, .use_tls = conf->use_tls, .port = conf->port};
+  http_request_opts_t opts = {.content_type = IOTA_BINARY_MEDIA_TYPE};
+  long st = 0;
+  if ((ret = http_client_post_ex(&http_conf, &opts, &http_req, http_res, &st)) != 0) {
+    goto end;
+  }
+
+  // the block ID and error responses are JSON
+  if (!byte_buf2str(http_res)) {
+    ret = -1;
+    goto end;
+  }
+  if ((ret = deser_send_block_response((char const*)http_res->data, res)) != 0) {
+    printf("[%s:%d] HTTP status %ld\n", __func__, __LINE__, st);
+  }
+
+end:
+  free(blk_buf);
+  byte_buf_free(http_res);
+  return ret;
+}
+
+#if CONFIG_IOTA_SEND_BLOCK_BINARY
+// send_core_block() is wrapped at link time, see CMakeLists.txt
+int __wrap_send_core_block(iota_client_conf_t const* const conf, core_block_t* blk, res_send_block_t* res) {
+  return send_core_block_binary(conf, blk, res);
+}
+#endif
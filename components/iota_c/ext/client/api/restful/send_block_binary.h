@@ -0,0 +1,33 @@
+// Copyright 2022 IOTA Stiftung
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef __CLIENT_API_RESTFUL_SEND_BLOCK_BINARY_H__
+#define __CLIENT_API_RESTFUL_SEND_BLOCK_BINARY_H__
+
+#include "client/api/restful/send_block.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Send a block in its binary form
+ *
+ * Same as send_core_block() but the block is serialized into a single buffer and posted with the binary media type,
+ * no JSON tree or string is created. Parents are taken from the tip pool or the node tips if the block has none.
+ *
+ * With CONFIG_IOTA_SEND_BLOCK_BINARY all calls to send_core_block(), including the ones of the wallet and
+ * send_tagged_data_block(), are routed here.
+ *
+ * @param[in] conf The client endpoint configuration
+ * @param[in] blk A block object
+ * @param[out] res The block ID or the error response of the node
+ * @return int 0 on success
+ */
+int send_core_block_binary(iota_client_conf_t const* const conf, core_block_t* blk, res_send_block_t* res);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,219 @@
+// Copyright 2022 IOTA Stiftung
+// SPDX-License-Identifier: Apache-2.0
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "uthash.h"
+
+#include "client/api/restful/single_flight.h"
+
+typedef struct {
+  char* key;                    ///< the node, the kind and the argument of the call
+  void* res;                    ///< the shared result, NULL until the call succeeded
+  int ret;                      ///< the return value of the call
+  single_flight_free free_res;  ///< frees the result
+  uint32_t refs;                ///< the callers holding the flight
+  SemaphoreHandle_t done;       ///< given when the call completed, every waiter gives it back
+  UT_hash_handle hh;            ///< the calls in flight by key
+  UT_hash_handle hh_res;        ///< the shared results by address
+} flight_t;
+
+static flight_t* calls = NULL;
+static flight_t* results = NULL;
+static single_flight_stats_t flight_stats = {};
+// guards the tables, the references and the counters
+static SemaphoreHandle_t flight_lock = NULL;
+
+static bool flight_init() {
+  if (flight_lock == NULL) {
+    flight_lock = xSemaphoreCreateMutex();
+  }
+  return flight_lock != NULL;
+}
+
+static void flight_free(flight_t* f) {
+  if (f->res) {
+    f->free_res(f->res);
+  }
+  if (f->done) {
+    vSemaphoreDelete(f->done);
+  }
+  free(f->key);
+  free(f);
+}
+
+// drops a reference, returns the flight if it has to be freed outside of the lock
+static flight_t* flight_unref(flight_t* f) {
+  if (--f->refs > 0) {
+    return NULL;
+  }
+  if (f->res) {
+    HASH_DELETE(hh_res, results, f);
+    flight_stats.results--;
+  }
+  return f;
+}
+
+static flight_t* flight_new(iota_client_conf_t const* conf, char const kind[], char const arg[],
+                            single_flight_free free_res) {
+  flight_t* f = calloc(1, sizeof(flight_t));
+  if (f == NULL) {
+    return NULL;
+  }
+  size_t key_len = strlen(conf->host) + strlen(kind) + strlen(arg) + 10;
+  f->key = malloc(key_len);
+  f->done = xSemaphoreCreateBinary();
+  if (f->key == NULL || f->done == NULL) {
+    flight_free(f);
+    return NULL;
+  }
+  snprintf(f->key, key_len, "%s:%u/%s/%s", conf->host, conf->port, kind, arg);
+  f->free_res = free_res;
+  f->refs = 1;
+  return f;
+}
+
+int single_flight_do(iota_client_conf_t const* conf, char const kind[], char const arg[], single_flight_fetch fetch,
+                     void* ctx, single_flight_free free_res, void** res) {
+  if (conf == NULL || kind == NULL || arg == NULL || fetch == NULL || free_res == NULL || res == NULL) {
+    printf("[%s:%d] invalid parameters\n", __func__, __LINE__);
+    return -1;
+  }
+  *res = NULL;
+  if (!flight_init()) {
+    printf("[%s:%d] OOM\n", __func__, __LINE__);
+    return -1;
+  }
+  flight_t* f = flight_new(conf, kind, arg, free_res);
+  if (f == NULL) {
+    printf("[%s:%d] OOM\n", __func__, __LINE__);
+    return -1;
+  }
+
+  xSemaphoreTake(flight_lock, portMAX_DELAY);
+  flight_t* in_flight = NULL;
+  HASH_FIND_STR(calls, f->key, in_flight);
+  if (in_flight) {
+    in_flight->refs++;
+    flight_stats.joined++;
+  } else {
+    HASH_ADD_KEYPTR(hh, calls, f->key, strlen(f->key), f);
+    flight_stats.calls++;
+  }
+  xSemaphoreGive(flight_lock);
+
+  if (in_flight) {
+    flight_free(f);
+    f = in_flight;
+    // pass the completion on to the next waiter
+    xSemaphoreTake(f->done, portMAX_DELAY);
+    xSemaphoreGive(f->done);
+  } else {
+    void* fetched = NULL;
+    int ret = fetch(conf, arg, ctx, &fetched);
+    xSemaphoreTake(flight_lock, portMAX_DELAY);
+    // later calls send a new request
+    HASH_DEL(calls, f);
+    if (ret == 0 && fetched) {
+      f->res = fetched;
+      HASH_ADD(hh_res, results, res, sizeof(void*), f);
+      flight_stats.results++;
+    } else {
+      f->ret = ret ? ret : -1;
+      if (fetched) {
+        free_res(fetched);
+      }
+    }
+    xSemaphoreGive(flight_lock);
+    xSemaphoreGive(f->done);
+  }
+
+  // the result and the return value do not change once the call completed
+  int ret = f->ret;
+  if (ret == 0) {
+    *res = f->res;
+    return 0;
+  }
+  xSemaphoreTake(flight_lock, portMAX_DELAY);
+  flight_t* unused = flight_unref(f);
+  xSemaphoreGive(flight_lock);
+  if (unused) {
+    flight_free(unused);
+  }
+  return ret;
+}
+
+void single_flight_release(void const* res) {
+  if (res == NULL || flight_lock == NULL) {
+    return;
+  }
+  xSemaphoreTake(flight_lock, portMAX_DELAY);
+  flight_t* f = NULL;
+  HASH_FIND(hh_res, results, &res, sizeof(void*), f);
+  flight_t* unused = f ? flight_unref(f) : NULL;
+  xSemaphoreGive(flight_lock);
+  if (f == NULL) {
+    printf("[%s:%d] unknown result\n", __func__, __LINE__);
+  } else if (unused) {
+    flight_free(unused);
+  }
+}
+
+static int fetch_output(iota_client_conf_t const* conf, char const arg[], void* ctx, void** res) {
+  res_output_t* output = get_output_response_new();
+  if (output == NULL) {
+    printf("[%s:%d] OOM\n", __func__, __LINE__);
+    return -1;
+  }
+  int ret = get_output(conf, arg, output);
+  if (ret != 0) {
+    get_output_response_free(output);
+    return ret;
+  }
+  *res = output;
+  return 0;
+}
+
+static void free_output(void* res) { get_output_response_free((res_output_t*)res); }
+
+int get_output_shared(iota_client_conf_t const* conf, char const output_id[], res_output_t** res) {
+  return single_flight_do(conf, "output", output_id, fetch_output, NULL, free_output, (void**)res);
+}
+
+static int fetch_block_meta(iota_client_conf_t const* conf, char const arg[], void* ctx, void** res) {
+  res_block_meta_t* meta = block_meta_new();
+  if (meta == NULL) {
+    printf("[%s:%d] OOM\n", __func__, __LINE__);
+    return -1;
+  }
+  int ret = get_block_metadata(conf, arg, meta);
+  if (ret != 0) {
+    block_meta_free(meta);
+    return ret;
+  }
+  *res = meta;
+  return 0;
+}
+
+static void free_block_meta(void* res) { block_meta_free((res_block_meta_t*)res); }
+
+int get_block_metadata_shared(iota_client_conf_t const* conf, char const blk_id[], res_block_meta_t** res) {
+  return single_flight_do(conf, "metadata", blk_id, fetch_block_meta, NULL, free_block_meta, (void**)res);
+}
+
+void single_flight_get_stats(single_flight_stats_t* stats) {
+  if (stats == NULL) {
+    return;
+  }
+  memset(stats, 0, sizeof(single_flight_stats_t));
+  if (!flight_init()) {
+    return;
+  }
+  xSemaphoreTake(flight_lock, portMAX_DELAY);
+  *stats = flight_stats;
+  xSemaphoreGive(flight_lock);
+}
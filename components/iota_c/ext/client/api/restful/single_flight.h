@@ -0,0 +1,102 @@
+// Copyright 2022 IOTA Stiftung
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef __CLIENT_API_RESTFUL_SINGLE_FLIGHT_H__
+#define __CLIENT_API_RESTFUL_SINGLE_FLIGHT_H__
+
+#include <stdint.h>
+
+#include "client/api/restful/get_block_metadata.h"
+#include "client/api/restful/get_output.h"
+#include "client/client_service.h"
+
+/**
+ * @brief Makes a call whose result is shared
+ *
+ * @param[in] conf The client endpoint configuration
+ * @param[in] arg The argument of the call, e.g. an output ID
+ * @param[in] ctx The context passed to single_flight_do() by the caller that makes the call
+ * @param[out] res The parsed result, also set for error responses of the node
+ * @return int 0 on success
+ */
+typedef int (*single_flight_fetch)(iota_client_conf_t const* conf, char const arg[], void* ctx, void** res);
+
+/**
+ * @brief Frees a result of single_flight_fetch
+ *
+ * @param[in] res The result
+ */
+typedef void (*single_flight_free)(void* res);
+
+/**
+ * @brief Counters of the coalesced calls
+ *
+ */
+typedef struct {
+  uint32_t calls;    ///< calls sent to the node
+  uint32_t joined;   ///< calls that waited for an identical call in flight instead
+  uint32_t results;  ///< results still held by callers
+} single_flight_stats_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Make a call or join an identical one in flight
+ *
+ * Calls with the same node, kind and argument that overlap send one request and share one parsed result. The result is
+ * reference counted, it must not be modified and every caller releases it with single_flight_release(). Results are
+ * not kept once the last caller released them, a later call sends a new request.
+ *
+ * @param[in] conf The client endpoint configuration
+ * @param[in] kind The name of the call, calls of different kinds are never shared
+ * @param[in] arg The argument of the call
+ * @param[in] fetch The function that makes the call
+ * @param[in] ctx The context of the fetch function, only used if this caller makes the call
+ * @param[in] free_res The function that frees the result
+ * @param[out] res The shared result
+ * @return int The return value of the fetch function, res is only set on 0
+ */
+int single_flight_do(iota_client_conf_t const* conf, char const kind[], char const arg[], single_flight_fetch fetch,
+                     void* ctx, single_flight_free free_res, void** res);
+
+/**
+ * @brief Release a shared result, it is freed with the last reference
+ *
+ * @param[in] res The result of single_flight_do() or of a shared getter
+ */
+void single_flight_release(void const* res);
+
+/**
+ * @brief Get an output, sharing the request and the result with identical calls in flight
+ *
+ * @param[in] conf The client endpoint configuration
+ * @param[in] output_id The output ID in hex string format
+ * @param[out] res The shared output response, release it with single_flight_release()
+ * @return int 0 on success
+ */
+int get_output_shared(iota_client_conf_t const* conf, char const output_id[], res_output_t** res);
+
+/**
+ * @brief Get block metadata, sharing the request and the result with identical calls in flight
+ *
+ * @param[in] conf The client endpoint configuration
+ * @param[in] blk_id The block ID in hex string format
+ * @param[out] res The shared metadata response, release it with single_flight_release()
+ * @return int 0 on success
+ */
+int get_block_metadata_shared(iota_client_conf_t const* conf, char const blk_id[], res_block_meta_t** res);
+
+/**
+ * @brief Get a snapshot of the counters
+ *
+ * @param[out] stats The counters
+ */
+void single_flight_get_stats(single_flight_stats_t* stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
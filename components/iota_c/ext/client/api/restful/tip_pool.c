@@ -0,0 +1,190 @@
+// Copyright 2022 IOTA Stiftung
+// SPDX-License-Identifier: Apache-2.0
+
+#include <stdio.h>
+#include <string.h>
+
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "freertos/task.h"
+#include "sdkconfig.h"
+
+#include "client/api/restful/get_tips.h"
+#include "client/api/restful/tip_pool.h"
+#include "core/utils/byte_buffer.h"
+
+static struct {
+  iota_client_conf_t conf;                              ///< the node the tips are fetched from
+  uint32_t interval_ms;                                 ///< the time between refreshes
+  uint32_t max_age_ms;                                  ///< the maximum age of handed out tips
+  bool running;                                         ///< the task keeps refreshing while set
+  TaskHandle_t task;                                    ///< the refresh task
+  byte_t tips[BLOCK_MAX_PARENTS][IOTA_BLOCK_ID_BYTES];  ///< the tips of the last refresh
+  size_t tips_len;                                      ///< the number of tips
+  int64_t fetched_at;                                   ///< the time of the last refresh in microseconds
+  tip_pool_stats_t stats;                               ///< the counters
+} pool = {};
+// guards the pool, the HTTP request of a refresh is made without it
+static SemaphoreHandle_t pool_lock = NULL;
+
+static bool pool_init() {
+  if (pool_lock == NULL) {
+    pool_lock = xSemaphoreCreateMutex();
+  }
+  return pool_lock != NULL;
+}
+
+static int fetch_tips(iota_client_conf_t const* conf, byte_t tips[][IOTA_BLOCK_ID_BYTES], size_t* len) {
+  res_tips_t* res = res_tips_new();
+  if (res == NULL) {
+    printf("[%s:%d] OOM\n", __func__, __LINE__);
+    return -1;
+  }
+
+  int ret = get_tips(conf, res);
+  if (ret == 0 && res->is_error) {
+    printf("[%s:%d] %s\n", __func__, __LINE__, res->u.error->msg);
+    ret = -1;
+  }
+  *len = 0;
+  for (size_t i = 0; ret == 0 && i < get_tips_id_count(res) && i < BLOCK_MAX_PARENTS; i++) {
+    char const* tip_str = get_tips_id(res, i);
+    if ((ret = hex_2_bin(tip_str, strlen(tip_str), "0x", tips[i], IOTA_BLOCK_ID_BYTES)) == 0) {
+      (*len)++;
+    }
+  }
+  res_tips_free(res);
+  return ret == 0 && *len > 0 ? 0 : -1;
+}
+
+static void tip_pool_task(void* arg) {
+  iota_client_conf_t conf;
+  byte_t tips[BLOCK_MAX_PARENTS][IOTA_BLOCK_ID_BYTES];
+  size_t tips_len = 0;
+  for (;;) {
+    xSemaphoreTake(pool_lock, portMAX_DELAY);
+    if (!pool.running) {
+      pool.task = NULL;
+      pool.tips_len = 0;
+      xSemaphoreGive(pool_lock);
+      vTaskDelete(NULL);
+      return;
+    }
+    memcpy(&conf, &pool.conf, sizeof(conf));
+    xSemaphoreGive(pool_lock);
+
+    int ret = fetch_tips(&conf, tips, &tips_len);
+
+    xSemaphoreTake(pool_lock, portMAX_DELAY);
+    if (ret == 0) {
+      memcpy(pool.tips, tips, sizeof(tips));
+      pool.tips_len = tips_len;
+      pool.fetched_at = esp_timer_get_time();
+      pool.stats.refreshes++;
+    } else {
+      pool.stats.failures++;
+    }
+    uint32_t interval_ms = pool.interval_ms;
+    xSemaphoreGive(pool_lock);
+
+    // woken up early by tip_pool_refresh(), tip_pool_take() and tip_pool_stop()
+    ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(interval_ms));
+  }
+}
+
+int tip_pool_start(iota_client_conf_t const* conf, uint32_t interval_ms, uint32_t max_age_ms) {
+  if (conf == NULL || interval_ms == 0 || max_age_ms == 0) {
+    printf("[%s:%d] invalid parameters\n", __func__, __LINE__);
+    return -1;
+  }
+  if (!pool_init()) {
+    printf("[%s:%d] OOM\n", __func__, __LINE__);
+    return -1;
+  }
+
+  int ret = 0;
+  xSemaphoreTake(pool_lock, portMAX_DELAY);
+  memcpy(&pool.conf, conf, sizeof(iota_client_conf_t));
+  pool.interval_ms = interval_ms;
+  pool.max_age_ms = max_age_ms;
+  pool.running = true;
+  if (pool.task == NULL) {
+    if (xTaskCreate(tip_pool_task, "tip_pool", CONFIG_IOTA_CLIENT_TASK_STACK_SIZE, NULL, tskIDLE_PRIORITY + 3,
+                    &pool.task) != pdPASS) {
+      printf("[%s:%d] create tip pool task failed\n", __func__, __LINE__);
+      pool.running = false;
+      pool.task = NULL;
+      ret = -1;
+    }
+  } else {
+    // already running, the new settings apply from the next refresh
+    xTaskNotifyGive(pool.task);
+  }
+  xSemaphoreGive(pool_lock);
+  return ret;
+}
+
+void tip_pool_stop() {
+  if (pool_lock == NULL) {
+    return;
+  }
+  xSemaphoreTake(pool_lock, portMAX_DELAY);
+  pool.running = false;
+  pool.tips_len = 0;
+  if (pool.task) {
+    xTaskNotifyGive(pool.task);
+  }
+  xSemaphoreGive(pool_lock);
+}
+
+void tip_pool_refresh() {
+  if (pool_lock == NULL) {
+    return;
+  }
+  xSemaphoreTake(pool_lock, portMAX_DELAY);
+  if (pool.running && pool.task) {
+    xTaskNotifyGive(pool.task);
+  }
+  xSemaphoreGive(pool_lock);
+}
+
+size_t tip_pool_take(byte_t parents[][IOTA_BLOCK_ID_BYTES], size_t max) {
+  if (parents == NULL || max == 0 || pool_lock == NULL) {
+    return 0;
+  }
+
+  size_t len = 0;
+  xSemaphoreTake(pool_lock, portMAX_DELAY);
+  if (pool.running) {
+    int64_t age_us = esp_timer_get_time() - pool.fetched_at;
+    if (pool.tips_len > 0 && age_us <= (int64_t)pool.max_age_ms * 1000) {
+      len = pool.tips_len < max ? pool.tips_len : max;
+      memcpy(parents, pool.tips, len * IOTA_BLOCK_ID_BYTES);
+      pool.stats.hits++;
+    } else {
+      pool.stats.misses++;
+    }
+    // the next block should not approve the same tips, fetch new ones
+    if (pool.task) {
+      xTaskNotifyGive(pool.task);
+    }
+  }
+  xSemaphoreGive(pool_lock);
+  return len;
+}
+
+void tip_pool_get_stats(tip_pool_stats_t* stats) {
+  if (stats == NULL) {
+    return;
+  }
+  memset(stats, 0, sizeof(tip_pool_stats_t));
+  if (pool_lock == NULL) {
+    return;
+  }
+  xSemaphoreTake(pool_lock, portMAX_DELAY);
+  *stats = pool.stats;
+  stats->tips = pool.tips_len;
+  stats->age_ms = pool.tips_len ? (esp_timer_get_time() - pool.fetched_at) / 1000 : 0;
+  xSemaphoreGive(pool_lock);
+}
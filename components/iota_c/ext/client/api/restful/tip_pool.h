@@ -0,0 +1,77 @@
+// Copyright 2022 IOTA Stiftung
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef __CLIENT_API_RESTFUL_TIP_POOL_H__
+#define __CLIENT_API_RESTFUL_TIP_POOL_H__
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "client/client_service.h"
+#include "core/models/block.h"
+
+/**
+ * @brief Counters of the tip pool
+ *
+ */
+typedef struct {
+  uint32_t refreshes;  ///< successful refreshes
+  uint32_t failures;   ///< failed refreshes
+  uint32_t hits;       ///< blocks that got their parents from the pool
+  uint32_t misses;     ///< blocks that found no fresh tips in the pool
+  uint32_t tips;       ///< tips in the pool
+  uint32_t age_ms;     ///< the time since the last refresh, 0 if there are no tips
+} tip_pool_stats_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Keep a pool of tips refreshed by a background task
+ *
+ * The tips are fetched from the node every interval, when tip_pool_refresh() is called and after they were handed
+ * out, so that the parents of a block are available without a request to the node. Starting a running pool changes
+ * its settings.
+ *
+ * @param[in] conf The client endpoint configuration, it is copied
+ * @param[in] interval_ms The time between refreshes
+ * @param[in] max_age_ms Tips older than this are not handed out
+ * @return int 0 on success
+ */
+int tip_pool_start(iota_client_conf_t const* conf, uint32_t interval_ms, uint32_t max_age_ms);
+
+/**
+ * @brief Stop the background task and drop the tips
+ *
+ */
+void tip_pool_stop();
+
+/**
+ * @brief Refresh the tips now, e.g. when a new milestone was issued
+ *
+ * It does not wait for the refresh and does nothing if the pool is not running.
+ */
+void tip_pool_refresh();
+
+/**
+ * @brief Take the tips of the pool as parents of a block
+ *
+ * @param[out] parents A buffer of max block IDs
+ * @param[in] max The maximum number of parents, e.g. BLOCK_MAX_PARENTS
+ * @return size_t The number of parents, 0 if the pool has no tips younger than the maximum age
+ */
+size_t tip_pool_take(byte_t parents[][IOTA_BLOCK_ID_BYTES], size_t max);
+
+/**
+ * @brief Get a snapshot of the pool counters
+ *
+ * @param[out] stats The counters
+ */
+void tip_pool_get_stats(tip_pool_stats_t* stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
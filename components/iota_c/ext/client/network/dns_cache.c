@@ -0,0 +1,275 @@
+// Copyright 2022 IOTA Stiftung
+// SPDX-License-Identifier: Apache-2.0
+
+#include <arpa/inet.h>
+#include <netdb.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/socket.h>
+
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "freertos/task.h"
+#include "sdkconfig.h"
+
+#include "client/network/dns_cache.h"
+
+#define DNS_CACHE_TTL_US ((int64_t)CONFIG_IOTA_DNS_CACHE_TTL_S * 1000000)
+#define DNS_CACHE_MAX_STALE_US ((int64_t)CONFIG_IOTA_DNS_CACHE_MAX_STALE_S * 1000000)
+// entries used after this part of their lifetime are refreshed in the background
+#define DNS_CACHE_REFRESH_AFTER_US (DNS_CACHE_TTL_US / 5 * 4)
+
+#define DNS_CACHE_LEN 8
+#define DNS_CACHE_HOST_MAX_LEN 128
+
+typedef struct {
+  char host[DNS_CACHE_HOST_MAX_LEN];  ///< the host name, empty if the slot is free
+  char ip[DNS_CACHE_IP_LEN];          ///< the last resolved address
+  int64_t resolved_at;                ///< the time the address was resolved, in microseconds
+  int64_t last_used;                  ///< the time of the last lookup, in microseconds
+  bool refreshing;                    ///< the host is resolved again by the refresh task
+} dns_entry_t;
+
+static const char* TAG = "dns_cache";
+
+static dns_entry_t dns_table[DNS_CACHE_LEN];
+static dns_cache_stats_t dns_stats;
+// guards the table and the counters
+static SemaphoreHandle_t dns_lock = NULL;
+static TaskHandle_t dns_task = NULL;
+
+static bool dns_init() {
+  if (dns_lock == NULL) {
+    dns_lock = xSemaphoreCreateMutex();
+  }
+  return dns_lock != NULL;
+}
+
+// resolves without the cache, the resolver of lwIP keeps records only for their TTL
+static bool dns_resolve(char const* host, char ip[DNS_CACHE_IP_LEN]) {
+  struct addrinfo hints = {.ai_family = AF_UNSPEC, .ai_socktype = SOCK_STREAM};
+  struct addrinfo* res = NULL;
+  if (getaddrinfo(host, NULL, &hints, &res) != 0 || res == NULL) {
+    return false;
+  }
+  void const* addr = &((struct sockaddr_in*)res->ai_addr)->sin_addr;
+#if CONFIG_LWIP_IPV6
+  if (res->ai_family == AF_INET6) {
+    addr = &((struct sockaddr_in6*)res->ai_addr)->sin6_addr;
+  }
+#endif
+  bool ok = inet_ntop(res->ai_family, addr, ip, DNS_CACHE_IP_LEN) != NULL;
+  freeaddrinfo(res);
+  return ok;
+}
+
+static bool is_ip_literal(char const* host) {
+  uint8_t addr[16];
+  return inet_pton(AF_INET, host, addr) == 1
+#if CONFIG_LWIP_IPV6
+         || inet_pton(AF_INET6, host, addr) == 1
+#endif
+      ;
+}
+
+// must be called with dns_lock held
+static dns_entry_t* dns_find(char const* host) {
+  for (size_t i = 0; i < DNS_CACHE_LEN; i++) {
+    if (strcmp(dns_table[i].host, host) == 0) {
+      return &dns_table[i];
+    }
+  }
+  return NULL;
+}
+
+// must be called with dns_lock held, takes a free slot or the least recently used one
+static dns_entry_t* dns_slot(char const* host) {
+  dns_entry_t* slot = &dns_table[0];
+  for (size_t i = 0; i < DNS_CACHE_LEN; i++) {
+    if (dns_table[i].host[0] == '\0') {
+      slot = &dns_table[i];
+      break;
+    }
+    if (dns_table[i].last_used < slot->last_used) {
+      slot = &dns_table[i];
+    }
+  }
+  memset(slot, 0, sizeof(dns_entry_t));
+  strcpy(slot->host, host);
+  return slot;
+}
+
+static void dns_refresh_task(void* arg) {
+  for (;;) {
+    ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    for (;;) {
+      char host[DNS_CACHE_HOST_MAX_LEN] = {};
+      xSemaphoreTake(dns_lock, portMAX_DELAY);
+      for (size_t i = 0; i < DNS_CACHE_LEN; i++) {
+        if (dns_table[i].refreshing) {
+          strcpy(host, dns_table[i].host);
+          break;
+        }
+      }
+      xSemaphoreGive(dns_lock);
+      if (host[0] == '\0') {
+        break;
+      }
+
+      char ip[DNS_CACHE_IP_LEN];
+      bool ok = dns_resolve(host, ip);
+      xSemaphoreTake(dns_lock, portMAX_DELAY);
+      dns_entry_t* e = dns_find(host);
+      if (e) {
+        e->refreshing = false;
+        if (ok) {
+          strcpy(e->ip, ip);
+          e->resolved_at = esp_timer_get_time();
+          dns_stats.refreshes++;
+        }
+      }
+      if (!ok) {
+        // the entry is resolved by the next lookup after it expired, and used stale if that fails too
+        dns_stats.failures++;
+      }
+      xSemaphoreGive(dns_lock);
+      if (!ok) {
+        ESP_LOGW(TAG, "refresh %s failed", host);
+      }
+    }
+  }
+}
+
+// queues the background refresh of an entry, must be called with dns_lock held
+static bool dns_refresh(dns_entry_t* e) {
+  if (dns_task == NULL && xTaskCreate(dns_refresh_task, "dns_refresh", CONFIG_IOTA_CLIENT_TASK_STACK_SIZE, NULL,
+                                      tskIDLE_PRIORITY + 2, &dns_task) != pdPASS) {
+    dns_task = NULL;
+    return false;
+  }
+  e->refreshing = true;
+  return true;
+}
+
+static int dns_copy(char ip[], size_t ip_len, char const* addr) {
+  if (strlen(addr) >= ip_len) {
+    ESP_LOGE(TAG, "address buffer too small");
+    return -1;
+  }
+  strcpy(ip, addr);
+  return 0;
+}
+
+int dns_cache_resolve(char const* host, char ip[], size_t ip_len) {
+  if (host == NULL || host[0] == '\0' || ip == NULL || ip_len == 0) {
+    ESP_LOGE(TAG, "invalid parameters");
+    return -1;
+  }
+  if (is_ip_literal(host)) {
+    return dns_copy(ip, ip_len, host);
+  }
+  char resolved[DNS_CACHE_IP_LEN];
+  if (DNS_CACHE_TTL_US == 0 || strlen(host) >= DNS_CACHE_HOST_MAX_LEN || !dns_init()) {
+    if (!dns_resolve(host, resolved)) {
+      ESP_LOGE(TAG, "resolve %s failed", host);
+      return -1;
+    }
+    return dns_copy(ip, ip_len, resolved);
+  }
+
+  xSemaphoreTake(dns_lock, portMAX_DELAY);
+  int64_t now = esp_timer_get_time();
+  dns_entry_t* e = dns_find(host);
+  if (e && now - e->resolved_at < DNS_CACHE_TTL_US) {
+    dns_stats.hits++;
+    e->last_used = now;
+    bool refresh = now - e->resolved_at >= DNS_CACHE_REFRESH_AFTER_US && !e->refreshing && dns_refresh(e);
+    int ret = dns_copy(ip, ip_len, e->ip);
+    xSemaphoreGive(dns_lock);
+    if (refresh) {
+      xTaskNotifyGive(dns_task);
+    }
+    return ret;
+  }
+  xSemaphoreGive(dns_lock);
+
+  // resolved without the lock, lookups of other hosts are not held up
+  bool ok = dns_resolve(host, resolved);
+  int ret = -1;
+  xSemaphoreTake(dns_lock, portMAX_DELAY);
+  now = esp_timer_get_time();
+  e = dns_find(host);
+  if (ok) {
+    dns_stats.misses++;
+    e = e ? e : dns_slot(host);
+    strcpy(e->ip, resolved);
+    e->resolved_at = now;
+    e->last_used = now;
+    ret = dns_copy(ip, ip_len, e->ip);
+  } else {
+    dns_stats.failures++;
+    if (e && now - e->resolved_at < DNS_CACHE_TTL_US + DNS_CACHE_MAX_STALE_US) {
+      dns_stats.stale++;
+      e->last_used = now;
+      ret = dns_copy(ip, ip_len, e->ip);
+    }
+  }
+  xSemaphoreGive(dns_lock);
+  if (!ok) {
+    ESP_LOGW(TAG, "resolve %s failed%s", host, ret == 0 ? ", using the expired address" : "");
+  }
+  return ret;
+}
+
+void dns_cache_expire(char const* host) {
+  if (host == NULL || !dns_init()) {
+    return;
+  }
+  xSemaphoreTake(dns_lock, portMAX_DELAY);
+  dns_entry_t* e = dns_find(host);
+  int64_t expired = esp_timer_get_time() - DNS_CACHE_TTL_US;
+  if (e && e->resolved_at > expired) {
+    e->resolved_at = expired;
+  }
+  xSemaphoreGive(dns_lock);
+}
+
+void dns_cache_flush() {
+  if (dns_init()) {
+    xSemaphoreTake(dns_lock, portMAX_DELAY);
+    for (size_t i = 0; i < DNS_CACHE_LEN; i++) {
+      // an entry being refreshed is dropped once the refresh task finds it gone
+      memset(&dns_table[i], 0, sizeof(dns_entry_t));
+    }
+    xSemaphoreGive(dns_lock);
+  }
+}
+
+void dns_cache_get_stats(dns_cache_stats_t* stats) {
+  if (stats == NULL) {
+    return;
+  }
+  memset(stats, 0, sizeof(dns_cache_stats_t));
+  if (!dns_init()) {
+    return;
+  }
+  xSemaphoreTake(dns_lock, portMAX_DELAY);
+  *stats = dns_stats;
+  stats->entries = 0;
+  for (size_t i = 0; i < DNS_CACHE_LEN; i++) {
+    stats->entries += dns_table[i].host[0] ? 1 : 0;
+  }
+  xSemaphoreGive(dns_lock);
+}
+
+void dns_cache_reset_stats() {
+  if (dns_init()) {
+    xSemaphoreTake(dns_lock, portMAX_DELAY);
+    memset(&dns_stats, 0, sizeof(dns_stats));
+    xSemaphoreGive(dns_lock);
+  }
+}
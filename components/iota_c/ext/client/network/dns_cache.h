@@ -0,0 +1,76 @@
+// Copyright 2022 IOTA Stiftung
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef __CLIENT_NETWORK_DNS_CACHE_H__
+#define __CLIENT_NETWORK_DNS_CACHE_H__
+
+#include <stddef.h>
+#include <stdint.h>
+
+// the buffer length of a resolved address, fits IPv6 addresses
+#define DNS_CACHE_IP_LEN 46
+
+/**
+ * @brief Counters of the DNS cache
+ *
+ */
+typedef struct {
+  uint32_t hits;       ///< lookups answered by a fresh entry
+  uint32_t misses;     ///< lookups that resolved the host name
+  uint32_t refreshes;  ///< entries resolved again in the background before they expired
+  uint32_t stale;      ///< lookups answered by an expired entry because resolving failed
+  uint32_t failures;   ///< failed resolutions, including background refreshes
+  uint8_t entries;     ///< host names in the cache
+} dns_cache_stats_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Resolve a host name to an address, from the cache if possible
+ *
+ * Addresses are kept for CONFIG_IOTA_DNS_CACHE_TTL_S. An entry used in the last fifth of its lifetime is resolved
+ * again in the background, so hosts in regular use are never resolved by the caller. If resolving fails, an expired
+ * entry is used for up to CONFIG_IOTA_DNS_CACHE_MAX_STALE_S. IP literals are returned as they are.
+ *
+ * @param[in] host The host name
+ * @param[out] ip The address as a string, e.g. for esp_tls or an MQTT client
+ * @param[in] ip_len The length of the buffer, DNS_CACHE_IP_LEN fits every address
+ * @return int 0 on success
+ */
+int dns_cache_resolve(char const* host, char ip[], size_t ip_len);
+
+/**
+ * @brief Expire the entry of a host, e.g. after a connection to its address failed
+ *
+ * The next lookup resolves the host name again, the expired address is still used if that fails.
+ *
+ * @param[in] host The host name
+ */
+void dns_cache_expire(char const* host);
+
+/**
+ * @brief Remove all entries
+ *
+ */
+void dns_cache_flush();
+
+/**
+ * @brief Get a snapshot of the counters
+ *
+ * @param[out] stats The counters
+ */
+void dns_cache_get_stats(dns_cache_stats_t* stats);
+
+/**
+ * @brief Reset the counters
+ *
+ */
+void dns_cache_reset_stats();
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,678 @@
+// Copyright 2022 IOTA Stiftung
+// SPDX-License-Identifier: Apache-2.0
+
+#include <errno.h>
+#include <fcntl.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/select.h>
+
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "esp_tls.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "freertos/task.h"
+#include "mbedtls/ssl.h"
+#include "nghttp2/nghttp2.h"
+#include "sdkconfig.h"
+
+#include "client/network/dns_cache.h"
+#include "client/network/http2_esp32.h"
+
+#define HTTP2_MAX_STREAMS CONFIG_IOTA_HTTP2_MAX_STREAMS
+#define HTTP2_WINDOW_SIZE CONFIG_IOTA_HTTP2_WINDOW_SIZE
+#define HTTP2_IDLE_TIMEOUT_US ((int64_t)CONFIG_IOTA_HTTP_POOL_IDLE_TIMEOUT_MS * 1000)
+
+// how long the task waits for frames before queued requests are started, bounds their extra latency
+#define HTTP2_POLL_MS 10
+// how often an idle connection is read for pings and its shutdown by the peer
+#define HTTP2_IDLE_POLL_MS 500
+#define HTTP2_RX_BUF_LEN 1024
+#define HTTP2_HOST_MAX_LEN 128
+#define HTTP2_ENCODING_MAX_LEN 16
+#define HTTP2_MAX_HEADER_LIST 4096
+// endpoints remembered to answer without HTTP/2
+#define HTTP2_NO_H2_CACHE_LEN 4
+
+typedef struct {
+  char host[HTTP2_HOST_MAX_LEN];  ///< the host name
+  uint16_t port;                  ///< the port
+  bool use_tls;                   ///< the endpoint uses TLS
+} http2_endpoint_t;
+
+typedef struct http2_stream {
+  http2_request_t const* req;             ///< the request
+  http2_response_cb_t const* cb;          ///< the response callbacks
+  int64_t deadline;                       ///< the deadline of the request, in microseconds
+  int32_t id;                             ///< the stream ID, 0 until the request was submitted
+  size_t body_sent;                       ///< request body bytes passed to the session
+  long status;                            ///< the status of the response
+  char encoding[HTTP2_ENCODING_MAX_LEN];  ///< the value of content-encoding, truncated
+  bool headers_done;                      ///< the final response header was received
+  int ret;                                ///< the result of the request
+  http2_timing_t timing;                  ///< the timing of the stream
+  SemaphoreHandle_t done;                 ///< given by the HTTP/2 task once the stream completed
+  StaticSemaphore_t done_buf;             ///< the storage of done
+  struct http2_stream* next;              ///< the next submitted stream
+} http2_stream_t;
+
+static const char* TAG = "http2";
+
+// guards the queue of submitted streams, the settings and the counters
+static SemaphoreHandle_t h2_lock = NULL;
+static TaskHandle_t h2_task = NULL;
+static http2_stream_t* h2_queue = NULL;
+static bool h2_enabled = true;
+static bool h2_flush_requested = false;
+static http2_endpoint_t h2_no_h2[HTTP2_NO_H2_CACHE_LEN];
+static size_t h2_no_h2_next = 0;
+static uint32_t h2_sessions = 0;
+static uint32_t h2_streams_sent = 0;
+static uint32_t h2_fallbacks = 0;
+static uint8_t h2_active = 0;
+
+// the connection and the streams in flight, only used by the HTTP/2 task
+static esp_tls_t* h2_tls = NULL;
+static int h2_fd = -1;
+static nghttp2_session* h2_session = NULL;
+static http2_endpoint_t h2_endpoint;
+static bool h2_settings_seen = false;
+static int64_t h2_last_used = 0;
+static http2_stream_t* h2_streams[HTTP2_MAX_STREAMS];
+
+static uint32_t time_left_ms(int64_t deadline) {
+  int64_t left_us = deadline - esp_timer_get_time();
+  return left_us > 0 ? (uint32_t)((left_us + 999) / 1000) : 0;
+}
+
+static bool endpoint_equal(http2_endpoint_t const* ep, char const* host, uint16_t port, bool use_tls) {
+  return ep->port == port && ep->use_tls == use_tls && strcmp(ep->host, host) == 0;
+}
+
+// must be called with h2_lock held
+static bool no_h2_find(char const* host, uint16_t port, bool use_tls) {
+  for (size_t i = 0; i < HTTP2_NO_H2_CACHE_LEN; i++) {
+    if (endpoint_equal(&h2_no_h2[i], host, port, use_tls)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+static void no_h2_add(http2_endpoint_t const* ep) {
+  xSemaphoreTake(h2_lock, portMAX_DELAY);
+  if (!no_h2_find(ep->host, ep->port, ep->use_tls)) {
+    h2_no_h2[h2_no_h2_next] = *ep;
+    h2_no_h2_next = (h2_no_h2_next + 1) % HTTP2_NO_H2_CACHE_LEN;
+  }
+  xSemaphoreGive(h2_lock);
+}
+
+static size_t streams_active() {
+  size_t active = 0;
+  for (size_t i = 0; i < HTTP2_MAX_STREAMS; i++) {
+    active += h2_streams[i] ? 1 : 0;
+  }
+  return active;
+}
+
+static void streams_count() {
+  xSemaphoreTake(h2_lock, portMAX_DELAY);
+  h2_active = streams_active();
+  xSemaphoreGive(h2_lock);
+}
+
+// hands a stream back to its caller, it must not be touched afterwards
+static void stream_done(http2_stream_t* s, int ret) {
+  if (s->id > 0 && h2_session) {
+    // frames that still arrive for the stream are dropped
+    nghttp2_session_set_stream_user_data(h2_session, s->id, NULL);
+  }
+  for (size_t i = 0; i < HTTP2_MAX_STREAMS; i++) {
+    if (h2_streams[i] == s) {
+      h2_streams[i] = NULL;
+    }
+  }
+  h2_last_used = esp_timer_get_time();
+  s->ret = ret;
+  xSemaphoreGive(s->done);
+}
+
+static void stream_abort(http2_stream_t* s) {
+  nghttp2_submit_rst_stream(h2_session, NGHTTP2_FLAG_NONE, s->id, NGHTTP2_CANCEL);
+  stream_done(s, -1);
+}
+
+// the socket is non-blocking, a read or write that cannot proceed yet is repeated once the socket is ready
+static bool would_block(ssize_t n) {
+  return n == ESP_TLS_ERR_SSL_WANT_READ || n == ESP_TLS_ERR_SSL_WANT_WRITE ||
+         (n < 0 && !h2_endpoint.use_tls && (errno == EAGAIN || errno == EWOULDBLOCK));
+}
+
+static ssize_t on_send(nghttp2_session* session, uint8_t const* data, size_t length, int flags, void* user_data) {
+  ssize_t n = esp_tls_conn_write(h2_tls, data, length);
+  if (would_block(n)) {
+    return NGHTTP2_ERR_WOULDBLOCK;
+  }
+  if (n <= 0) {
+    ESP_LOGE(TAG, "write to %s failed: %d", h2_endpoint.host, (int)n);
+    return NGHTTP2_ERR_CALLBACK_FAILURE;
+  }
+  return n;
+}
+
+static ssize_t on_body_read(nghttp2_session* session, int32_t stream_id, uint8_t* buf, size_t length,
+                            uint32_t* data_flags, nghttp2_data_source* source, void* user_data) {
+  // the body belongs to the caller, it is gone once the stream was handed back
+  http2_stream_t* s = nghttp2_session_get_stream_user_data(session, stream_id);
+  if (s == NULL) {
+    return NGHTTP2_ERR_TEMPORAL_CALLBACK_FAILURE;
+  }
+  size_t n = s->req->body_len - s->body_sent;
+  n = n < length ? n : length;
+  memcpy(buf, s->req->body + s->body_sent, n);
+  s->body_sent += n;
+  if (s->body_sent == s->req->body_len) {
+    *data_flags |= NGHTTP2_DATA_FLAG_EOF;
+  }
+  return n;
+}
+
+// the final response header follows any number of informational ones
+static bool response_header_frame(nghttp2_frame const* frame, http2_stream_t const* s) {
+  return frame->hd.type == NGHTTP2_HEADERS && !s->headers_done &&
+         (frame->headers.cat == NGHTTP2_HCAT_RESPONSE || frame->headers.cat == NGHTTP2_HCAT_HEADERS);
+}
+
+static int on_header(nghttp2_session* session, nghttp2_frame const* frame, uint8_t const* name, size_t namelen,
+                     uint8_t const* value, size_t valuelen, uint8_t flags, void* user_data) {
+  http2_stream_t* s = nghttp2_session_get_stream_user_data(session, frame->hd.stream_id);
+  if (s == NULL || !response_header_frame(frame, s)) {
+    return 0;
+  }
+  // names are lower case in HTTP/2
+  if (namelen == 7 && memcmp(name, ":status", 7) == 0) {
+    s->status = strtol((char const*)value, NULL, 10);
+  } else if (namelen == 16 && memcmp(name, "content-encoding", 16) == 0) {
+    size_t n = valuelen < sizeof(s->encoding) - 1 ? valuelen : sizeof(s->encoding) - 1;
+    memcpy(s->encoding, value, n);
+    s->encoding[n] = '\0';
+  }
+  return 0;
+}
+
+static int on_frame_recv(nghttp2_session* session, nghttp2_frame const* frame, void* user_data) {
+  if (frame->hd.type == NGHTTP2_SETTINGS) {
+    h2_settings_seen = true;
+    return 0;
+  }
+  http2_stream_t* s = frame->hd.stream_id ? nghttp2_session_get_stream_user_data(session, frame->hd.stream_id) : NULL;
+  if (s == NULL || !response_header_frame(frame, s)) {
+    return 0;
+  }
+  if (s->timing.first_byte == 0) {
+    s->timing.first_byte = esp_timer_get_time();
+  }
+  s->timing.received += frame->hd.length;
+  if (s->status < 200) {
+    // an informational response, the final one comes in the next header
+    s->status = 0;
+    s->encoding[0] = '\0';
+    return 0;
+  }
+  s->headers_done = true;
+  if (s->cb->on_headers(s->status, s->encoding, s->cb->ctx) != 0) {
+    stream_abort(s);
+  }
+  return 0;
+}
+
+static int on_data_chunk_recv(nghttp2_session* session, uint8_t flags, int32_t stream_id, uint8_t const* data,
+                              size_t len, void* user_data) {
+  http2_stream_t* s = nghttp2_session_get_stream_user_data(session, stream_id);
+  if (s == NULL) {
+    return 0;
+  }
+  s->timing.received += len;
+  if (s->cb->on_data(data, len, s->cb->ctx) != 0) {
+    stream_abort(s);
+  }
+  return 0;
+}
+
+static int on_stream_close(nghttp2_session* session, int32_t stream_id, uint32_t error_code, void* user_data) {
+  http2_stream_t* s = nghttp2_session_get_stream_user_data(session, stream_id);
+  if (s == NULL) {
+    return 0;
+  }
+  int ret = error_code == NGHTTP2_NO_ERROR && s->headers_done ? 0 : -1;
+  if (ret != 0) {
+    ESP_LOGE(TAG, "stream to %s closed: %s", h2_endpoint.host, nghttp2_http2_strerror(error_code));
+  } else if (s->cb->on_complete(s->cb->ctx) != 0) {
+    ret = -1;
+  }
+  stream_done(s, ret);
+  return 0;
+}
+
+// fails the streams in flight and closes the connection
+static void session_close(int ret) {
+  for (size_t i = 0; i < HTTP2_MAX_STREAMS; i++) {
+    if (h2_streams[i]) {
+      stream_done(h2_streams[i], ret);
+    }
+  }
+  if (h2_session) {
+    nghttp2_session_del(h2_session);
+    h2_session = NULL;
+  }
+  if (h2_tls) {
+    esp_tls_conn_delete(h2_tls);
+    h2_tls = NULL;
+    h2_fd = -1;
+  }
+  streams_count();
+}
+
+static void session_fail(char const* reason) {
+  ESP_LOGE(TAG, "connection to %s:%u: %s", h2_endpoint.host, h2_endpoint.port, reason);
+  int ret = -1;
+  if (!h2_settings_seen && !h2_endpoint.use_tls) {
+    // a HTTP/1.1 server does not answer the connection preface with settings
+    no_h2_add(&h2_endpoint);
+    ret = HTTP2_ERR_UNAVAILABLE;
+  }
+  session_close(ret);
+}
+
+static int session_new(esp_tls_t* tls, int fd) {
+  nghttp2_session_callbacks* callbacks = NULL;
+  if (nghttp2_session_callbacks_new(&callbacks) != 0) {
+    return -1;
+  }
+  nghttp2_session_callbacks_set_send_callback(callbacks, on_send);
+  nghttp2_session_callbacks_set_on_header_callback(callbacks, on_header);
+  nghttp2_session_callbacks_set_on_frame_recv_callback(callbacks, on_frame_recv);
+  nghttp2_session_callbacks_set_on_data_chunk_recv_callback(callbacks, on_data_chunk_recv);
+  nghttp2_session_callbacks_set_on_stream_close_callback(callbacks, on_stream_close);
+  int ret = nghttp2_session_client_new(&h2_session, callbacks, NULL);
+  nghttp2_session_callbacks_del(callbacks);
+  if (ret != 0) {
+    h2_session = NULL;
+    return -1;
+  }
+
+  // the peer may send this much per stream and in total before it waits for a window update, which bounds what has
+  // to be buffered while the callbacks of the streams run
+  nghttp2_settings_entry settings[] = {
+      {NGHTTP2_SETTINGS_MAX_CONCURRENT_STREAMS, HTTP2_MAX_STREAMS},
+      {NGHTTP2_SETTINGS_INITIAL_WINDOW_SIZE, HTTP2_WINDOW_SIZE},
+      {NGHTTP2_SETTINGS_ENABLE_PUSH, 0},
+      {NGHTTP2_SETTINGS_MAX_HEADER_LIST_SIZE, HTTP2_MAX_HEADER_LIST},
+  };
+  if (nghttp2_submit_settings(h2_session, NGHTTP2_FLAG_NONE, settings, sizeof(settings) / sizeof(settings[0])) != 0 ||
+      nghttp2_session_set_local_window_size(h2_session, NGHTTP2_FLAG_NONE, 0,
+                                            HTTP2_MAX_STREAMS * HTTP2_WINDOW_SIZE) != 0) {
+    nghttp2_session_del(h2_session);
+    h2_session = NULL;
+    return -1;
+  }
+  h2_tls = tls;
+  h2_fd = fd;
+  return 0;
+}
+
+// connects to the endpoint of a stream, HTTP2_ERR_UNAVAILABLE if it does not negotiate HTTP/2
+static int session_open(http2_request_t const* req, int64_t deadline) {
+  static char const* alpn[] = {"h2", NULL};
+  http2_endpoint_t ep = {.port = req->port, .use_tls = req->use_tls};
+  snprintf(ep.host, sizeof(ep.host), "%s", req->host);
+  esp_tls_cfg_t cfg = {
+      .alpn_protos = req->use_tls ? alpn : NULL,
+      .timeout_ms = time_left_ms(deadline),
+      .common_name = req->use_tls ? ep.host : NULL,
+      .is_plain_tcp = !req->use_tls,
+  };
+  char ip[DNS_CACHE_IP_LEN];
+  if (dns_cache_resolve(ep.host, ip, sizeof(ip)) != 0) {
+    ESP_LOGE(TAG, "resolve %s failed", ep.host);
+    return -1;
+  }
+
+  esp_tls_t* tls = esp_tls_init();
+  if (tls == NULL) {
+    ESP_LOGE(TAG, "allocate tls handle failed");
+    return -1;
+  }
+  if (esp_tls_conn_new_sync(ip, strlen(ip), ep.port, &cfg, tls) != 1) {
+    ESP_LOGE(TAG, "connect to %s:%u (%s) failed", ep.host, ep.port, ip);
+    dns_cache_expire(ep.host);
+    esp_tls_conn_delete(tls);
+    return -1;
+  }
+  if (req->use_tls) {
+    char const* proto = mbedtls_ssl_get_alpn_protocol(&tls->ssl);
+    if (proto == NULL || strcmp(proto, "h2") != 0) {
+      ESP_LOGW(TAG, "%s:%u does not support HTTP/2", ep.host, ep.port);
+      no_h2_add(&ep);
+      esp_tls_conn_delete(tls);
+      return HTTP2_ERR_UNAVAILABLE;
+    }
+  }
+
+  // the task waits for the socket in session_io(), reads and writes must not block it. A receive timeout instead is no
+  // option, mbedtls reports it as a failed read rather than one to be repeated.
+  int fd = -1;
+  if (esp_tls_get_conn_sockfd(tls, &fd) != ESP_OK || fcntl(fd, F_SETFL, fcntl(fd, F_GETFL, 0) | O_NONBLOCK) != 0) {
+    ESP_LOGE(TAG, "set up the socket of %s failed", ep.host);
+    esp_tls_conn_delete(tls);
+    return -1;
+  }
+  if (session_new(tls, fd) != 0) {
+    ESP_LOGE(TAG, "create session failed");
+    esp_tls_conn_delete(tls);
+    return -1;
+  }
+  h2_endpoint = ep;
+  h2_settings_seen = false;
+  h2_last_used = esp_timer_get_time();
+  xSemaphoreTake(h2_lock, portMAX_DELAY);
+  h2_sessions++;
+  xSemaphoreGive(h2_lock);
+  return 0;
+}
+
+#define H2_NV(name, value) \
+  { (uint8_t*)(name), (uint8_t*)(value), strlen(name), strlen(value), NGHTTP2_NV_FLAG_NONE }
+
+static int stream_submit(http2_stream_t* s) {
+  http2_request_t const* req = s->req;
+  char authority[HTTP2_HOST_MAX_LEN + 7];
+  char content_length[12];
+  snprintf(authority, sizeof(authority), "%s:%u", req->host, req->port);
+  snprintf(content_length, sizeof(content_length), "%zu", req->body_len);
+
+  // the session copies the header fields
+  nghttp2_nv headers[8] = {
+      H2_NV(":method", req->method),
+      H2_NV(":scheme", req->use_tls ? "https" : "http"),
+      H2_NV(":authority", authority),
+      H2_NV(":path", req->path),
+      H2_NV("accept", req->accept),
+  };
+  size_t len = 5;
+#if CONFIG_IOTA_HTTP_COMPRESSION
+  headers[len++] = (nghttp2_nv)H2_NV("accept-encoding", "gzip, deflate");
+#endif
+  nghttp2_data_provider body = {.source = {.ptr = s}, .read_callback = on_body_read};
+  if (req->body) {
+    headers[len++] = (nghttp2_nv)H2_NV("content-type", req->content_type);
+    headers[len++] = (nghttp2_nv)H2_NV("content-length", content_length);
+  }
+
+  int32_t id = nghttp2_submit_request(h2_session, NULL, headers, len, req->body ? &body : NULL, s);
+  if (id < 0) {
+    ESP_LOGE(TAG, "submit %s failed: %s", req->path, nghttp2_strerror(id));
+    return -1;
+  }
+  s->id = id;
+  s->timing.sent = esp_timer_get_time();
+  for (size_t i = 0; i < HTTP2_MAX_STREAMS; i++) {
+    if (h2_streams[i] == NULL) {
+      h2_streams[i] = s;
+      break;
+    }
+  }
+  xSemaphoreTake(h2_lock, portMAX_DELAY);
+  h2_streams_sent++;
+  xSemaphoreGive(h2_lock);
+  return 0;
+}
+
+static size_t streams_limit() {
+  uint32_t remote = nghttp2_session_get_remote_settings(h2_session, NGHTTP2_SETTINGS_MAX_CONCURRENT_STREAMS);
+  return remote < HTTP2_MAX_STREAMS ? remote : HTTP2_MAX_STREAMS;
+}
+
+// starts the submitted streams as far as the limit of concurrent streams allows
+static void streams_start() {
+  for (;;) {
+    xSemaphoreTake(h2_lock, portMAX_DELAY);
+    http2_stream_t* s = h2_queue;
+    if (s && h2_session && endpoint_equal(&h2_endpoint, s->req->host, s->req->port, s->req->use_tls) &&
+        streams_active() >= streams_limit()) {
+      // waits for a stream of the connection to complete
+      s = NULL;
+    }
+    if (s) {
+      h2_queue = s->next;
+    }
+    bool no_h2 = s && no_h2_find(s->req->host, s->req->port, s->req->use_tls);
+    xSemaphoreGive(h2_lock);
+    if (s == NULL) {
+      break;
+    }
+
+    if (no_h2) {
+      stream_done(s, HTTP2_ERR_UNAVAILABLE);
+      continue;
+    }
+    if ((s->req->abort && *s->req->abort) || time_left_ms(s->deadline) == 0) {
+      stream_done(s, -1);
+      continue;
+    }
+    if (h2_session && !endpoint_equal(&h2_endpoint, s->req->host, s->req->port, s->req->use_tls)) {
+      if (streams_active()) {
+        // the connection is busy with another endpoint
+        stream_done(s, HTTP2_ERR_UNAVAILABLE);
+        continue;
+      }
+      nghttp2_session_terminate_session(h2_session, NGHTTP2_NO_ERROR);
+      nghttp2_session_send(h2_session);
+      session_close(-1);
+    }
+    if (h2_session == NULL) {
+      int ret = session_open(s->req, s->deadline);
+      if (ret != 0) {
+        stream_done(s, ret);
+        continue;
+      }
+    }
+    if (stream_submit(s) != 0) {
+      stream_done(s, -1);
+    }
+  }
+  streams_count();
+}
+
+// resets the streams that passed their deadline or were aborted by the caller
+static void streams_check() {
+  for (size_t i = 0; i < HTTP2_MAX_STREAMS; i++) {
+    http2_stream_t* s = h2_streams[i];
+    if (s == NULL) {
+      continue;
+    }
+    if (time_left_ms(s->deadline) == 0) {
+      ESP_LOGE(TAG, "%s on %s timed out", s->req->path, h2_endpoint.host);
+      stream_abort(s);
+    } else if (s->req->abort && *s->req->abort) {
+      stream_abort(s);
+    }
+  }
+}
+
+// waits up to the poll interval until the connection can be read, or written while the session has frames queued
+static bool session_wait() {
+  if (h2_endpoint.use_tls && esp_tls_get_bytes_avail(h2_tls) > 0) {
+    // a record was decrypted but not read completely, the socket may have nothing more
+    return true;
+  }
+  fd_set rfds, wfds;
+  FD_ZERO(&rfds);
+  FD_ZERO(&wfds);
+  FD_SET(h2_fd, &rfds);
+  if (nghttp2_session_want_write(h2_session)) {
+    FD_SET(h2_fd, &wfds);
+  }
+  struct timeval tv = {.tv_sec = 0, .tv_usec = HTTP2_POLL_MS * 1000};
+  // errors are reported by the read
+  return select(h2_fd + 1, &rfds, &wfds, NULL, &tv) != 0;
+}
+
+// sends what the session has queued and processes the frames that arrive within the poll interval
+static void session_io() {
+  if (nghttp2_session_send(h2_session) != 0) {
+    session_fail("send failed");
+    return;
+  }
+  if (!session_wait()) {
+    return;
+  }
+  char buf[HTTP2_RX_BUF_LEN];
+  ssize_t n = esp_tls_conn_read(h2_tls, buf, sizeof(buf));
+  if (would_block(n)) {
+    return;
+  }
+  if (n <= 0) {
+    session_fail(n == 0 ? "closed by the peer" : "read failed");
+    return;
+  }
+  ssize_t used = nghttp2_session_mem_recv(h2_session, (uint8_t const*)buf, n);
+  if (used < 0) {
+    session_fail(nghttp2_strerror(used));
+    return;
+  }
+  // acknowledges settings and pings and opens the flow control windows again
+  if (nghttp2_session_send(h2_session) != 0) {
+    session_fail("send failed");
+    return;
+  }
+  if (!nghttp2_session_want_read(h2_session) && !nghttp2_session_want_write(h2_session)) {
+    session_fail("shut down by the peer");
+  }
+}
+
+static void http2_task(void* arg) {
+  for (;;) {
+    if (streams_active() == 0) {
+      // a submitted stream wakes the task, an idle connection is still read for pings and the shutdown by the peer
+      ulTaskNotifyTake(pdTRUE, h2_session ? pdMS_TO_TICKS(HTTP2_IDLE_POLL_MS) : portMAX_DELAY);
+      xSemaphoreTake(h2_lock, portMAX_DELAY);
+      bool flush = h2_flush_requested;
+      h2_flush_requested = false;
+      bool queued = h2_queue != NULL;
+      xSemaphoreGive(h2_lock);
+      if (h2_session && !queued && (flush || esp_timer_get_time() - h2_last_used > HTTP2_IDLE_TIMEOUT_US)) {
+        nghttp2_session_terminate_session(h2_session, NGHTTP2_NO_ERROR);
+        nghttp2_session_send(h2_session);
+        session_close(-1);
+        continue;
+      }
+    }
+    streams_start();
+    if (h2_session) {
+      streams_check();
+      session_io();
+      streams_count();
+    }
+  }
+}
+
+bool http2_init() {
+  if (h2_lock == NULL) {
+    h2_lock = xSemaphoreCreateMutex();
+    if (h2_lock == NULL ||
+        xTaskCreate(http2_task, "http2", CONFIG_IOTA_CLIENT_TASK_STACK_SIZE, NULL, tskIDLE_PRIORITY + 5, &h2_task) !=
+            pdPASS) {
+      ESP_LOGE(TAG, "start HTTP/2 task failed");
+      return false;
+    }
+  }
+  return h2_task != NULL;
+}
+
+int http2_perform(http2_request_t const* req, http2_response_cb_t const* cb, int64_t deadline, long* status,
+                  http2_timing_t* timing) {
+#if !CONFIG_IOTA_HTTP2_CLEARTEXT
+  if (!req->use_tls) {
+    return HTTP2_ERR_UNAVAILABLE;
+  }
+#endif
+  if (strlen(req->host) >= HTTP2_HOST_MAX_LEN || h2_task == NULL) {
+    return HTTP2_ERR_UNAVAILABLE;
+  }
+
+  http2_stream_t s = {.req = req, .cb = cb, .deadline = deadline};
+  s.done = xSemaphoreCreateBinaryStatic(&s.done_buf);
+  xSemaphoreTake(h2_lock, portMAX_DELAY);
+  bool use = h2_enabled && !no_h2_find(req->host, req->port, req->use_tls);
+  if (use) {
+    http2_stream_t** tail = &h2_queue;
+    while (*tail) {
+      tail = &(*tail)->next;
+    }
+    *tail = &s;
+  } else if (h2_enabled) {
+    h2_fallbacks++;
+  }
+  xSemaphoreGive(h2_lock);
+  if (!use) {
+    return HTTP2_ERR_UNAVAILABLE;
+  }
+
+  xTaskNotifyGive(h2_task);
+  // the task completes every stream, by its deadline at the latest
+  xSemaphoreTake(s.done, portMAX_DELAY);
+  if (s.ret == HTTP2_ERR_UNAVAILABLE) {
+    xSemaphoreTake(h2_lock, portMAX_DELAY);
+    h2_fallbacks++;
+    xSemaphoreGive(h2_lock);
+  }
+  *status = s.status;
+  *timing = s.timing;
+  return s.ret;
+}
+
+bool http2_set_enabled(bool enable) {
+  bool previous = false;
+  if (h2_task) {
+    xSemaphoreTake(h2_lock, portMAX_DELAY);
+    previous = h2_enabled;
+    h2_enabled = enable;
+    xSemaphoreGive(h2_lock);
+  }
+  return previous;
+}
+
+void http2_get_stats(http_pool_stats_t* stats) {
+  if (h2_lock) {
+    xSemaphoreTake(h2_lock, portMAX_DELAY);
+    stats->h2_sessions = h2_sessions;
+    stats->h2_streams = h2_streams_sent;
+    stats->h2_fallbacks = h2_fallbacks;
+    stats->h2_active = h2_active;
+    xSemaphoreGive(h2_lock);
+  }
+}
+
+void http2_reset_stats() {
+  if (h2_lock) {
+    xSemaphoreTake(h2_lock, portMAX_DELAY);
+    h2_sessions = 0;
+    h2_streams_sent = 0;
+    h2_fallbacks = 0;
+    xSemaphoreGive(h2_lock);
+  }
+}
+
+void http2_flush() {
+  if (h2_task) {
+    xSemaphoreTake(h2_lock, portMAX_DELAY);
+    h2_flush_requested = true;
+    xSemaphoreGive(h2_lock);
+    xTaskNotifyGive(h2_task);
+  }
+}
@@ -0,0 +1,115 @@
+// Copyright 2022 IOTA Stiftung
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef __CLIENT_NETWORK_HTTP2_ESP32_H__
+#define __CLIENT_NETWORK_HTTP2_ESP32_H__
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "client/network/http.h"
+#include "client/network/http_pool.h"
+
+// the endpoint does not speak HTTP/2 or the connection is busy with another endpoint, send the request with HTTP/1.1
+#define HTTP2_ERR_UNAVAILABLE -2
+
+/**
+ * @brief A request sent as a HTTP/2 stream
+ *
+ */
+typedef struct {
+  char const* method;        ///< the HTTP method
+  char const* host;          ///< the endpoint
+  uint16_t port;             ///< the endpoint port
+  bool use_tls;              ///< the endpoint uses TLS
+  char const* path;          ///< the request path
+  char const* accept;        ///< the Accept header
+  char const* content_type;  ///< the Content-Type header of the body
+  byte_t const* body;        ///< the request body, NULL for none
+  size_t body_len;           ///< the length of the body
+  bool volatile* abort;      ///< aborts the stream once set, can be NULL
+} http2_request_t;
+
+/**
+ * @brief Receives the response of a stream, the callbacks run on the HTTP/2 task
+ *
+ */
+typedef struct {
+  int (*on_headers)(long status, char const* content_encoding, void* ctx);  ///< the final header, non-zero aborts
+  int (*on_data)(byte_t const* data, size_t len, void* ctx);                ///< a body chunk, non-zero aborts
+  int (*on_complete)(void* ctx);                                            ///< the end of the body, non-zero fails
+  void* ctx;                                                                ///< the context of the callbacks
+} http2_response_cb_t;
+
+/**
+ * @brief Timing of a stream
+ *
+ */
+typedef struct {
+  int64_t sent;        ///< the time the request was submitted, in microseconds
+  int64_t first_byte;  ///< the time the first response byte arrived, 0 if none
+  size_t received;     ///< response bytes received on the stream
+} http2_timing_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Start the task that owns the HTTP/2 connection
+ *
+ * Called once by http_client_init() before any request is sent, HTTP/2 is unavailable if the task could not be started.
+ *
+ * @return bool true if the task is running
+ */
+bool http2_init();
+
+/**
+ * @brief Perform a request as a stream of the HTTP/2 connection
+ *
+ * Requests of any number of tasks share one connection, a task owns it and sends and receives the frames of all
+ * streams. The calling task blocks until its stream completed.
+ *
+ * @param[in] req The request
+ * @param[in] cb The response callbacks
+ * @param[in] deadline The deadline of the request, in microseconds
+ * @param[out] status The HTTP status code
+ * @param[out] timing The timing of the stream
+ * @return int 0 on success, HTTP2_ERR_UNAVAILABLE if the request has to be sent with HTTP/1.1
+ */
+int http2_perform(http2_request_t const* req, http2_response_cb_t const* cb, int64_t deadline, long* status,
+                  http2_timing_t* timing);
+
+/**
+ * @brief Enable or disable HTTP/2, requests of disabled HTTP/2 are sent with HTTP/1.1
+ *
+ * @param[in] enable true to use HTTP/2 for endpoints that support it
+ * @return bool The previous setting
+ */
+bool http2_set_enabled(bool enable);
+
+/**
+ * @brief Add the HTTP/2 counters to the pool counters
+ *
+ * @param[out] stats The pool counters
+ */
+void http2_get_stats(http_pool_stats_t* stats);
+
+/**
+ * @brief Reset the HTTP/2 counters
+ *
+ */
+void http2_reset_stats();
+
+/**
+ * @brief Close the HTTP/2 connection once it is idle
+ *
+ */
+void http2_flush();
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,244 @@
+// Copyright 2022 IOTA Stiftung
+// SPDX-License-Identifier: Apache-2.0
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "esp_heap_caps.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "sdkconfig.h"
+#include "uthash.h"
+
+#include "client/network/http_cache.h"
+
+#define HTTP_CACHE_BUDGET CONFIG_IOTA_HTTP_CACHE_SIZE
+#define HTTP_CACHE_API_PREFIX "/api/core/v2/"
+// block, milestone and transaction IDs are 32 bytes
+#define HTTP_CACHE_ID_HEX_LEN 64
+
+typedef struct {
+  char* key;          ///< the media type, the endpoint and the path
+  byte_t* data;       ///< the response body
+  size_t len;         ///< the length of the body
+  size_t size;        ///< the bytes allocated for the entry
+  UT_hash_handle hh;  ///< the hash table and the LRU order, the least recently used entry comes first
+} cache_entry_t;
+
+static cache_entry_t* entries = NULL;
+static http_cache_stats_t cache_stats = {.budget = HTTP_CACHE_BUDGET};
+static bool cache_enabled = true;
+// guards the entries, the counters and the enabled flag
+static SemaphoreHandle_t cache_lock = NULL;
+
+static bool cache_init() {
+  if (cache_lock == NULL) {
+    cache_lock = xSemaphoreCreateMutex();
+  }
+  return cache_lock != NULL;
+}
+
+// returns the position after a 0x prefixed hex string of len characters, NULL if there is none
+static char const* skip_hex_id(char const* p, size_t len) {
+  if (p[0] != '0' || p[1] != 'x') {
+    return NULL;
+  }
+  p += 2;
+  for (size_t i = 0; i < len; i++, p++) {
+    if (!((*p >= '0' && *p <= '9') || (*p >= 'a' && *p <= 'f') || (*p >= 'A' && *p <= 'F'))) {
+      return NULL;
+    }
+  }
+  return p;
+}
+
+static bool match_prefix(char const** p, char const* prefix) {
+  size_t len = strlen(prefix);
+  if (strncmp(*p, prefix, len) != 0) {
+    return false;
+  }
+  *p += len;
+  return true;
+}
+
+// immutable responses of the node API
+static bool cache_path(char const* path) {
+  if (HTTP_CACHE_BUDGET == 0 || path == NULL || !match_prefix(&path, HTTP_CACHE_API_PREFIX)) {
+    return false;
+  }
+
+  char const* p = path;
+  if (match_prefix(&p, "blocks/")) {
+    p = skip_hex_id(p, HTTP_CACHE_ID_HEX_LEN);
+    return p && *p == '\0';
+  }
+  if (match_prefix(&p, "transactions/")) {
+    p = skip_hex_id(p, HTTP_CACHE_ID_HEX_LEN);
+    return p && strcmp(p, "/included-block") == 0;
+  }
+  if (match_prefix(&p, "milestones/")) {
+    if (match_prefix(&p, "by-index/")) {
+      size_t digits = strspn(p, "0123456789");
+      p = digits ? p + digits : NULL;
+    } else {
+      p = skip_hex_id(p, HTTP_CACHE_ID_HEX_LEN);
+    }
+    return p && (*p == '\0' || strcmp(p, "/utxo-changes") == 0);
+  }
+  return false;
+}
+
+bool http_cache_cacheable(char const* path) {
+  if (!cache_path(path) || !cache_init()) {
+    return false;
+  }
+  xSemaphoreTake(cache_lock, portMAX_DELAY);
+  bool enabled = cache_enabled;
+  xSemaphoreGive(cache_lock);
+  return enabled;
+}
+
+static void entry_remove(cache_entry_t* entry) {
+  HASH_DEL(entries, entry);
+  cache_stats.entries--;
+  cache_stats.bytes -= entry->size;
+  free(entry);
+}
+
+static cache_entry_t* entry_new(char const* key, byte_t const* data, size_t len) {
+  size_t key_len = strlen(key);
+  size_t size = sizeof(cache_entry_t) + key_len + 1 + len;
+  cache_entry_t* entry = NULL;
+#if CONFIG_IOTA_HTTP_CACHE_PSRAM
+  entry = heap_caps_malloc(size, MALLOC_CAP_SPIRAM);
+#endif
+  if (entry == NULL) {
+    entry = malloc(size);
+  }
+  if (entry) {
+    memset(entry, 0, sizeof(cache_entry_t));
+    entry->key = (char*)(entry + 1);
+    memcpy(entry->key, key, key_len + 1);
+    entry->data = (byte_t*)entry->key + key_len + 1;
+    memcpy(entry->data, data, len);
+    entry->len = len;
+    entry->size = size;
+  }
+  return entry;
+}
+
+// the same path can have a different response on another network, e.g. milestones by index
+static char* cache_key(http_client_config_t const* config, char const* accept) {
+  // "<accept> <scheme>://<host>:<port><path>", the port has up to 5 digits
+  size_t len = strlen(accept) + strlen(" https://") + strlen(config->host) + 6 + strlen(config->path) + 1;
+  char* key = malloc(len);
+  if (key) {
+    snprintf(key, len, "%s %s://%s:%u%s", accept, config->use_tls ? "https" : "http", config->host, config->port,
+             config->path);
+  }
+  return key;
+}
+
+bool http_cache_get(http_client_config_t const* config, char const* accept, byte_buf_t* body) {
+  if (config == NULL || config->host == NULL || config->path == NULL || accept == NULL || body == NULL ||
+      !cache_init()) {
+    return false;
+  }
+  char* key = cache_key(config, accept);
+  if (key == NULL) {
+    return false;
+  }
+
+  bool hit = false;
+  xSemaphoreTake(cache_lock, portMAX_DELAY);
+  cache_entry_t* entry = NULL;
+  HASH_FIND_STR(entries, key, entry);
+  if (entry && byte_buf_append(body, entry->data, entry->len)) {
+    // move the entry to the end of the LRU order
+    HASH_DEL(entries, entry);
+    HASH_ADD_KEYPTR(hh, entries, entry->key, strlen(entry->key), entry);
+    hit = true;
+  }
+  if (hit) {
+    cache_stats.hits++;
+  } else {
+    cache_stats.misses++;
+  }
+  xSemaphoreGive(cache_lock);
+  free(key);
+  return hit;
+}
+
+void http_cache_put(http_client_config_t const* config, char const* accept, byte_t const* data, size_t len) {
+  if (config == NULL || config->host == NULL || config->path == NULL || accept == NULL || data == NULL || len == 0 ||
+      len > HTTP_CACHE_BUDGET / 4 || !cache_init()) {
+    return;
+  }
+  char* key = cache_key(config, accept);
+  if (key == NULL) {
+    return;
+  }
+  cache_entry_t* entry = entry_new(key, data, len);
+  free(key);
+  if (entry == NULL) {
+    return;
+  }
+
+  xSemaphoreTake(cache_lock, portMAX_DELAY);
+  cache_entry_t* old = NULL;
+  HASH_FIND_STR(entries, entry->key, old);
+  if (old) {
+    entry_remove(old);
+  }
+  // the first entries in the table are the least recently used ones
+  while (entries && cache_stats.bytes + entry->size > HTTP_CACHE_BUDGET) {
+    entry_remove(entries);
+    cache_stats.evictions++;
+  }
+  HASH_ADD_KEYPTR(hh, entries, entry->key, strlen(entry->key), entry);
+  cache_stats.entries++;
+  cache_stats.bytes += entry->size;
+  xSemaphoreGive(cache_lock);
+}
+
+void http_cache_get_stats(http_cache_stats_t* stats) {
+  if (stats == NULL || !cache_init()) {
+    return;
+  }
+  xSemaphoreTake(cache_lock, portMAX_DELAY);
+  *stats = cache_stats;
+  xSemaphoreGive(cache_lock);
+}
+
+void http_cache_reset_stats() {
+  if (!cache_init()) {
+    return;
+  }
+  xSemaphoreTake(cache_lock, portMAX_DELAY);
+  cache_stats.hits = 0;
+  cache_stats.misses = 0;
+  cache_stats.evictions = 0;
+  xSemaphoreGive(cache_lock);
+}
+
+bool http_cache_set_enabled(bool enable) {
+  bool previous = false;
+  if (cache_init()) {
+    xSemaphoreTake(cache_lock, portMAX_DELAY);
+    previous = cache_enabled;
+    cache_enabled = enable;
+    xSemaphoreGive(cache_lock);
+  }
+  return previous;
+}
+
+void http_cache_clear() {
+  if (!cache_init()) {
+    return;
+  }
+  xSemaphoreTake(cache_lock, portMAX_DELAY);
+  cache_entry_t *entry, *tmp;
+  HASH_ITER(hh, entries, entry, tmp) { entry_remove(entry); }
+  xSemaphoreGive(cache_lock);
+}
@@ -0,0 +1,98 @@
+// Copyright 2022 IOTA Stiftung
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef __CLIENT_NETWORK_HTTP_CACHE_H__
+#define __CLIENT_NETWORK_HTTP_CACHE_H__
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "client/network/http.h"
+#include "core/utils/byte_buffer.h"
+
+/**
+ * @brief Counters of the immutable response cache
+ *
+ */
+typedef struct {
+  uint32_t hits;       ///< requests answered from the cache
+  uint32_t misses;     ///< cacheable requests sent to the node
+  uint32_t evictions;  ///< entries removed to stay within the budget
+  uint32_t entries;    ///< entries in the cache
+  size_t bytes;        ///< bytes used by the entries
+  size_t budget;       ///< the maximum bytes of the entries
+} http_cache_stats_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Check if the response of a GET request never changes
+ *
+ * Blocks, milestones by ID or index with their UTXO changes and the included block of a transaction are immutable
+ * once the node knows them. Metadata, outputs and other resources are not. Milestones by index depend on the network of
+ * the node, cached responses are therefore kept per endpoint.
+ *
+ * @param[in] path The request path
+ * @return true The response can be cached, always false while the cache is disabled
+ */
+bool http_cache_cacheable(char const* path);
+
+/**
+ * @brief Look up a cached response
+ *
+ * @param[in] config The endpoint and path of the request
+ * @param[in] accept The media type of the response
+ * @param[out] body The cached body is appended to it on a hit
+ * @return true The response was found
+ */
+bool http_cache_get(http_client_config_t const* config, char const* accept, byte_buf_t* body);
+
+/**
+ * @brief Store a response, evicting the least recently used ones if the budget is exceeded
+ *
+ * Responses larger than a quarter of the budget are not stored.
+ *
+ * @param[in] config The endpoint and path of the request
+ * @param[in] accept The media type of the response
+ * @param[in] data The response body
+ * @param[in] len The length of the body
+ */
+void http_cache_put(http_client_config_t const* config, char const* accept, byte_t const* data, size_t len);
+
+/**
+ * @brief Get a snapshot of the cache counters
+ *
+ * @param[out] stats The counters
+ */
+void http_cache_get_stats(http_cache_stats_t* stats);
+
+/**
+ * @brief Reset the hit, miss and eviction counters
+ *
+ */
+void http_cache_reset_stats();
+
+/**
+ * @brief Enable or disable the cache, e.g. to measure requests to the node
+ *
+ * A disabled cache neither answers nor stores requests, the entries are kept. The cache is enabled by default.
+ *
+ * @param[in] enable true to answer immutable requests from the cache
+ * @return bool The previous setting
+ */
+bool http_cache_set_enabled(bool enable);
+
+/**
+ * @brief Remove all entries, called when the node endpoints change
+ *
+ */
+void http_cache_clear();
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,1374 @@
+// Copyright 2022 IOTA Stiftung
+// SPDX-License-Identifier: Apache-2.0
+
+#include <fcntl.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <sys/select.h>
+#include <sys/socket.h>
+
+#include "esp_log.h"
+#include "esp_system.h"
+#include "esp_timer.h"
+#include "esp_tls.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/queue.h"
+#include "freertos/semphr.h"
+#include "freertos/task.h"
+#include "http_parser.h"
+#include "sdkconfig.h"
+
+#include "client/api/restful/single_flight.h"
+#include "client/network/dns_cache.h"
+#include "client/network/http.h"
+#if CONFIG_IOTA_HTTP2
+#include "client/network/http2_esp32.h"
+#endif
+#include "client/network/http_cache.h"
+#include "client/network/http_inflate.h"
+#include "client/network/http_pool.h"
+#include "client/network/http_request.h"
+#include "client/network/http_stats.h"
+#include "client/network/node_set.h"
+
+#define HTTP_POOL_MAX_CONNS CONFIG_IOTA_HTTP_POOL_MAX_CONNS
+#define HTTP_POOL_IDLE_TIMEOUT_US ((int64_t)CONFIG_IOTA_HTTP_POOL_IDLE_TIMEOUT_MS * 1000)
+#define HTTP_TIMEOUT_MS CONFIG_IOTA_HTTP_TIMEOUT_MS
+
+#define HTTP_HOST_MAX_LEN 128
+#define HTTP_HEAD_MAX_LEN 512
+#define HTTP_RX_BUF_LEN 512
+#define HTTP_HEADER_NAME_MAX_LEN 32
+#define HTTP_ENCODING_MAX_LEN 16
+
+#define HTTP_CONTENT_JSON "application/json"
+
+// the GET requests that are shared by identical requests in flight
+#define HTTP_SHARED_OUTPUTS_PATH "/api/core/v2/outputs/"
+#define HTTP_SHARED_BLOCKS_PATH "/api/core/v2/blocks/"
+#define HTTP_SHARED_OUTPUT_ID_HEX_LEN 68
+#define HTTP_SHARED_BLOCK_ID_HEX_LEN 64
+#define HTTP_HEX_DIGITS "0123456789abcdefABCDEF"
+
+// the number of endpoints whose TLS session is kept for resumption
+#define HTTP_TLS_SESSION_CACHE_LEN 4
+
+#if CONFIG_IOTA_HTTP_HEDGE
+// the latency samples of an endpoint needed before its percentile sets the hedge delay
+#define HTTP_HEDGE_MIN_SAMPLES 20
+// hedged requests waiting for the hedge task, further requests are not hedged
+#define HTTP_HEDGE_QUEUE_LEN 4
+#endif
+
+typedef struct {
+  esp_tls_t* tls;                ///< the connection, NULL if the slot is closed
+  char host[HTTP_HOST_MAX_LEN];  ///< the endpoint this connection belongs to
+  uint16_t port;                 ///< the endpoint port
+  bool use_tls;                  ///< the endpoint uses TLS
+  bool in_use;                   ///< the connection is serving a request
+  int64_t last_used;             ///< the time this connection was released, in microseconds
+} http_conn_t;
+
+#if CONFIG_ESP_TLS_CLIENT_SESSION_TICKETS
+typedef struct {
+  char host[HTTP_HOST_MAX_LEN];       ///< the endpoint of the session
+  uint16_t port;                      ///< the endpoint port
+  esp_tls_client_session_t* session;  ///< the session, NULL if the slot is free or the session is in use
+  int64_t last_used;                  ///< the time the session was stored, in microseconds
+} http_tls_session_t;
+#endif
+
+typedef struct {
+  enum http_method method;   ///< the HTTP method
+  char const* accept;        ///< the Accept header
+  char const* content_type;  ///< the Content-Type header of the body
+  byte_t const* body;        ///< the request body, NULL for none
+  size_t body_len;           ///< the length of the body
+  http_body_cb on_body;      ///< streams successful response bodies, NULL to collect them
+  void* ctx;                 ///< the context of on_body
+} http_request_t;
+
+typedef struct {
+  http_request_t const* req;              ///< the request
+  byte_buf_t* body;                       ///< collects the response body, can be NULL
+  size_t received;                        ///< bytes received on the connection
+  bool streaming;                         ///< the body is passed to the on_body callback
+  bool complete;                          ///< the full response was parsed
+  char header[HTTP_HEADER_NAME_MAX_LEN];  ///< the name of the current header, truncated
+  size_t header_len;                      ///< the length of the header name
+  bool in_value;                          ///< the parser is in a header value
+  bool is_encoding;                       ///< the current header is Content-Encoding
+  char encoding[HTTP_ENCODING_MAX_LEN];   ///< the value of Content-Encoding
+  size_t encoding_len;                    ///< the length of the encoding
+  http_encoding_t content_encoding;       ///< the encoding of the body
+  http_inflate_t* inflate;                ///< decompresses the body, created with the first body chunk
+  size_t body_received;                   ///< body bytes as received
+  int64_t first_byte;                     ///< the time the first response byte arrived, in microseconds
+} http_response_ctx_t;
+
+#if CONFIG_IOTA_HTTP_HEDGE
+typedef enum {
+  HEDGE_PRIMARY = 0,  ///< the request of the caller
+  HEDGE_SECONDARY,    ///< the duplicate request sent by the hedge task
+  HEDGE_NONE,         ///< no attempt has answered yet
+} http_hedge_attempt_t;
+
+typedef struct {
+  char host[HTTP_HOST_MAX_LEN];  ///< the endpoint of the request
+  char* path;                    ///< the request path
+  char* accept;                  ///< the Accept header
+  uint16_t port;                 ///< the endpoint port
+  bool use_tls;                  ///< the endpoint uses TLS
+  int primary_node;              ///< the node set index of the primary attempt, -1 if the request is not routed
+  int64_t start_at;              ///< the time the secondary attempt is sent, in microseconds
+  int64_t deadline;              ///< the deadline of the request, in microseconds
+  int fds[2];                    ///< the sockets of the attempts in flight, -1 for none
+  bool answered;                 ///< the primary attempt received a response byte, it is not hedged
+  bool started;                  ///< the secondary attempt was sent
+  http_hedge_attempt_t winner;   ///< the attempt whose response is used
+  bool volatile aborted[2];      ///< set for the attempt that lost, aborts it if it is a HTTP/2 stream
+  byte_buf_t* body;              ///< the response body of the secondary attempt
+  long status;                   ///< the status of the secondary attempt
+  SemaphoreHandle_t cancel;      ///< given by the caller once the secondary attempt is not needed
+  SemaphoreHandle_t done;        ///< given by the hedge task once the secondary attempt completed
+  StaticSemaphore_t cancel_buf;  ///< the storage of cancel
+  StaticSemaphore_t done_buf;    ///< the storage of done
+  uint8_t refs;                  ///< the references of the caller and the hedge task
+} http_hedge_t;
+#endif
+
+static const char* TAG = "http";
+
+static http_conn_t conn_pool[HTTP_POOL_MAX_CONNS];
+static http_pool_stats_t pool_stats;
+// guards the connection slots and the counters
+static SemaphoreHandle_t pool_lock = NULL;
+// limits the number of connections in use
+static SemaphoreHandle_t pool_slots = NULL;
+// the deadline of the requests of each task, 0 for none
+static __thread int64_t task_deadline_us = 0;
+#if CONFIG_ESP_TLS_CLIENT_SESSION_TICKETS
+// guarded by pool_lock
+static http_tls_session_t tls_sessions[HTTP_TLS_SESSION_CACHE_LEN];
+#endif
+#if CONFIG_IOTA_HTTP_HEDGE
+static QueueHandle_t hedge_queue = NULL;
+// guards the state of the hedged requests
+static SemaphoreHandle_t hedge_lock = NULL;
+// the hedged request the task is performing an attempt of, NULL for none
+static __thread http_hedge_t* task_hedge = NULL;
+static __thread http_hedge_attempt_t task_hedge_attempt = HEDGE_NONE;
+#endif
+
+static void conn_close(http_conn_t* conn) {
+  if (conn->tls) {
+    esp_tls_conn_delete(conn->tls);
+    conn->tls = NULL;
+  }
+}
+
+static bool conn_matches(http_conn_t const* const conn, http_client_config_t const* const config) {
+  return conn->port == config->port && conn->use_tls == config->use_tls && strcmp(conn->host, config->host) == 0;
+}
+
+// an idle connection is readable only if the peer closed it or sent data we did not ask for
+static bool conn_is_alive(http_conn_t* conn) {
+  int fd = -1;
+  if (esp_tls_get_conn_sockfd(conn->tls, &fd) != ESP_OK || fd < 0) {
+    return false;
+  }
+  fd_set rfds;
+  FD_ZERO(&rfds);
+  FD_SET(fd, &rfds);
+  struct timeval tv = {0, 0};
+  return select(fd + 1, &rfds, NULL, NULL, &tv) == 0;
+}
+
+// the time left until a deadline in milliseconds, 0 if it has passed
+static uint32_t time_left_ms(int64_t deadline) {
+  int64_t left_us = deadline - esp_timer_get_time();
+  return left_us > 0 ? (left_us + 999) / 1000 : 0;
+}
+
+static http_conn_t* conn_acquire(http_client_config_t const* const config, int64_t deadline, bool* reused) {
+  if (xSemaphoreTake(pool_slots, pdMS_TO_TICKS(time_left_ms(deadline))) != pdTRUE) {
+    ESP_LOGE(TAG, "no free connection in the pool");
+    return NULL;
+  }
+
+  int64_t now = esp_timer_get_time();
+  http_conn_t* conn = NULL;
+  http_conn_t* free_slot = NULL;
+  http_conn_t* lru = NULL;
+
+  xSemaphoreTake(pool_lock, portMAX_DELAY);
+  for (size_t i = 0; i < HTTP_POOL_MAX_CONNS; i++) {
+    http_conn_t* c = &conn_pool[i];
+    if (c->in_use) {
+      continue;
+    }
+    if (c->tls && now - c->last_used > HTTP_POOL_IDLE_TIMEOUT_US) {
+      conn_close(c);
+      pool_stats.expired++;
+    }
+    if (c->tls == NULL) {
+      free_slot = free_slot ? free_slot : c;
+    } else if (conn_matches(c, config)) {
+      conn = conn ? conn : c;
+    } else if (lru == NULL || c->last_used < lru->last_used) {
+      lru = c;
+    }
+  }
+
+  if (conn && !conn_is_alive(conn)) {
+    conn_close(conn);
+    pool_stats.stale++;
+  }
+
+  *reused = conn && conn->tls;
+  if (conn == NULL) {
+    // pool_slots guarantees at least one slot that is not in use
+    if (free_slot) {
+      conn = free_slot;
+    } else {
+      conn = lru;
+      conn_close(conn);
+      pool_stats.evicted++;
+    }
+    strcpy(conn->host, config->host);
+    conn->port = config->port;
+    conn->use_tls = config->use_tls;
+  }
+  conn->in_use = true;
+  xSemaphoreGive(pool_lock);
+  return conn;
+}
+
+static void conn_release(http_conn_t* conn, bool keep_alive) {
+  if (!keep_alive) {
+    conn_close(conn);
+  }
+  xSemaphoreTake(pool_lock, portMAX_DELAY);
+  conn->last_used = esp_timer_get_time();
+  conn->in_use = false;
+  xSemaphoreGive(pool_lock);
+  xSemaphoreGive(pool_slots);
+}
+
+#if CONFIG_ESP_TLS_CLIENT_SESSION_TICKETS
+static http_tls_session_t* tls_session_find(char const* host, uint16_t port) {
+  for (size_t i = 0; i < HTTP_TLS_SESSION_CACHE_LEN; i++) {
+    if (tls_sessions[i].port == port && strcmp(tls_sessions[i].host, host) == 0) {
+      return &tls_sessions[i];
+    }
+  }
+  return NULL;
+}
+
+// takes the session of an endpoint out of the cache, a session is only used by one handshake at a time
+static esp_tls_client_session_t* tls_session_take(http_conn_t const* conn) {
+  xSemaphoreTake(pool_lock, portMAX_DELAY);
+  http_tls_session_t* entry = tls_session_find(conn->host, conn->port);
+  esp_tls_client_session_t* session = entry ? entry->session : NULL;
+  if (entry) {
+    entry->session = NULL;
+  }
+  xSemaphoreGive(pool_lock);
+  return session;
+}
+
+// stores the session of a new connection, replacing the one of the endpoint or the oldest one
+static void tls_session_store(http_conn_t const* conn, esp_tls_client_session_t* session) {
+  xSemaphoreTake(pool_lock, portMAX_DELAY);
+  http_tls_session_t* entry = tls_session_find(conn->host, conn->port);
+  for (size_t i = 0; entry == NULL && i < HTTP_TLS_SESSION_CACHE_LEN; i++) {
+    if (tls_sessions[i].host[0] == '\0') {
+      entry = &tls_sessions[i];
+    }
+  }
+  if (entry == NULL) {
+    entry = &tls_sessions[0];
+    for (size_t i = 1; i < HTTP_TLS_SESSION_CACHE_LEN; i++) {
+      if (tls_sessions[i].last_used < entry->last_used) {
+        entry = &tls_sessions[i];
+      }
+    }
+  }
+  if (entry->session) {
+    esp_tls_free_client_session(entry->session);
+  }
+  strcpy(entry->host, conn->host);
+  entry->port = conn->port;
+  entry->session = session;
+  entry->last_used = esp_timer_get_time();
+  xSemaphoreGive(pool_lock);
+}
+
+// the server echoes the session ID the client offered if it resumes the session
+static bool tls_session_resumed(esp_tls_t const* tls, esp_tls_client_session_t const* offered) {
+  mbedtls_ssl_session const* session = tls->ssl.session;
+  return offered && session && offered->saved_session.id_len > 0 &&
+         session->id_len == offered->saved_session.id_len &&
+         memcmp(session->id, offered->saved_session.id, session->id_len) == 0;
+}
+#endif
+
+// waits until the socket is readable during the TLS handshake instead of polling it
+static void conn_wait_readable(esp_tls_t* tls, int64_t deadline) {
+  int fd = -1;
+  int64_t left_us = deadline - esp_timer_get_time();
+  if (left_us <= 0 || esp_tls_get_conn_sockfd(tls, &fd) != ESP_OK || fd < 0) {
+    return;
+  }
+  fd_set rfds;
+  FD_ZERO(&rfds);
+  FD_SET(fd, &rfds);
+  struct timeval tv = {.tv_sec = left_us / 1000000, .tv_usec = left_us % 1000000};
+  select(fd + 1, &rfds, NULL, NULL, &tv);
+}
+
+// connects step by step to time the name resolution, the TCP connect and the TLS handshake separately
+static int conn_open(http_conn_t* conn, int64_t deadline, int64_t phases_us[HTTP_PHASE_MAX]) {
+  esp_tls_cfg_t cfg = {
+      .non_block = true,
+      .timeout_ms = time_left_ms(deadline),
+      // the certificate and SNI are checked against the host name, the connection goes to the cached address
+      .common_name = conn->use_tls ? conn->host : NULL,
+      .is_plain_tcp = !conn->use_tls,
+  };
+
+  int64_t start = esp_timer_get_time();
+  char ip[DNS_CACHE_IP_LEN];
+  if (dns_cache_resolve(conn->host, ip, sizeof(ip)) != 0) {
+    ESP_LOGE(TAG, "resolve %s failed", conn->host);
+    return -1;
+  }
+  int64_t connecting = esp_timer_get_time();
+  phases_us[HTTP_PHASE_DNS] = connecting - start;
+
+  esp_tls_t* tls = esp_tls_init();
+  if (tls == NULL) {
+    ESP_LOGE(TAG, "allocate tls handle failed");
+    return -1;
+  }
+#if CONFIG_ESP_TLS_CLIENT_SESSION_TICKETS
+  esp_tls_client_session_t* offered = conn->use_tls ? tls_session_take(conn) : NULL;
+  cfg.client_session = offered;
+#endif
+
+  int ret = 0;
+  int64_t handshake = 0;
+  while ((ret = esp_tls_conn_new_async(ip, strlen(ip), conn->port, &cfg, tls)) == 0) {
+    if (tls->conn_state == ESP_TLS_HANDSHAKE) {
+      handshake = handshake ? handshake : esp_timer_get_time();
+      conn_wait_readable(tls, deadline);
+    }
+    if (esp_timer_get_time() > deadline) {
+      ret = -1;
+      break;
+    }
+  }
+#if CONFIG_ESP_TLS_CLIENT_SESSION_TICKETS
+  if (conn->use_tls && ret == 1) {
+    bool resumed = tls_session_resumed(tls, offered);
+    // a new ticket is sent by the server during the handshake, keep the latest session of the endpoint
+    esp_tls_client_session_t* session = esp_tls_get_client_session(tls);
+    if (session) {
+      tls_session_store(conn, session);
+    }
+    xSemaphoreTake(pool_lock, portMAX_DELAY);
+    if (resumed) {
+      pool_stats.tls_resumed++;
+    } else {
+      pool_stats.tls_full++;
+    }
+    xSemaphoreGive(pool_lock);
+  }
+  if (offered) {
+    // replaced by the session of the new connection, or dropped if the connection failed
+    esp_tls_free_client_session(offered);
+  }
+#endif
+  if (ret != 1) {
+    ESP_LOGE(TAG, "connect to %s:%u (%s) failed", conn->host, conn->port, ip);
+    // the host may have moved, the next connection resolves it again
+    dns_cache_expire(conn->host);
+    esp_tls_conn_delete(tls);
+    return -1;
+  }
+  int64_t done = esp_timer_get_time();
+  handshake = handshake ? handshake : done;
+  phases_us[HTTP_PHASE_CONNECT] = handshake - connecting;
+  if (conn->use_tls) {
+    phases_us[HTTP_PHASE_TLS] = done - handshake;
+  }
+
+  int fd = -1;
+  if (esp_tls_get_conn_sockfd(tls, &fd) == ESP_OK) {
+    // requests are performed with blocking I/O and socket timeouts
+    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL, 0) & ~O_NONBLOCK);
+  }
+  conn->tls = tls;
+  return 0;
+}
+
+// bounds the blocking reads and writes of a request by its deadline
+static void conn_set_timeout(http_conn_t* conn, int64_t deadline) {
+  int fd = -1;
+  if (esp_tls_get_conn_sockfd(conn->tls, &fd) == ESP_OK) {
+    uint32_t timeout_ms = time_left_ms(deadline);
+    timeout_ms = timeout_ms ? timeout_ms : 1;
+    struct timeval tv = {.tv_sec = timeout_ms / 1000, .tv_usec = (timeout_ms % 1000) * 1000};
+    setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+    setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &tv, sizeof(tv));
+  }
+}
+
+static int conn_write_all(http_conn_t* conn, void const* data, size_t len) {
+  size_t written = 0;
+  while (written < len) {
+    ssize_t n = esp_tls_conn_write(conn->tls, (char const*)data + written, len - written);
+    if (n == ESP_TLS_ERR_SSL_WANT_READ || n == ESP_TLS_ERR_SSL_WANT_WRITE) {
+      continue;
+    }
+    if (n <= 0) {
+      ESP_LOGE(TAG, "write to %s failed: %d", conn->host, (int)n);
+      return -1;
+    }
+    written += n;
+  }
+  return 0;
+}
+
+static int conn_send(http_conn_t* conn, http_client_config_t const* const config, http_request_t const* const req) {
+  char head[HTTP_HEAD_MAX_LEN];
+  int len = snprintf(head, sizeof(head), "%s %s HTTP/1.1\r\nHost: %s:%u\r\nAccept: %s\r\nConnection: keep-alive\r\n",
+                     http_method_str(req->method), config->path, config->host, config->port, req->accept);
+#if CONFIG_IOTA_HTTP_COMPRESSION
+  if (len > 0 && (size_t)len < sizeof(head)) {
+    len += snprintf(head + len, sizeof(head) - len, "Accept-Encoding: gzip, deflate\r\n");
+  }
+#endif
+  if (len > 0 && (size_t)len < sizeof(head) && req->body) {
+    len += snprintf(head + len, sizeof(head) - len, "Content-Type: %s\r\nContent-Length: %zu\r\n", req->content_type,
+                    req->body_len);
+  }
+  if (len > 0 && (size_t)len < sizeof(head)) {
+    len += snprintf(head + len, sizeof(head) - len, "\r\n");
+  }
+  if (len <= 0 || (size_t)len >= sizeof(head)) {
+    ESP_LOGE(TAG, "request header is too long: %s", config->path);
+    return -1;
+  }
+
+  if (conn_write_all(conn, head, len) != 0) {
+    return -1;
+  }
+  if (req->body && req->body_len) {
+    return conn_write_all(conn, req->body, req->body_len);
+  }
+  return 0;
+}
+
+static int on_header_field(http_parser* parser, char const* at, size_t length) {
+  http_response_ctx_t* ctx = (http_response_ctx_t*)parser->data;
+  if (ctx->in_value) {
+    ctx->in_value = false;
+    ctx->header_len = 0;
+  }
+  // names can be split across calls, longer names than the buffer are of no interest
+  size_t n = sizeof(ctx->header) - 1 - ctx->header_len;
+  n = length < n ? length : n;
+  memcpy(ctx->header + ctx->header_len, at, n);
+  ctx->header_len += n;
+  ctx->header[ctx->header_len] = '\0';
+  return 0;
+}
+
+static int on_header_value(http_parser* parser, char const* at, size_t length) {
+  http_response_ctx_t* ctx = (http_response_ctx_t*)parser->data;
+  if (!ctx->in_value) {
+    ctx->in_value = true;
+    ctx->is_encoding = strcasecmp(ctx->header, "Content-Encoding") == 0;
+  }
+  if (ctx->is_encoding) {
+    size_t n = sizeof(ctx->encoding) - 1 - ctx->encoding_len;
+    n = length < n ? length : n;
+    memcpy(ctx->encoding + ctx->encoding_len, at, n);
+    ctx->encoding_len += n;
+    ctx->encoding[ctx->encoding_len] = '\0';
+  }
+  return 0;
+}
+
+// the response header is complete, for both HTTP/1.1 and HTTP/2
+static int response_headers(http_response_ctx_t* ctx, long status) {
+  // error responses are always collected so that the caller can parse them
+  ctx->streaming = ctx->req->on_body && status >= 200 && status < 300;
+  ctx->content_encoding = http_encoding_parse(ctx->encoding);
+  if (ctx->encoding_len && ctx->content_encoding == HTTP_ENCODING_IDENTITY &&
+      strcasecmp(ctx->encoding, "identity") != 0) {
+    ESP_LOGE(TAG, "unsupported content encoding: %s", ctx->encoding);
+    return -1;
+  }
+  return 0;
+}
+
+static int on_headers_complete(http_parser* parser) {
+  return response_headers((http_response_ctx_t*)parser->data, parser->status_code);
+}
+
+#if CONFIG_IOTA_HTTP_HEDGE
+// registers the socket of an attempt so that the other attempt can abort it, false if the other one answered already
+static bool hedge_attach(http_conn_t const* conn) {
+  http_hedge_t* h = task_hedge;
+  if (h == NULL) {
+    return true;
+  }
+  int fd = -1;
+  esp_tls_get_conn_sockfd(conn->tls, &fd);
+  xSemaphoreTake(hedge_lock, portMAX_DELAY);
+  bool lost = h->winner != HEDGE_NONE && h->winner != task_hedge_attempt;
+  if (!lost) {
+    h->fds[task_hedge_attempt] = fd;
+  }
+  xSemaphoreGive(hedge_lock);
+  return !lost;
+}
+
+// called before the connection of the attempt is released or closed
+static void hedge_detach() {
+  if (task_hedge) {
+    xSemaphoreTake(hedge_lock, portMAX_DELAY);
+    task_hedge->fds[task_hedge_attempt] = -1;
+    xSemaphoreGive(hedge_lock);
+  }
+}
+
+static void hedge_answered() {
+  if (task_hedge && task_hedge_attempt == HEDGE_PRIMARY) {
+    xSemaphoreTake(hedge_lock, portMAX_DELAY);
+    task_hedge->answered = true;
+    xSemaphoreGive(hedge_lock);
+  }
+}
+
+// the other attempt of the request answered first
+static bool hedge_lost() {
+  bool lost = false;
+  if (task_hedge) {
+    xSemaphoreTake(hedge_lock, portMAX_DELAY);
+    lost = task_hedge->winner != HEDGE_NONE && task_hedge->winner != task_hedge_attempt;
+    xSemaphoreGive(hedge_lock);
+  }
+  return lost;
+}
+
+// must be called with hedge_lock held
+static void hedge_win(http_hedge_t* h, http_hedge_attempt_t attempt) {
+  h->winner = attempt;
+  http_hedge_attempt_t other = attempt == HEDGE_PRIMARY ? HEDGE_SECONDARY : HEDGE_PRIMARY;
+  h->aborted[other] = true;
+  if (h->fds[other] >= 0) {
+    // unblocks the other attempt, its connection is closed by the task performing it
+    shutdown(h->fds[other], SHUT_RDWR);
+  }
+}
+#else
+static bool hedge_attach(http_conn_t const* conn) { return true; }
+static void hedge_detach() {}
+static void hedge_answered() {}
+static bool hedge_lost() { return false; }
+#endif
+
+// passes the decoded body to the caller
+static int body_deliver(byte_t const* data, size_t len, void* arg) {
+  http_response_ctx_t* ctx = (http_response_ctx_t*)arg;
+  if (ctx->streaming) {
+    return ctx->req->on_body(data, len, ctx->req->ctx);
+  }
+  if (ctx->body == NULL) {
+    return 0;
+  }
+  return byte_buf_append(ctx->body, data, len) ? 0 : -1;
+}
+
+static int response_body(http_response_ctx_t* ctx, byte_t const* data, size_t len) {
+  ctx->body_received += len;
+  if (ctx->content_encoding == HTTP_ENCODING_IDENTITY) {
+    return body_deliver(data, len, ctx);
+  }
+  if (ctx->inflate == NULL && (ctx->inflate = http_inflate_new(ctx->content_encoding, body_deliver, ctx)) == NULL) {
+    return -1;
+  }
+  return http_inflate_feed(ctx->inflate, data, len);
+}
+
+static int response_complete(http_response_ctx_t* ctx) {
+  if (ctx->inflate && http_inflate_finish(ctx->inflate) != 0) {
+    ESP_LOGE(TAG, "incomplete compressed body");
+    return -1;
+  }
+  ctx->complete = true;
+  return 0;
+}
+
+static int on_body(http_parser* parser, char const* at, size_t length) {
+  return response_body((http_response_ctx_t*)parser->data, (byte_t const*)at, length);
+}
+
+static int on_message_complete(http_parser* parser) { return response_complete((http_response_ctx_t*)parser->data); }
+
+static int conn_recv(http_conn_t* conn, http_response_ctx_t* ctx, int64_t deadline, long* status, bool* keep_alive) {
+  http_parser_settings settings = {
+      .on_header_field = on_header_field,
+      .on_header_value = on_header_value,
+      .on_headers_complete = on_headers_complete,
+      .on_body = on_body,
+      .on_message_complete = on_message_complete,
+  };
+  http_parser parser;
+  http_parser_init(&parser, HTTP_RESPONSE);
+  parser.data = ctx;
+
+  char buf[HTTP_RX_BUF_LEN];
+  while (!ctx->complete) {
+    ssize_t n = esp_tls_conn_read(conn->tls, buf, sizeof(buf));
+    if (n == ESP_TLS_ERR_SSL_WANT_READ || n == ESP_TLS_ERR_SSL_WANT_WRITE) {
+      if (esp_timer_get_time() > deadline) {
+        ESP_LOGE(TAG, "read from %s timed out", conn->host);
+        return -1;
+      }
+      continue;
+    }
+    if (n < 0) {
+      ESP_LOGE(TAG, "read from %s failed: %d", conn->host, (int)n);
+      return -1;
+    }
+    if (ctx->received == 0 && n > 0) {
+      ctx->first_byte = esp_timer_get_time();
+      hedge_answered();
+    }
+    ctx->received += n;
+    // a zero length read tells the parser about the end of the stream
+    http_parser_execute(&parser, &settings, buf, n);
+    if (HTTP_PARSER_ERRNO(&parser) != HPE_OK) {
+      ESP_LOGE(TAG, "parse response from %s failed: %s", conn->host,
+               http_errno_description(HTTP_PARSER_ERRNO(&parser)));
+      return -1;
+    }
+    if (n == 0) {
+      break;
+    }
+  }
+
+  if (!ctx->complete) {
+    ESP_LOGE(TAG, "connection to %s closed before the response was complete", conn->host);
+    return -1;
+  }
+  *status = parser.status_code;
+  *keep_alive = http_should_keep_alive(&parser);
+  return 0;
+}
+
+#if CONFIG_IOTA_HTTP2
+// the flag that aborts the stream of the calling task once the other attempt of its hedged request answered
+static bool volatile* hedge_abort_flag() {
+#if CONFIG_IOTA_HTTP_HEDGE
+  return task_hedge ? &task_hedge->aborted[task_hedge_attempt] : NULL;
+#else
+  return NULL;
+#endif
+}
+
+static int h2_on_headers(long status, char const* content_encoding, void* arg) {
+  http_response_ctx_t* ctx = (http_response_ctx_t*)arg;
+  ctx->encoding_len = snprintf(ctx->encoding, sizeof(ctx->encoding), "%s", content_encoding);
+  return response_headers(ctx, status);
+}
+
+static int h2_on_data(byte_t const* data, size_t len, void* arg) {
+  return response_body((http_response_ctx_t*)arg, data, len);
+}
+
+static int h2_on_complete(void* arg) { return response_complete((http_response_ctx_t*)arg); }
+
+// sends a request as a stream of the HTTP/2 connection, HTTP2_ERR_UNAVAILABLE if it has to be sent with HTTP/1.1
+static int http_perform_h2(http_client_config_t const* const config, http_request_t const* const req,
+                           byte_buf_t* const response, int64_t deadline, long* status, bool* received) {
+  if (hedge_lost()) {
+    return -1;
+  }
+  http_response_ctx_t ctx = {.req = req, .body = response};
+  http2_request_t h2_req = {.method = http_method_str(req->method),
+                            .host = config->host,
+                            .port = config->port,
+                            .use_tls = config->use_tls,
+                            .path = config->path,
+                            .accept = req->accept,
+                            .content_type = req->content_type,
+                            .body = req->body,
+                            .body_len = req->body_len,
+                            .abort = hedge_abort_flag()};
+  http2_response_cb_t cb = {
+      .on_headers = h2_on_headers, .on_data = h2_on_data, .on_complete = h2_on_complete, .ctx = &ctx};
+  http2_timing_t timing = {};
+  int ret = http2_perform(&h2_req, &cb, deadline, status, &timing);
+  if (ret == HTTP2_ERR_UNAVAILABLE) {
+    return ret;
+  }
+
+  *received = timing.received > 0;
+  // the connection is shared, its setup is not a phase of the request
+  int64_t phases_us[HTTP_PHASE_MAX] = {-1, -1, -1, -1, -1, -1};
+  if (timing.first_byte) {
+    phases_us[HTTP_PHASE_WAIT] = timing.first_byte - timing.sent;
+    phases_us[HTTP_PHASE_TRANSFER] = esp_timer_get_time() - timing.first_byte;
+  }
+  xSemaphoreTake(pool_lock, portMAX_DELAY);
+  pool_stats.requests++;
+  if (ret != 0) {
+    pool_stats.errors++;
+  }
+  if (ctx.inflate) {
+    pool_stats.compressed++;
+    pool_stats.compressed_bytes += ctx.body_received;
+    pool_stats.inflated_bytes += http_inflate_total_out(ctx.inflate);
+    pool_stats.inflate_us += http_inflate_time_us(ctx.inflate);
+  }
+  xSemaphoreGive(pool_lock);
+  if (ctx.inflate) {
+    http_inflate_free(ctx.inflate);
+  }
+
+#if CONFIG_IOTA_HTTP_STATS
+  http_stats_record(http_method_str(req->method), config->path, phases_us, ret == 0);
+#endif
+  return ret;
+}
+#endif
+
+// performs a request on a given endpoint, received tells if any data came back
+static int http_perform_on(http_client_config_t const* const config, http_request_t const* const req,
+                           byte_buf_t* const response, long* status, bool* received) {
+  if (strlen(config->host) >= HTTP_HOST_MAX_LEN) {
+    ESP_LOGE(TAG, "host name is too long");
+    return -1;
+  }
+
+  int64_t deadline = esp_timer_get_time() + (int64_t)HTTP_TIMEOUT_MS * 1000;
+  if (task_deadline_us && task_deadline_us < deadline) {
+    deadline = task_deadline_us;
+  }
+  if (time_left_ms(deadline) == 0) {
+    ESP_LOGE(TAG, "deadline of the request has passed");
+    return -1;
+  }
+
+#if CONFIG_IOTA_HTTP2
+  int h2_ret = http_perform_h2(config, req, response, deadline, status, received);
+  if (h2_ret != HTTP2_ERR_UNAVAILABLE) {
+    return h2_ret;
+  }
+#endif
+
+  bool reused = false;
+  http_conn_t* conn = conn_acquire(config, deadline, &reused);
+  if (conn == NULL) {
+    return -1;
+  }
+
+  int ret = -1;
+  bool keep_alive = false;
+  bool stale = false;
+  size_t compressed = 0, inflated = 0;
+  int64_t inflate_us = 0;
+  // phases that did not happen stay negative
+  int64_t phases_us[HTTP_PHASE_MAX] = {-1, -1, -1, -1, -1, -1};
+  for (int attempt = 0; attempt < 2; attempt++) {
+    http_response_ctx_t ctx = {.req = req, .body = response};
+    if (conn->tls == NULL && conn_open(conn, deadline, phases_us) != 0) {
+      break;
+    }
+    conn_set_timeout(conn, deadline);
+    if (hedge_attach(conn) && conn_send(conn, config, req) == 0) {
+      int64_t sent = esp_timer_get_time();
+      ret = conn_recv(conn, &ctx, deadline, status, &keep_alive);
+      if (ctx.received) {
+        phases_us[HTTP_PHASE_WAIT] = ctx.first_byte - sent;
+        phases_us[HTTP_PHASE_TRANSFER] = esp_timer_get_time() - ctx.first_byte;
+      }
+    }
+    hedge_detach();
+    if (ctx.inflate) {
+      compressed = ctx.body_received;
+      inflated = http_inflate_total_out(ctx.inflate);
+      inflate_us = http_inflate_time_us(ctx.inflate);
+      http_inflate_free(ctx.inflate);
+    }
+    *received = ctx.received > 0;
+    if (ret == 0) {
+      break;
+    }
+    conn_close(conn);
+    if (!reused || ctx.received > 0 || hedge_lost()) {
+      break;
+    }
+    // the peer dropped the pooled connection in the meantime, retry once on a new one
+    reused = false;
+    stale = true;
+  }
+  conn_release(conn, ret == 0 && keep_alive);
+
+  xSemaphoreTake(pool_lock, portMAX_DELAY);
+  pool_stats.requests++;
+  if (reused) {
+    pool_stats.reused++;
+  } else {
+    pool_stats.missed++;
+  }
+  if (stale) {
+    pool_stats.stale++;
+  }
+  if (ret != 0) {
+    pool_stats.errors++;
+  }
+  if (compressed) {
+    pool_stats.compressed++;
+    pool_stats.compressed_bytes += compressed;
+    pool_stats.inflated_bytes += inflated;
+    pool_stats.inflate_us += inflate_us;
+  }
+  xSemaphoreGive(pool_lock);
+
+#if CONFIG_IOTA_HTTP_STATS
+  http_stats_record(http_method_str(req->method), config->path, phases_us, ret == 0);
+#endif
+  return ret;
+}
+
+// requests to a node of the node set go to the best node and fail over to the others on connection errors
+static int http_perform_routed(http_client_config_t const* const config, http_request_t const* const req,
+                               byte_buf_t* const response, long* status, bool* received) {
+  iota_client_conf_t node;
+  int idx = node_set_route(config, 0, &node);
+  if (idx < 0) {
+    return http_perform_on(config, req, response, status, received);
+  }
+
+  int ret = -1;
+  uint32_t tried = 0;
+  for (; idx >= 0; idx = node_set_route(config, tried, &node)) {
+    http_client_config_t routed = {.host = node.host, .path = config->path, .port = node.port, .use_tls = node.use_tls};
+#if CONFIG_IOTA_HTTP_HEDGE
+    if (task_hedge) {
+      // the secondary attempt goes to another node
+      xSemaphoreTake(hedge_lock, portMAX_DELAY);
+      task_hedge->primary_node = idx;
+      xSemaphoreGive(hedge_lock);
+    }
+#endif
+    *received = false;
+    ret = http_perform_on(&routed, req, response, status, received);
+    // an attempt aborted by its hedge says nothing about the node
+    if (hedge_lost()) {
+      break;
+    }
+    node_set_report(idx, ret == 0 || *received);
+    // data was already passed to the caller, the request cannot be repeated
+    if (ret == 0 || *received) {
+      break;
+    }
+    ESP_LOGW(TAG, "request to %s:%u failed, trying the next node", node.host, node.port);
+    tried |= 1u << idx;
+  }
+  return ret;
+}
+
+#if CONFIG_IOTA_HTTP_HEDGE
+static void hedge_unref(http_hedge_t* h) {
+  xSemaphoreTake(hedge_lock, portMAX_DELAY);
+  bool last = --h->refs == 0;
+  xSemaphoreGive(hedge_lock);
+  if (last) {
+    vSemaphoreDelete(h->cancel);
+    vSemaphoreDelete(h->done);
+    byte_buf_free(h->body);
+    free(h);
+  }
+}
+
+// the secondary attempt is sent once the primary one is slower than most requests of the endpoint
+static uint32_t hedge_delay_ms(char const* path) {
+  uint32_t delay_ms = CONFIG_IOTA_HTTP_HEDGE_MIN_DELAY_MS;
+#if CONFIG_IOTA_HTTP_STATS
+  uint32_t samples = 0;
+  uint32_t pct_ms =
+      http_stats_endpoint_percentile_ms("GET", path, HTTP_PHASE_WAIT, CONFIG_IOTA_HTTP_HEDGE_PERCENTILE, &samples);
+  if (samples >= HTTP_HEDGE_MIN_SAMPLES && pct_ms > delay_ms) {
+    delay_ms = pct_ms;
+  }
+#endif
+  return delay_ms;
+}
+
+// sends the secondary attempt on the hedge task
+static void hedge_send(http_hedge_t* h) {
+  http_client_config_t same = {.host = h->host, .path = h->path, .port = h->port, .use_tls = h->use_tls};
+  iota_client_conf_t node;
+  // another node than the one of the primary attempt if there is one, otherwise the same endpoint
+  int idx = node_set_route(&same, h->primary_node >= 0 ? 1u << h->primary_node : 0, &node);
+  http_client_config_t other = {.host = node.host, .path = h->path, .port = node.port, .use_tls = node.use_tls};
+  http_request_t req = {.method = HTTP_GET, .accept = h->accept};
+
+  task_hedge = h;
+  task_hedge_attempt = HEDGE_SECONDARY;
+  task_deadline_us = h->deadline;
+  bool received = false;
+  int ret = http_perform_on(idx >= 0 ? &other : &same, &req, h->body, &h->status, &received);
+  task_deadline_us = 0;
+  task_hedge = NULL;
+
+  xSemaphoreTake(hedge_lock, portMAX_DELAY);
+  bool lost = h->winner != HEDGE_NONE;
+  if (ret == 0 && !lost) {
+    hedge_win(h, HEDGE_SECONDARY);
+  }
+  xSemaphoreGive(hedge_lock);
+  if (idx >= 0 && !lost) {
+    node_set_report(idx, ret == 0 || received);
+  }
+}
+
+static void hedge_task(void* arg) {
+  for (;;) {
+    http_hedge_t* h = NULL;
+    if (xQueueReceive(hedge_queue, &h, portMAX_DELAY) != pdTRUE) {
+      continue;
+    }
+
+    // the caller gives cancel once its attempt completed
+    int64_t wait_us = h->start_at - esp_timer_get_time();
+    bool cancelled = xSemaphoreTake(h->cancel, wait_us > 0 ? pdMS_TO_TICKS((wait_us + 999) / 1000) : 0) == pdTRUE;
+
+    xSemaphoreTake(hedge_lock, portMAX_DELAY);
+    h->started = !cancelled && h->winner == HEDGE_NONE && !h->answered && time_left_ms(h->deadline) > 0;
+    bool run = h->started;
+    xSemaphoreGive(hedge_lock);
+
+    if (run) {
+      xSemaphoreTake(pool_lock, portMAX_DELAY);
+      pool_stats.hedged++;
+      xSemaphoreGive(pool_lock);
+      hedge_send(h);
+      xSemaphoreGive(h->done);
+    }
+    hedge_unref(h);
+  }
+}
+
+static bool hedge_init() {
+  if (hedge_lock == NULL) {
+    hedge_lock = xSemaphoreCreateMutex();
+    hedge_queue = xQueueCreate(HTTP_HEDGE_QUEUE_LEN, sizeof(http_hedge_t*));
+    if (hedge_lock == NULL || hedge_queue == NULL ||
+        xTaskCreate(hedge_task, "http_hedge", CONFIG_IOTA_CLIENT_TASK_STACK_SIZE, NULL, tskIDLE_PRIORITY + 5, NULL) !=
+            pdPASS) {
+      ESP_LOGE(TAG, "start hedge task failed");
+      return false;
+    }
+  }
+  return true;
+}
+
+// queues the secondary attempt of a request to the hedge task, NULL if the request is not hedged
+static http_hedge_t* hedge_new(http_client_config_t const* const config, http_request_t const* const req,
+                               int64_t deadline) {
+  size_t path_len = strlen(config->path) + 1;
+  size_t accept_len = strlen(req->accept) + 1;
+  if (hedge_queue == NULL || strlen(config->host) >= HTTP_HOST_MAX_LEN) {
+    return NULL;
+  }
+  http_hedge_t* h = calloc(1, sizeof(http_hedge_t) + path_len + accept_len);
+  byte_buf_t* body = byte_buf_new();
+  if (h == NULL || body == NULL) {
+    free(h);
+    byte_buf_free(body);
+    return NULL;
+  }
+
+  strcpy(h->host, config->host);
+  h->path = (char*)(h + 1);
+  memcpy(h->path, config->path, path_len);
+  h->accept = h->path + path_len;
+  memcpy(h->accept, req->accept, accept_len);
+  h->port = config->port;
+  h->use_tls = config->use_tls;
+  h->primary_node = -1;
+  h->start_at = esp_timer_get_time() + (int64_t)hedge_delay_ms(config->path) * 1000;
+  h->deadline = deadline;
+  h->fds[HEDGE_PRIMARY] = h->fds[HEDGE_SECONDARY] = -1;
+  h->winner = HEDGE_NONE;
+  h->body = body;
+  h->cancel = xSemaphoreCreateBinaryStatic(&h->cancel_buf);
+  h->done = xSemaphoreCreateBinaryStatic(&h->done_buf);
+  h->refs = 2;
+  if (xQueueSend(hedge_queue, &h, 0) != pdTRUE) {
+    // the hedge task is busy with other requests
+    byte_buf_free(body);
+    free(h);
+    return NULL;
+  }
+  return h;
+}
+
+// performs a request and sends a duplicate of it if it does not answer within the hedge delay
+static int http_perform_hedged(http_client_config_t const* const config, http_request_t const* const req,
+                               byte_buf_t* const response, long* status, bool* received) {
+  int64_t deadline = esp_timer_get_time() + (int64_t)HTTP_TIMEOUT_MS * 1000;
+  if (task_deadline_us && task_deadline_us < deadline) {
+    deadline = task_deadline_us;
+  }
+  http_hedge_t* h = hedge_new(config, req, deadline);
+  if (h == NULL) {
+    return http_perform_routed(config, req, response, status, received);
+  }
+
+  size_t response_start = response->len;
+  task_hedge = h;
+  task_hedge_attempt = HEDGE_PRIMARY;
+  int ret = http_perform_routed(config, req, response, status, received);
+  task_hedge = NULL;
+
+  xSemaphoreTake(hedge_lock, portMAX_DELAY);
+  if (ret == 0) {
+    hedge_win(h, HEDGE_PRIMARY);
+  }
+  bool wait = h->winner == HEDGE_NONE && h->started;
+  xSemaphoreGive(hedge_lock);
+  // the hedge task does not send the secondary attempt anymore
+  xSemaphoreGive(h->cancel);
+  if (wait) {
+    // the primary attempt failed, the secondary one may still answer
+    xSemaphoreTake(h->done, pdMS_TO_TICKS(time_left_ms(deadline)));
+  }
+
+  xSemaphoreTake(hedge_lock, portMAX_DELAY);
+  bool use_secondary = ret != 0 && h->winner == HEDGE_SECONDARY;
+  if (!use_secondary) {
+    // a late response of the secondary attempt is dropped
+    h->winner = HEDGE_PRIMARY;
+  }
+  xSemaphoreGive(hedge_lock);
+
+  if (use_secondary) {
+    // drop what the aborted primary attempt collected
+    response->len = response_start;
+    if (byte_buf_append(response, h->body->data, h->body->len)) {
+      *status = h->status;
+      *received = true;
+      ret = 0;
+      xSemaphoreTake(pool_lock, portMAX_DELAY);
+      pool_stats.hedge_wins++;
+      xSemaphoreGive(pool_lock);
+    }
+  }
+  hedge_unref(h);
+  return ret;
+}
+#endif
+
+static int http_perform_attempt(http_client_config_t const* const config, http_request_t const* const req,
+                                byte_buf_t* const response, long* status, bool* received) {
+#if CONFIG_IOTA_HTTP_HEDGE
+  // only collected responses can be duplicated, a streamed body is passed to the caller while it is received
+  if (req->method == HTTP_GET && req->on_body == NULL) {
+    return http_perform_hedged(config, req, response, status, received);
+  }
+#endif
+  return http_perform_routed(config, req, response, status, received);
+}
+
+// idempotent requests are repeated on connection errors and on responses of overloaded or unavailable nodes
+static bool http_should_retry(http_request_t const* const req, int ret, long status, bool received) {
+  if (req->method != HTTP_GET) {
+    return false;
+  }
+  if (ret != 0) {
+    // a streamed body cannot be taken back once parts of it were passed to the caller
+    return req->on_body == NULL || !received;
+  }
+  return status == 429 || status == 502 || status == 503 || status == 504;
+}
+
+// exponential backoff with jitter, half of the delay is random so that clients do not retry in lockstep
+static uint32_t http_retry_delay_ms(int retry) {
+  uint32_t backoff_ms = (uint32_t)CONFIG_IOTA_HTTP_RETRY_BACKOFF_MS << retry;
+  return backoff_ms / 2 + esp_random() % (backoff_ms / 2 + 1);
+}
+
+// answers a request from the cache of immutable responses
+static bool http_cache_lookup(http_client_config_t const* const config, http_request_t const* const req,
+                              byte_buf_t* const response, long* status) {
+  if (req->on_body == NULL) {
+    if (!http_cache_get(config, req->accept, response)) {
+      return false;
+    }
+    *status = 200;
+    return true;
+  }
+
+  byte_buf_t* body = byte_buf_new();
+  bool hit = body && http_cache_get(config, req->accept, body);
+  // a failing callback aborts the request like a received body would, the response is not sent again
+  if (hit && req->on_body(body->data, body->len, req->ctx) == 0) {
+    *status = 200;
+  } else if (hit) {
+    *status = 0;
+  }
+  byte_buf_free(body);
+  return hit;
+}
+
+// sends a request, retrying failed attempts
+static int http_perform_retries(http_client_config_t const* const config, http_request_t const* const req,
+                                byte_buf_t* const response, long* status) {
+  size_t response_start = response ? response->len : 0;
+  int ret = -1;
+  for (int retry = 0;; retry++) {
+    bool received = false;
+    ret = http_perform_attempt(config, req, response, status, &received);
+    if (retry >= CONFIG_IOTA_HTTP_RETRIES || !http_should_retry(req, ret, *status, received)) {
+      break;
+    }
+    uint32_t delay_ms = http_retry_delay_ms(retry);
+    if (task_deadline_us && esp_timer_get_time() + (int64_t)delay_ms * 1000 >= task_deadline_us) {
+      break;
+    }
+    ESP_LOGW(TAG, "retry %s in %" PRIu32 " ms", config->path, delay_ms);
+    vTaskDelay(pdMS_TO_TICKS(delay_ms));
+    if (response) {
+      // drop the error response of the failed attempt
+      response->len = response_start;
+    }
+    xSemaphoreTake(pool_lock, portMAX_DELAY);
+    pool_stats.retries++;
+    xSemaphoreGive(pool_lock);
+  }
+  return ret;
+}
+
+// outputs and block metadata are requested by the wallet, the batch workers, the confirmation tracker and the console
+static bool http_shareable(http_client_config_t const* const config, http_request_t const* const req) {
+  if (req->method != HTTP_GET) {
+    return false;
+  }
+  char const* p = config->path;
+  if (strncmp(p, HTTP_SHARED_OUTPUTS_PATH, strlen(HTTP_SHARED_OUTPUTS_PATH)) == 0) {
+    p += strlen(HTTP_SHARED_OUTPUTS_PATH);
+    return strncmp(p, "0x", 2) == 0 && strspn(p + 2, HTTP_HEX_DIGITS) == HTTP_SHARED_OUTPUT_ID_HEX_LEN &&
+           p[2 + HTTP_SHARED_OUTPUT_ID_HEX_LEN] == '\0';
+  }
+  if (strncmp(p, HTTP_SHARED_BLOCKS_PATH, strlen(HTTP_SHARED_BLOCKS_PATH)) == 0) {
+    p += strlen(HTTP_SHARED_BLOCKS_PATH);
+    return strncmp(p, "0x", 2) == 0 && strspn(p + 2, HTTP_HEX_DIGITS) == HTTP_SHARED_BLOCK_ID_HEX_LEN &&
+           strcmp(p + 2 + HTTP_SHARED_BLOCK_ID_HEX_LEN, "/metadata") == 0;
+  }
+  return false;
+}
+
+typedef struct {
+  byte_buf_t* body;  ///< the response body
+  long status;       ///< the HTTP status code
+} http_shared_response_t;
+
+static void http_shared_free(void* res) {
+  http_shared_response_t* shared = (http_shared_response_t*)res;
+  byte_buf_free(shared->body);
+  free(shared);
+}
+
+// makes the request of a flight, the body is always collected so that every caller can use it
+static int http_shared_fetch(iota_client_conf_t const* conf, char const path[], void* ctx, void** res) {
+  http_request_t req = *(http_request_t const*)ctx;
+  req.on_body = NULL;
+  req.ctx = NULL;
+  http_shared_response_t* shared = calloc(1, sizeof(http_shared_response_t));
+  if (shared == NULL || (shared->body = byte_buf_new()) == NULL) {
+    free(shared);
+    return -1;
+  }
+  http_client_config_t config = {.host = conf->host, .path = path, .port = conf->port, .use_tls = conf->use_tls};
+  int ret = http_perform_retries(&config, &req, shared->body, &shared->status);
+  if (ret != 0) {
+    http_shared_free(shared);
+    return ret;
+  }
+  *res = shared;
+  return 0;
+}
+
+// identical requests in flight send one request and share its response, see single_flight.h
+static int http_perform_shared(http_client_config_t const* const config, http_request_t const* const req,
+                               byte_buf_t* const response, long* status) {
+  iota_client_conf_t conf = {.port = config->port, .use_tls = config->use_tls};
+  if (strlen(config->host) >= sizeof(conf.host)) {
+    return http_perform_retries(config, req, response, status);
+  }
+  strcpy(conf.host, config->host);
+
+  http_shared_response_t* shared = NULL;
+  int ret = single_flight_do(&conf, req->accept, config->path, http_shared_fetch, (void*)req, http_shared_free,
+                             (void**)&shared);
+  if (ret != 0) {
+    return ret;
+  }
+  *status = shared->status;
+  byte_buf_t const* body = shared->body;
+  // like a received response, only successful bodies are streamed
+  if (req->on_body && shared->status >= 200 && shared->status < 300) {
+    ret = body->len == 0 || req->on_body(body->data, body->len, req->ctx) == 0 ? 0 : -1;
+  } else if (response && body->len > 0 && !byte_buf_append(response, body->data, body->len)) {
+    ret = -1;
+  }
+  single_flight_release(shared);
+  return ret;
+}
+
+static int http_perform(http_client_config_t const* const config, http_request_t const* const req,
+                        byte_buf_t* const response, long* status) {
+  if (config == NULL || config->host == NULL || config->path == NULL || status == NULL ||
+      (response == NULL && req->on_body == NULL)) {
+    ESP_LOGE(TAG, "invalid parameters");
+    return -1;
+  }
+
+  http_client_init();
+
+  // immutable responses are the same on every node of the endpoint
+  bool cacheable = req->method == HTTP_GET && http_cache_cacheable(config->path);
+  if (cacheable && http_cache_lookup(config, req, response, status)) {
+    return *status == 200 ? 0 : -1;
+  }
+  if (http_shareable(config, req)) {
+    return http_perform_shared(config, req, response, status);
+  }
+  size_t response_start = response ? response->len : 0;
+
+  int ret = http_perform_retries(config, req, response, status);
+  // streamed bodies are not collected, they are cached once a caller asks for a buffer
+  if (cacheable && ret == 0 && *status == 200 && req->on_body == NULL) {
+    http_cache_put(config, req->accept, response->data + response_start, response->len - response_start);
+  }
+  return ret;
+}
+
+// the application calls it once at startup, before tasks send requests concurrently
+void http_client_init() {
+  if (pool_lock == NULL) {
+    pool_lock = xSemaphoreCreateMutex();
+    pool_slots = xSemaphoreCreateCounting(HTTP_POOL_MAX_CONNS, HTTP_POOL_MAX_CONNS);
+#if CONFIG_IOTA_HTTP_HEDGE
+    hedge_init();
+#endif
+#if CONFIG_IOTA_HTTP2
+    http2_init();
+#endif
+  }
+}
+
+void http_client_clean() { http_pool_flush(); }
+
+void http_client_set_deadline(int64_t deadline_us) { task_deadline_us = deadline_us; }
+
+int http_client_post_ex(http_client_config_t const* const config, http_request_opts_t const* const opts,
+                        byte_buf_t const* const request, byte_buf_t* const response, long* status) {
+  http_request_t req = {.method = HTTP_POST,
+                        .accept = opts && opts->accept ? opts->accept : HTTP_CONTENT_JSON,
+                        .content_type = opts && opts->content_type ? opts->content_type : HTTP_CONTENT_JSON,
+                        .body = NULL,
+                        .body_len = 0,
+                        .on_body = opts ? opts->on_body : NULL,
+                        .ctx = opts ? opts->ctx : NULL};
+  if (request && request->data) {
+    req.body = request->data;
+    req.body_len = request->len;
+    // JSON bodies are strings, do not send the terminator if it is counted in
+    if (strcmp(req.content_type, HTTP_CONTENT_JSON) == 0 && req.body_len && req.body[req.body_len - 1] == '\0') {
+      req.body_len--;
+    }
+  }
+  return http_perform(config, &req, response, status);
+}
+
+int http_client_get_ex(http_client_config_t const* const config, http_request_opts_t const* const opts,
+                       byte_buf_t* const response, long* status) {
+  http_request_t req = {.method = HTTP_GET,
+                        .accept = opts && opts->accept ? opts->accept : HTTP_CONTENT_JSON,
+                        .content_type = NULL,
+                        .body = NULL,
+                        .body_len = 0,
+                        .on_body = opts ? opts->on_body : NULL,
+                        .ctx = opts ? opts->ctx : NULL};
+  return http_perform(config, &req, response, status);
+}
+
+int http_client_post(http_client_config_t const* const config, byte_buf_t const* const request,
+                     byte_buf_t* const response, long* status) {
+  return http_client_post_ex(config, NULL, request, response, status);
+}
+
+int http_client_get(http_client_config_t const* const config, byte_buf_t* const response, long* status) {
+  return http_client_get_ex(config, NULL, response, status);
+}
+
+void http_pool_get_stats(http_pool_stats_t* stats) {
+  http_client_init();
+  xSemaphoreTake(pool_lock, portMAX_DELAY);
+  *stats = pool_stats;
+  stats->open = 0;
+  stats->in_use = 0;
+  for (size_t i = 0; i < HTTP_POOL_MAX_CONNS; i++) {
+    stats->open += conn_pool[i].tls ? 1 : 0;
+    stats->in_use += conn_pool[i].in_use ? 1 : 0;
+  }
+  xSemaphoreGive(pool_lock);
+#if CONFIG_IOTA_HTTP2
+  http2_get_stats(stats);
+#endif
+}
+
+void http_pool_reset_stats() {
+  http_client_init();
+  xSemaphoreTake(pool_lock, portMAX_DELAY);
+  memset(&pool_stats, 0, sizeof(pool_stats));
+  xSemaphoreGive(pool_lock);
+#if CONFIG_IOTA_HTTP2
+  http2_reset_stats();
+#endif
+}
+
+void http_pool_flush() {
+  http_client_init();
+  xSemaphoreTake(pool_lock, portMAX_DELAY);
+  for (size_t i = 0; i < HTTP_POOL_MAX_CONNS; i++) {
+    if (!conn_pool[i].in_use) {
+      conn_close(&conn_pool[i]);
+    }
+  }
+  xSemaphoreGive(pool_lock);
+#if CONFIG_IOTA_HTTP2
+  http2_flush();
+#endif
+}
+
+bool http_pool_set_http2(bool enable) {
+#if CONFIG_IOTA_HTTP2
+  return http2_set_enabled(enable);
+#else
+  return false;
+#endif
+}
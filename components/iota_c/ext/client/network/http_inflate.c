@@ -0,0 +1,268 @@
+// Copyright 2022 IOTA Stiftung
+// SPDX-License-Identifier: Apache-2.0
+
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+
+#include "esp_rom_crc.h"
+#include "esp_timer.h"
+#include "sdkconfig.h"
+
+// the decompressor of the ROM
+#if CONFIG_IDF_TARGET_ESP32
+#include "esp32/rom/miniz.h"
+#elif CONFIG_IDF_TARGET_ESP32S2
+#include "esp32s2/rom/miniz.h"
+#elif CONFIG_IDF_TARGET_ESP32S3
+#include "esp32s3/rom/miniz.h"
+#elif CONFIG_IDF_TARGET_ESP32C3
+#include "esp32c3/rom/miniz.h"
+#endif
+
+#include "client/network/http_inflate.h"
+
+#define GZIP_HEADER_LEN 10
+#define GZIP_TRAILER_LEN 8
+#define GZIP_FLAG_HCRC 0x02
+#define GZIP_FLAG_EXTRA 0x04
+#define GZIP_FLAG_NAME 0x08
+#define GZIP_FLAG_COMMENT 0x10
+
+typedef enum {
+  GZ_HEADER = 0,  ///< the fixed part of the gzip header
+  GZ_EXTRA_LEN,   ///< the length of the extra field
+  GZ_EXTRA,       ///< the extra field
+  GZ_NAME,        ///< the zero terminated file name
+  GZ_COMMENT,     ///< the zero terminated comment
+  GZ_HCRC,        ///< the CRC16 of the header
+  GZ_DATA,        ///< the deflate stream
+  GZ_TRAILER,     ///< the CRC32 and size of the data
+  GZ_DONE,        ///< the stream is complete
+} inflate_state_e;
+
+struct http_inflate {
+  inflate_state_e state;            ///< the position in the stream
+  http_encoding_t encoding;         ///< gzip or deflate
+  http_body_cb sink;                ///< receives the decompressed data
+  void* ctx;                        ///< the context of the sink
+  byte_t flags;                     ///< the gzip header flags
+  byte_t field[GZIP_HEADER_LEN];    ///< collects fixed size fields
+  size_t field_len;                 ///< the collected length of the field
+  size_t skip;                      ///< the bytes left of the extra field
+  size_t dict_ofs;                  ///< the write position in the window
+  size_t total_out;                 ///< the decompressed bytes
+  uint32_t crc;                     ///< the CRC32 of the decompressed bytes of a gzip member
+  int64_t time_us;                  ///< the time spent in the decompressor
+  tinfl_decompressor decomp;        ///< the decompressor state
+  byte_t dict[TINFL_LZ_DICT_SIZE];  ///< the window, decompressed data is passed to the sink from here
+};
+
+// collect a fixed size field, returns the bytes consumed
+static size_t field_collect(http_inflate_t* inf, byte_t const* data, size_t len, size_t field_len) {
+  size_t n = field_len - inf->field_len;
+  n = n < len ? n : len;
+  memcpy(inf->field + inf->field_len, data, n);
+  inf->field_len += n;
+  return n;
+}
+
+static void state_next(http_inflate_t* inf, inflate_state_e state) {
+  inf->state = state;
+  inf->field_len = 0;
+}
+
+// move to the next gzip header field that is present
+static void header_next(http_inflate_t* inf, inflate_state_e done) {
+  if (done < GZ_EXTRA_LEN && (inf->flags & GZIP_FLAG_EXTRA)) {
+    state_next(inf, GZ_EXTRA_LEN);
+  } else if (done < GZ_NAME && (inf->flags & GZIP_FLAG_NAME)) {
+    state_next(inf, GZ_NAME);
+  } else if (done < GZ_COMMENT && (inf->flags & GZIP_FLAG_COMMENT)) {
+    state_next(inf, GZ_COMMENT);
+  } else if (done < GZ_HCRC && (inf->flags & GZIP_FLAG_HCRC)) {
+    state_next(inf, GZ_HCRC);
+  } else {
+    state_next(inf, GZ_DATA);
+  }
+}
+
+// returns the bytes consumed or -1 on errors
+static int inflate_data(http_inflate_t* inf, byte_t const* data, size_t len) {
+  mz_uint32 flags = TINFL_FLAG_HAS_MORE_INPUT;
+  if (inf->encoding == HTTP_ENCODING_DEFLATE) {
+    flags |= TINFL_FLAG_PARSE_ZLIB_HEADER | TINFL_FLAG_COMPUTE_ADLER32;
+  }
+
+  size_t consumed = 0;
+  for (;;) {
+    size_t in_len = len - consumed;
+    size_t out_len = TINFL_LZ_DICT_SIZE - inf->dict_ofs;
+    int64_t start = esp_timer_get_time();
+    tinfl_status status = tinfl_decompress(&inf->decomp, data + consumed, &in_len, inf->dict,
+                                           inf->dict + inf->dict_ofs, &out_len, flags);
+    inf->time_us += esp_timer_get_time() - start;
+    consumed += in_len;
+
+    if (status < TINFL_STATUS_DONE) {
+      printf("[%s:%d] corrupted data: %d\n", __func__, __LINE__, status);
+      return -1;
+    }
+    if (out_len > 0) {
+      if (inf->sink(inf->dict + inf->dict_ofs, out_len, inf->ctx) != 0) {
+        return -1;
+      }
+      if (inf->encoding == HTTP_ENCODING_GZIP) {
+        inf->crc = esp_rom_crc32_le(inf->crc, inf->dict + inf->dict_ofs, out_len);
+      }
+      inf->total_out += out_len;
+      inf->dict_ofs = (inf->dict_ofs + out_len) & (TINFL_LZ_DICT_SIZE - 1);
+    }
+
+    if (status == TINFL_STATUS_DONE) {
+      state_next(inf, inf->encoding == HTTP_ENCODING_GZIP ? GZ_TRAILER : GZ_DONE);
+      return consumed;
+    }
+    // the decompressor takes all input before it asks for more
+    if (status == TINFL_STATUS_NEEDS_MORE_INPUT) {
+      return consumed;
+    }
+  }
+}
+
+// returns the bytes consumed or -1 on errors
+static int inflate_step(http_inflate_t* inf, byte_t const* data, size_t len) {
+  size_t n = 0;
+  switch (inf->state) {
+    case GZ_HEADER:
+      n = field_collect(inf, data, len, GZIP_HEADER_LEN);
+      if (inf->field_len == GZIP_HEADER_LEN) {
+        // magic number and the deflate method
+        if (inf->field[0] != 0x1f || inf->field[1] != 0x8b || inf->field[2] != 8) {
+          printf("[%s:%d] invalid gzip header\n", __func__, __LINE__);
+          return -1;
+        }
+        inf->flags = inf->field[3];
+        header_next(inf, GZ_HEADER);
+      }
+      return n;
+    case GZ_EXTRA_LEN:
+      n = field_collect(inf, data, len, 2);
+      if (inf->field_len == 2) {
+        inf->skip = inf->field[0] | (inf->field[1] << 8);
+        state_next(inf, GZ_EXTRA);
+      }
+      return n;
+    case GZ_EXTRA:
+      n = inf->skip < len ? inf->skip : len;
+      inf->skip -= n;
+      if (inf->skip == 0) {
+        header_next(inf, GZ_EXTRA);
+      }
+      return n;
+    case GZ_NAME:
+    case GZ_COMMENT: {
+      byte_t const* end = memchr(data, 0, len);
+      if (end == NULL) {
+        return len;
+      }
+      header_next(inf, inf->state);
+      return end - data + 1;
+    }
+    case GZ_HCRC:
+      n = field_collect(inf, data, len, 2);
+      if (inf->field_len == 2) {
+        state_next(inf, GZ_DATA);
+      }
+      return n;
+    case GZ_DATA:
+      return inflate_data(inf, data, len);
+    case GZ_TRAILER:
+      n = field_collect(inf, data, len, GZIP_TRAILER_LEN);
+      if (inf->field_len == GZIP_TRAILER_LEN) {
+        uint32_t crc = inf->field[0] | (inf->field[1] << 8) | (inf->field[2] << 16) | ((uint32_t)inf->field[3] << 24);
+        if (crc != inf->crc) {
+          printf("[%s:%d] CRC mismatch\n", __func__, __LINE__);
+          return -1;
+        }
+        // the size of the data modulo 2^32
+        uint32_t isize = inf->field[4] | (inf->field[5] << 8) | (inf->field[6] << 16) | ((uint32_t)inf->field[7] << 24);
+        if (isize != (uint32_t)inf->total_out) {
+          printf("[%s:%d] size mismatch\n", __func__, __LINE__);
+          return -1;
+        }
+        state_next(inf, GZ_DONE);
+      }
+      return n;
+    case GZ_DONE:
+    default:
+      printf("[%s:%d] data after the end of the stream\n", __func__, __LINE__);
+      return -1;
+  }
+}
+
+http_encoding_t http_encoding_parse(char const* value) {
+  if (value == NULL) {
+    return HTTP_ENCODING_IDENTITY;
+  }
+  if (strcasecmp(value, "gzip") == 0 || strcasecmp(value, "x-gzip") == 0) {
+    return HTTP_ENCODING_GZIP;
+  }
+  if (strcasecmp(value, "deflate") == 0) {
+    return HTTP_ENCODING_DEFLATE;
+  }
+  return HTTP_ENCODING_IDENTITY;
+}
+
+http_inflate_t* http_inflate_new(http_encoding_t encoding, http_body_cb sink, void* ctx) {
+  if (sink == NULL || (encoding != HTTP_ENCODING_GZIP && encoding != HTTP_ENCODING_DEFLATE)) {
+    printf("[%s:%d] invalid parameters\n", __func__, __LINE__);
+    return NULL;
+  }
+
+  http_inflate_t* inf = malloc(sizeof(http_inflate_t));
+  if (inf == NULL) {
+    printf("[%s:%d] OOM\n", __func__, __LINE__);
+    return NULL;
+  }
+  // the window does not need to be cleared
+  memset(inf, 0, offsetof(http_inflate_t, dict));
+  inf->encoding = encoding;
+  inf->sink = sink;
+  inf->ctx = ctx;
+  inf->state = encoding == HTTP_ENCODING_GZIP ? GZ_HEADER : GZ_DATA;
+  tinfl_init(&inf->decomp);
+  return inf;
+}
+
+int http_inflate_feed(http_inflate_t* inf, byte_t const* data, size_t len) {
+  if (inf == NULL || (data == NULL && len > 0)) {
+    printf("[%s:%d] invalid parameters\n", __func__, __LINE__);
+    return -1;
+  }
+
+  size_t offset = 0;
+  while (offset < len) {
+    int n = inflate_step(inf, data + offset, len - offset);
+    if (n < 0) {
+      return -1;
+    }
+    offset += n;
+  }
+  return 0;
+}
+
+int http_inflate_finish(http_inflate_t* inf) {
+  if (inf == NULL || inf->state != GZ_DONE) {
+    return -1;
+  }
+  return 0;
+}
+
+size_t http_inflate_total_out(http_inflate_t const* inf) { return inf ? inf->total_out : 0; }
+
+int64_t http_inflate_time_us(http_inflate_t const* inf) { return inf ? inf->time_us : 0; }
+
+void http_inflate_free(http_inflate_t* inf) { free(inf); }
@@ -0,0 +1,97 @@
+// Copyright 2022 IOTA Stiftung
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef __CLIENT_NETWORK_HTTP_INFLATE_H__
+#define __CLIENT_NETWORK_HTTP_INFLATE_H__
+
+#include <stdint.h>
+
+#include "client/network/http_request.h"
+
+/**
+ * @brief Content encodings of HTTP responses
+ *
+ */
+typedef enum {
+  HTTP_ENCODING_IDENTITY = 0,  ///< not compressed
+  HTTP_ENCODING_GZIP,          ///< gzip member
+  HTTP_ENCODING_DEFLATE,       ///< zlib stream
+} http_encoding_t;
+
+/**
+ * @brief A streaming decompressor of HTTP response bodies
+ *
+ * Decompressed data is passed to a callback in chunks, the memory used is the 32KB window of the deflate format plus
+ * the decompressor state no matter how large the body is.
+ *
+ */
+typedef struct http_inflate http_inflate_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Get the content encoding from a Content-Encoding header value
+ *
+ * @param[in] value The header value
+ * @return http_encoding_t HTTP_ENCODING_IDENTITY for unknown encodings
+ */
+http_encoding_t http_encoding_parse(char const* value);
+
+/**
+ * @brief Create a decompressor
+ *
+ * @param[in] encoding The content encoding, gzip or deflate
+ * @param[in] sink Receives the decompressed data
+ * @param[in] ctx The context of the sink
+ * @return http_inflate_t* NULL on errors
+ */
+http_inflate_t* http_inflate_new(http_encoding_t encoding, http_body_cb sink, void* ctx);
+
+/**
+ * @brief Decompress a chunk of the body
+ *
+ * @param[in] inf The decompressor
+ * @param[in] data A chunk of the compressed body
+ * @param[in] len The length of the chunk
+ * @return int 0 on success, -1 on corrupted data or if the sink failed
+ */
+int http_inflate_feed(http_inflate_t* inf, byte_t const* data, size_t len);
+
+/**
+ * @brief Check that the compressed stream was complete
+ *
+ * @param[in] inf The decompressor
+ * @return int 0 if the stream was complete and the checksums and the size match, otherwise -1
+ */
+int http_inflate_finish(http_inflate_t* inf);
+
+/**
+ * @brief Get the number of decompressed bytes
+ *
+ * @param[in] inf The decompressor
+ * @return size_t The number of bytes passed to the sink
+ */
+size_t http_inflate_total_out(http_inflate_t const* inf);
+
+/**
+ * @brief Get the time spent decompressing, not including the sink
+ *
+ * @param[in] inf The decompressor
+ * @return int64_t The time in microseconds
+ */
+int64_t http_inflate_time_us(http_inflate_t const* inf);
+
+/**
+ * @brief Free a decompressor
+ *
+ * @param[in] inf The decompressor
+ */
+void http_inflate_free(http_inflate_t* inf);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,76 @@
+// Copyright 2022 IOTA Stiftung
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef __CLIENT_NETWORK_HTTP_POOL_H__
+#define __CLIENT_NETWORK_HTTP_POOL_H__
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+ * @brief Counters of the keep-alive connection pool used by the ESP32 HTTP client
+ *
+ */
+typedef struct {
+  uint32_t requests;          ///< requests performed
+  uint32_t reused;            ///< requests served on an already open connection
+  uint32_t missed;            ///< requests that needed a new connection
+  uint32_t expired;           ///< idle connections closed by the idle timeout
+  uint32_t evicted;           ///< idle connections closed to make room for another endpoint
+  uint32_t stale;             ///< pooled connections found closed by the peer
+  uint32_t errors;            ///< failed requests
+  uint32_t compressed;        ///< responses received with a compressed body
+  uint64_t compressed_bytes;  ///< body bytes of compressed responses as received
+  uint64_t inflated_bytes;    ///< body bytes of compressed responses after decompression
+  uint64_t inflate_us;        ///< time spent decompressing, in microseconds
+  uint32_t tls_resumed;       ///< TLS handshakes that resumed a cached session
+  uint32_t tls_full;          ///< full TLS handshakes
+  uint32_t retries;           ///< idempotent requests repeated after an error
+  uint32_t hedged;            ///< duplicate requests sent because the first one was slow
+  uint32_t hedge_wins;        ///< hedged requests answered by the duplicate first
+  uint32_t h2_sessions;       ///< HTTP/2 connections opened
+  uint32_t h2_streams;        ///< requests sent as streams of a HTTP/2 connection
+  uint32_t h2_fallbacks;      ///< requests sent with HTTP/1.1 because the endpoint does not support HTTP/2
+  uint8_t open;               ///< connections currently open
+  uint8_t in_use;             ///< connections currently serving a request
+  uint8_t h2_active;          ///< HTTP/2 streams currently in flight
+} http_pool_stats_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Get a snapshot of the connection pool counters
+ *
+ * @param[out] stats The counters
+ */
+void http_pool_get_stats(http_pool_stats_t* stats);
+
+/**
+ * @brief Reset the connection pool counters
+ *
+ */
+void http_pool_reset_stats();
+
+/**
+ * @brief Close all idle connections of the pool
+ *
+ */
+void http_pool_flush();
+
+/**
+ * @brief Enable or disable HTTP/2, e.g. to compare it with the connection pool
+ *
+ * Only has an effect if the client was built with CONFIG_IOTA_HTTP2, HTTP/2 is enabled by default then.
+ *
+ * @param[in] enable true to send requests to endpoints that support HTTP/2 as streams of one connection
+ * @return bool The previous setting
+ */
+bool http_pool_set_http2(bool enable);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
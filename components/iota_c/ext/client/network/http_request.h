@@ -0,0 +1,79 @@
+// Copyright 2022 IOTA Stiftung
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef __CLIENT_NETWORK_HTTP_REQUEST_H__
+#define __CLIENT_NETWORK_HTTP_REQUEST_H__
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "client/network/http.h"
+
+/**
+ * @brief Receives a chunk of the response body
+ *
+ * @param[in] data A chunk of the body
+ * @param[in] len The length of the chunk
+ * @param[in] ctx The user context
+ * @return int 0 on success, non-zero aborts the request
+ */
+typedef int (*http_body_cb)(byte_t const* data, size_t len, void* ctx);
+
+/**
+ * @brief Optional settings of a HTTP request
+ *
+ */
+typedef struct {
+  char const* accept;        ///< the Accept header, NULL for application/json
+  char const* content_type;  ///< the Content-Type of the request body, NULL for application/json
+  http_body_cb on_body;      ///< streams the body of successful responses, NULL to collect it into the response buffer
+  void* ctx;                 ///< the user context of on_body
+} http_request_opts_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Perform a HTTP GET with request options
+ *
+ * If a body callback is set, the body of a successful response is passed to it as it arrives and the response buffer
+ * only receives error responses, it can be NULL if errors are not needed.
+ *
+ * @param[in] config The client configuration
+ * @param[in] opts The request options, NULL for defaults
+ * @param[out] response The response body
+ * @param[out] status The HTTP status code
+ * @return int 0 on success
+ */
+int http_client_get_ex(http_client_config_t const* const config, http_request_opts_t const* const opts,
+                       byte_buf_t* const response, long* status);
+
+/**
+ * @brief Perform a HTTP POST with request options
+ *
+ * @param[in] config The client configuration
+ * @param[in] opts The request options, NULL for defaults
+ * @param[in] request The request body
+ * @param[out] response The response body
+ * @param[out] status The HTTP status code
+ * @return int 0 on success
+ */
+int http_client_post_ex(http_client_config_t const* const config, http_request_opts_t const* const opts,
+                        byte_buf_t const* const request, byte_buf_t* const response, long* status);
+
+/**
+ * @brief Set a deadline for the HTTP requests of the calling task
+ *
+ * Requests of the calling task fail once the deadline has passed, in addition to the timeout of each request. It lets
+ * an API call that makes several requests finish in a given time.
+ *
+ * @param[in] deadline_us The deadline as returned by esp_timer_get_time(), 0 to clear it
+ */
+void http_client_set_deadline(int64_t deadline_us);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
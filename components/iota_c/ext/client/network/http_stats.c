@@ -0,0 +1,245 @@
+// Copyright 2022 IOTA Stiftung
+// SPDX-License-Identifier: Apache-2.0
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "cJSON.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "freertos/task.h"
+#include "sdkconfig.h"
+
+#include "client/network/http_stats.h"
+
+#define HTTP_STATS_ID_PLACEHOLDER "{id}"
+// the number of tasks whose last request is remembered for the parse phase
+#define HTTP_STATS_TASK_SLOTS 8
+
+// the upper limits of the buckets in milliseconds
+static uint32_t const bucket_limits_ms[HTTP_STATS_BUCKETS - 1] = {1, 2, 5, 10, 20, 50, 100, 200, 500, 1000, 2000, 5000};
+
+static char const* const phase_names[HTTP_PHASE_MAX] = {"dns", "connect", "tls", "wait", "transfer", "parse"};
+
+typedef struct {
+  TaskHandle_t task;  ///< the task that performed the request
+  int endpoint;       ///< the endpoint of the request, -1 if the slot is free
+} task_request_t;
+
+// allocated with the first request
+static http_endpoint_stats_t* endpoints = NULL;
+static size_t endpoints_len = 0;
+static task_request_t last_requests[HTTP_STATS_TASK_SLOTS];
+static size_t last_requests_next = 0;
+static SemaphoreHandle_t stats_lock = NULL;
+
+static bool stats_init() {
+  if (stats_lock == NULL) {
+    // the first request is made before any worker task is started
+    stats_lock = xSemaphoreCreateMutex();
+    if (stats_lock == NULL) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// strips the query and replaces path segments that are IDs or indexes by a placeholder
+static void path_template(char const* path, char buf[HTTP_STATS_PATH_MAX_LEN]) {
+  size_t len = 0;
+  char const* p = path;
+  while (*p && *p != '?') {
+    char const* seg = p;
+    size_t seg_len = strcspn(seg, "/?");
+    bool is_id =
+        (seg_len > 2 && seg[0] == '0' && seg[1] == 'x') || (seg_len > 0 && strspn(seg, "0123456789") >= seg_len);
+    char const* out = is_id ? HTTP_STATS_ID_PLACEHOLDER : seg;
+    size_t out_len = is_id ? strlen(HTTP_STATS_ID_PLACEHOLDER) : seg_len;
+    if (len + out_len + 1 >= HTTP_STATS_PATH_MAX_LEN) {
+      out_len = HTTP_STATS_PATH_MAX_LEN - 1 - len;
+    }
+    memcpy(buf + len, out, out_len);
+    len += out_len;
+    p += seg_len;
+    if (*p == '/' && len + 1 < HTTP_STATS_PATH_MAX_LEN) {
+      buf[len++] = '/';
+      p++;
+    } else if (*p == '/') {
+      break;
+    }
+  }
+  buf[len] = '\0';
+}
+
+static void histogram_add(http_histogram_t* h, int64_t us) {
+  size_t b = 0;
+  while (b < HTTP_STATS_BUCKETS - 1 && us > (int64_t)bucket_limits_ms[b] * 1000) {
+    b++;
+  }
+  uint32_t sample = us > UINT32_MAX ? UINT32_MAX : (uint32_t)us;
+  h->count++;
+  h->sum_us += sample;
+  h->max_us = sample > h->max_us ? sample : h->max_us;
+  h->buckets[b]++;
+}
+
+// finds the endpoint of a request, a new one is added if add is set
+static int endpoint_find(char const* method, char const* path, bool add) {
+  char tmpl[HTTP_STATS_PATH_MAX_LEN];
+  path_template(path, tmpl);
+  for (size_t i = 0; i < endpoints_len; i++) {
+    if (strcmp(endpoints[i].path, tmpl) == 0 && strcmp(endpoints[i].method, method) == 0) {
+      return i;
+    }
+  }
+  if (!add || endpoints_len >= HTTP_STATS_MAX_ENDPOINTS) {
+    return -1;
+  }
+  http_endpoint_stats_t* e = &endpoints[endpoints_len];
+  memset(e, 0, sizeof(http_endpoint_stats_t));
+  strncpy(e->method, method, sizeof(e->method) - 1);
+  strcpy(e->path, tmpl);
+  return endpoints_len++;
+}
+
+static task_request_t* last_request_slot(TaskHandle_t task) {
+  for (size_t i = 0; i < HTTP_STATS_TASK_SLOTS; i++) {
+    if (last_requests[i].task == task) {
+      return &last_requests[i];
+    }
+  }
+  return NULL;
+}
+
+void http_stats_record(char const* method, char const* path, int64_t const phases_us[HTTP_PHASE_MAX], bool ok) {
+  if (method == NULL || path == NULL || phases_us == NULL || !stats_init()) {
+    return;
+  }
+
+  xSemaphoreTake(stats_lock, portMAX_DELAY);
+  if (endpoints == NULL && (endpoints = calloc(HTTP_STATS_MAX_ENDPOINTS, sizeof(http_endpoint_stats_t))) == NULL) {
+    xSemaphoreGive(stats_lock);
+    return;
+  }
+  int idx = endpoint_find(method, path, true);
+  if (idx >= 0) {
+    http_endpoint_stats_t* e = &endpoints[idx];
+    e->requests++;
+    e->errors += ok ? 0 : 1;
+    for (size_t i = 0; i < HTTP_PHASE_MAX; i++) {
+      if (phases_us[i] >= 0) {
+        histogram_add(&e->phases[i], phases_us[i]);
+      }
+    }
+
+    // remember the endpoint for the parse time of the response
+    TaskHandle_t task = xTaskGetCurrentTaskHandle();
+    task_request_t* slot = last_request_slot(task);
+    if (slot == NULL) {
+      slot = &last_requests[last_requests_next];
+      last_requests_next = (last_requests_next + 1) % HTTP_STATS_TASK_SLOTS;
+    }
+    slot->task = task;
+    slot->endpoint = ok ? idx : -1;
+  }
+  xSemaphoreGive(stats_lock);
+}
+
+void http_stats_record_parse(int64_t us) {
+  if (stats_lock == NULL) {
+    return;
+  }
+
+  xSemaphoreTake(stats_lock, portMAX_DELAY);
+  task_request_t* slot = last_request_slot(xTaskGetCurrentTaskHandle());
+  if (slot && slot->endpoint >= 0 && endpoints) {
+    histogram_add(&endpoints[slot->endpoint].phases[HTTP_PHASE_PARSE], us);
+    slot->endpoint = -1;
+  }
+  xSemaphoreGive(stats_lock);
+}
+
+size_t http_stats_get(http_endpoint_stats_t stats[]) {
+  if (stats == NULL || stats_lock == NULL) {
+    return 0;
+  }
+
+  xSemaphoreTake(stats_lock, portMAX_DELAY);
+  size_t len = endpoints_len;
+  if (len) {
+    memcpy(stats, endpoints, len * sizeof(http_endpoint_stats_t));
+  }
+  xSemaphoreGive(stats_lock);
+  return len;
+}
+
+void http_stats_reset() {
+  if (stats_lock == NULL) {
+    return;
+  }
+
+  xSemaphoreTake(stats_lock, portMAX_DELAY);
+  endpoints_len = 0;
+  for (size_t i = 0; i < HTTP_STATS_TASK_SLOTS; i++) {
+    last_requests[i].endpoint = -1;
+  }
+  xSemaphoreGive(stats_lock);
+}
+
+uint32_t http_stats_endpoint_percentile_ms(char const* method, char const* path, http_phase_t phase, uint8_t pct,
+                                           uint32_t* samples) {
+  uint32_t ms = 0;
+  if (samples) {
+    *samples = 0;
+  }
+  if (method == NULL || path == NULL || phase >= HTTP_PHASE_MAX || stats_lock == NULL) {
+    return 0;
+  }
+
+  xSemaphoreTake(stats_lock, portMAX_DELAY);
+  int idx = endpoints ? endpoint_find(method, path, false) : -1;
+  if (idx >= 0) {
+    ms = http_stats_percentile_ms(&endpoints[idx].phases[phase], pct);
+    if (samples) {
+      *samples = endpoints[idx].phases[phase].count;
+    }
+  }
+  xSemaphoreGive(stats_lock);
+  return ms;
+}
+
+uint32_t http_stats_bucket_limit_ms(size_t bucket) {
+  return bucket < HTTP_STATS_BUCKETS - 1 ? bucket_limits_ms[bucket] : UINT32_MAX;
+}
+
+uint32_t http_stats_percentile_ms(http_histogram_t const* h, uint8_t pct) {
+  if (h == NULL || h->count == 0) {
+    return 0;
+  }
+  pct = pct > 100 ? 100 : pct;
+  uint64_t rank = ((uint64_t)h->count * pct + 99) / 100;
+  rank = rank ? rank : 1;
+  uint64_t seen = 0;
+  size_t b = 0;
+  for (; b < HTTP_STATS_BUCKETS - 1; b++) {
+    seen += h->buckets[b];
+    if (seen >= rank) {
+      break;
+    }
+  }
+  // no bucket limit is above the largest sample
+  uint32_t max_ms = (h->max_us + 999) / 1000;
+  uint32_t limit = http_stats_bucket_limit_ms(b);
+  return limit < max_ms ? limit : max_ms;
+}
+
+char const* http_phase_str(http_phase_t phase) { return phase < HTTP_PHASE_MAX ? phase_names[phase] : "unknown"; }
+
+cJSON* http_stats_parse_json(char const* value) {
+  int64_t start = esp_timer_get_time();
+  cJSON* json = cJSON_Parse(value);
+  http_stats_record_parse(esp_timer_get_time() - start);
+  return json;
+}
@@ -0,0 +1,147 @@
+// Copyright 2022 IOTA Stiftung
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef __CLIENT_NETWORK_HTTP_STATS_H__
+#define __CLIENT_NETWORK_HTTP_STATS_H__
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "cJSON.h"
+
+// the number of distinct endpoints that are tracked, further endpoints are not recorded
+#define HTTP_STATS_MAX_ENDPOINTS 12
+// the length of an endpoint path with IDs replaced by a placeholder
+#define HTTP_STATS_PATH_MAX_LEN 64
+// the number of buckets of a histogram, the last one counts everything above the largest limit
+#define HTTP_STATS_BUCKETS 13
+
+/**
+ * @brief The phases of a REST call
+ *
+ */
+typedef enum {
+  HTTP_PHASE_DNS = 0,   ///< resolving the host name of a new connection
+  HTTP_PHASE_CONNECT,   ///< the TCP connect of a new connection
+  HTTP_PHASE_TLS,       ///< the TLS handshake of a new connection
+  HTTP_PHASE_WAIT,      ///< from sending the request until the first response byte
+  HTTP_PHASE_TRANSFER,  ///< from the first response byte until the response is complete
+  HTTP_PHASE_PARSE,     ///< parsing the response body after it was received
+  HTTP_PHASE_MAX
+} http_phase_t;
+
+/**
+ * @brief A fixed bucket histogram of durations
+ *
+ */
+typedef struct {
+  uint32_t count;                        ///< the number of samples
+  uint64_t sum_us;                       ///< the sum of all samples, in microseconds
+  uint32_t max_us;                       ///< the largest sample, in microseconds
+  uint32_t buckets[HTTP_STATS_BUCKETS];  ///< the samples per bucket, see http_stats_bucket_limit_ms()
+} http_histogram_t;
+
+/**
+ * @brief The statistics of a REST endpoint
+ *
+ */
+typedef struct {
+  char method[8];                           ///< the HTTP method
+  char path[HTTP_STATS_PATH_MAX_LEN];       ///< the path without query, IDs are replaced by {id}
+  uint32_t requests;                        ///< the number of requests
+  uint32_t errors;                          ///< the number of failed requests
+  http_histogram_t phases[HTTP_PHASE_MAX];  ///< the durations of each phase
+} http_endpoint_stats_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Record the phases of a request
+ *
+ * @param[in] method The HTTP method
+ * @param[in] path The request path, including the query
+ * @param[in] phases_us The duration of each phase in microseconds, negative for phases that did not happen
+ * @param[in] ok The request succeeded
+ */
+void http_stats_record(char const* method, char const* path, int64_t const phases_us[HTTP_PHASE_MAX], bool ok);
+
+/**
+ * @brief Record the parse time of the last response received by the calling task
+ *
+ * Only the first call after a request is recorded, so parsing that is not related to a response is not counted.
+ *
+ * @param[in] us The parse time in microseconds
+ */
+void http_stats_record_parse(int64_t us);
+
+/**
+ * @brief Parse a JSON response with cJSON_Parse() and record the parse time
+ *
+ * Used by the REST call sites instead of cJSON_Parse(), see http_stats_route.h. Parsing elsewhere in the application is
+ * not timed.
+ *
+ * @param[in] value The response body
+ * @return cJSON* The parsed JSON object, NULL on failure
+ */
+cJSON* http_stats_parse_json(char const* value);
+
+/**
+ * @brief Get a snapshot of the endpoint statistics
+ *
+ * @param[out] stats An array of HTTP_STATS_MAX_ENDPOINTS elements
+ * @return size_t The number of endpoints
+ */
+size_t http_stats_get(http_endpoint_stats_t stats[]);
+
+/**
+ * @brief Reset the endpoint statistics
+ *
+ */
+void http_stats_reset();
+
+/**
+ * @brief Estimate a percentile of a phase of an endpoint
+ *
+ * @param[in] method The HTTP method
+ * @param[in] path The request path, including the query
+ * @param[in] phase The phase
+ * @param[in] pct The percentile, 1 to 100
+ * @param[out] samples The number of samples of the phase, can be NULL
+ * @return uint32_t The percentile in milliseconds, 0 if the endpoint has no samples
+ */
+uint32_t http_stats_endpoint_percentile_ms(char const* method, char const* path, http_phase_t phase, uint8_t pct,
+                                           uint32_t* samples);
+
+/**
+ * @brief Get the upper limit of a histogram bucket
+ *
+ * @param[in] bucket The bucket index
+ * @return uint32_t The limit in milliseconds, UINT32_MAX for the last bucket
+ */
+uint32_t http_stats_bucket_limit_ms(size_t bucket);
+
+/**
+ * @brief Estimate a percentile of a histogram
+ *
+ * @param[in] h The histogram
+ * @param[in] pct The percentile, 1 to 100
+ * @return uint32_t The upper limit of the bucket holding the percentile in milliseconds, 0 if there are no samples
+ */
+uint32_t http_stats_percentile_ms(http_histogram_t const* h, uint8_t pct);
+
+/**
+ * @brief Get the name of a phase
+ *
+ * @param[in] phase The phase
+ * @return char const* The name
+ */
+char const* http_phase_str(http_phase_t phase);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
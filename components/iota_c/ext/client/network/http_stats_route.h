@@ -0,0 +1,16 @@
+// Copyright 2022 IOTA Stiftung
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef __CLIENT_NETWORK_HTTP_STATS_ROUTE_H__
+#define __CLIENT_NETWORK_HTTP_STATS_ROUTE_H__
+
+// Force-included into the REST sources of iota.c, see CMakeLists.txt. The responses they parse are timed as the parse
+// phase of the request, other cJSON_Parse() calls of the application are not affected.
+
+#include "cJSON.h"
+
+#include "client/network/http_stats.h"
+
+#define cJSON_Parse(value) http_stats_parse_json(value)
+
+#endif
@@ -0,0 +1,210 @@
+// Copyright 2022 IOTA Stiftung
+// SPDX-License-Identifier: Apache-2.0
+
+#include <stdio.h>
+#include <string.h>
+
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "freertos/task.h"
+#include "sdkconfig.h"
+
+#include "client/api/restful/get_health.h"
+#include "client/network/http_cache.h"
+#include "client/network/node_set.h"
+
+#define NODE_SET_HEALTH_PATH "/health"
+// weight of a new latency sample in the moving average, 1/4
+#define NODE_SET_EWMA_SHIFT 2
+
+typedef struct {
+  iota_client_conf_t conf;  ///< the node endpoint
+  bool healthy;             ///< the last probe or request succeeded
+  uint32_t latency_ms;      ///< moving average of the probe latency, 0 if not probed yet
+  uint32_t selected;        ///< requests routed to this node
+  uint32_t failures;        ///< failed probes and requests
+} node_t;
+
+static node_t nodes[NODE_SET_MAX_NODES];
+static size_t nodes_len = 0;
+// guards the node states
+static SemaphoreHandle_t nodes_lock = NULL;
+static uint32_t probe_interval_s = 0;
+
+static bool node_matches(node_t const* node, http_client_config_t const* config) {
+  return node->conf.port == config->port && node->conf.use_tls == config->use_tls &&
+         strcmp(node->conf.host, config->host) == 0;
+}
+
+// healthy nodes first, then the lowest latency, nodes that were not probed yet keep their order
+static bool node_better(node_t const* a, node_t const* b) {
+  if (a->healthy != b->healthy) {
+    return a->healthy;
+  }
+  uint32_t la = a->latency_ms ? a->latency_ms : UINT32_MAX;
+  uint32_t lb = b->latency_ms ? b->latency_ms : UINT32_MAX;
+  return la < lb;
+}
+
+int node_set_add(iota_client_conf_t const* node) {
+  if (node == NULL) {
+    printf("[%s:%d] invalid parameters\n", __func__, __LINE__);
+    return -1;
+  }
+  if (nodes_lock == NULL && (nodes_lock = xSemaphoreCreateMutex()) == NULL) {
+    printf("[%s:%d] OOM\n", __func__, __LINE__);
+    return -1;
+  }
+
+  int ret = 0;
+  xSemaphoreTake(nodes_lock, portMAX_DELAY);
+  if (nodes_len >= NODE_SET_MAX_NODES) {
+    printf("[%s:%d] node set is full\n", __func__, __LINE__);
+    ret = -1;
+  } else {
+    memset(&nodes[nodes_len], 0, sizeof(node_t));
+    memcpy(&nodes[nodes_len].conf, node, sizeof(iota_client_conf_t));
+    // nodes are assumed to be healthy until a probe or a request fails
+    nodes[nodes_len].healthy = true;
+    nodes_len++;
+  }
+  xSemaphoreGive(nodes_lock);
+  if (ret == 0) {
+    // responses of the endpoint may now come from another node
+    http_cache_clear();
+  }
+  return ret;
+}
+
+int node_set_probe() {
+  if (nodes_lock == NULL) {
+    return 0;
+  }
+
+  int healthy_nodes = 0;
+  for (size_t i = 0;; i++) {
+    // the node is probed without holding the lock, on a copy of its endpoint
+    iota_client_conf_t conf;
+    xSemaphoreTake(nodes_lock, portMAX_DELAY);
+    bool more = i < nodes_len;
+    if (more) {
+      memcpy(&conf, &nodes[i].conf, sizeof(iota_client_conf_t));
+    }
+    xSemaphoreGive(nodes_lock);
+    if (!more) {
+      break;
+    }
+
+    bool healthy = false;
+    int64_t start = esp_timer_get_time();
+    int ret = get_health(&conf, &healthy);
+    uint32_t latency_ms = (esp_timer_get_time() - start) / 1000;
+    latency_ms = latency_ms ? latency_ms : 1;
+
+    xSemaphoreTake(nodes_lock, portMAX_DELAY);
+    node_t* node = &nodes[i];
+    node->healthy = ret == 0 && healthy;
+    if (node->healthy) {
+      if (node->latency_ms == 0) {
+        node->latency_ms = latency_ms;
+      } else {
+        node->latency_ms += ((int32_t)latency_ms - (int32_t)node->latency_ms) >> NODE_SET_EWMA_SHIFT;
+        node->latency_ms = node->latency_ms ? node->latency_ms : 1;
+      }
+      healthy_nodes++;
+    } else {
+      node->failures++;
+    }
+    xSemaphoreGive(nodes_lock);
+  }
+  return healthy_nodes;
+}
+
+static void node_set_probe_task(void* arg) {
+  for (;;) {
+    node_set_probe();
+    vTaskDelay(pdMS_TO_TICKS(probe_interval_s * 1000));
+  }
+}
+
+int node_set_start_probing(uint32_t interval_s) {
+  if (interval_s == 0) {
+    printf("[%s:%d] invalid parameters\n", __func__, __LINE__);
+    return -1;
+  }
+  if (probe_interval_s) {
+    // already running, change the interval only
+    probe_interval_s = interval_s;
+    return 0;
+  }
+  probe_interval_s = interval_s;
+  if (xTaskCreate(node_set_probe_task, "node_probe", CONFIG_IOTA_CLIENT_TASK_STACK_SIZE, NULL, tskIDLE_PRIORITY + 2,
+                  NULL) != pdPASS) {
+    printf("[%s:%d] create probe task failed\n", __func__, __LINE__);
+    probe_interval_s = 0;
+    return -1;
+  }
+  return 0;
+}
+
+size_t node_set_get_stats(node_set_stats_t stats[]) {
+  if (stats == NULL || nodes_lock == NULL) {
+    return 0;
+  }
+
+  xSemaphoreTake(nodes_lock, portMAX_DELAY);
+  for (size_t i = 0; i < nodes_len; i++) {
+    stats[i].host = nodes[i].conf.host;
+    stats[i].port = nodes[i].conf.port;
+    stats[i].use_tls = nodes[i].conf.use_tls;
+    stats[i].healthy = nodes[i].healthy;
+    stats[i].latency_ms = nodes[i].latency_ms;
+    stats[i].selected = nodes[i].selected;
+    stats[i].failures = nodes[i].failures;
+  }
+  size_t len = nodes_len;
+  xSemaphoreGive(nodes_lock);
+  return len;
+}
+
+int node_set_route(http_client_config_t const* config, uint32_t tried, iota_client_conf_t* node) {
+  // probes have to reach the node they were sent to
+  if (nodes_lock == NULL || nodes_len < 2 ||
+      strncmp(config->path, NODE_SET_HEALTH_PATH, strlen(NODE_SET_HEALTH_PATH)) == 0) {
+    return -1;
+  }
+
+  int best = -1;
+  bool member = false;
+  xSemaphoreTake(nodes_lock, portMAX_DELAY);
+  for (size_t i = 0; i < nodes_len; i++) {
+    member = member || node_matches(&nodes[i], config);
+    if ((tried & (1u << i)) == 0 && (best < 0 || node_better(&nodes[i], &nodes[best]))) {
+      best = i;
+    }
+  }
+  if (!member) {
+    best = -1;
+  } else if (best >= 0) {
+    nodes[best].selected++;
+    memcpy(node, &nodes[best].conf, sizeof(iota_client_conf_t));
+  }
+  xSemaphoreGive(nodes_lock);
+  return best;
+}
+
+void node_set_report(int node, bool ok) {
+  if (nodes_lock == NULL || node < 0) {
+    return;
+  }
+  xSemaphoreTake(nodes_lock, portMAX_DELAY);
+  if ((size_t)node < nodes_len) {
+    // a request error takes the node out of the rotation until a probe or a request that fails over to it succeeds
+    nodes[node].healthy = ok;
+    if (!ok) {
+      nodes[node].failures++;
+    }
+  }
+  xSemaphoreGive(nodes_lock);
+}
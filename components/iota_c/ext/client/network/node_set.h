@@ -0,0 +1,90 @@
+// Copyright 2022 IOTA Stiftung
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef __CLIENT_NETWORK_NODE_SET_H__
+#define __CLIENT_NETWORK_NODE_SET_H__
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "client/client_service.h"
+#include "client/network/http.h"
+
+// the maximum number of nodes in the set
+#define NODE_SET_MAX_NODES 4
+
+/**
+ * @brief Selection statistics of a node
+ *
+ */
+typedef struct {
+  char const* host;     ///< the node host
+  uint16_t port;        ///< the node port
+  bool use_tls;         ///< the node uses TLS
+  bool healthy;         ///< the last probe or request succeeded
+  uint32_t latency_ms;  ///< moving average of the probe latency, 0 if not probed yet
+  uint32_t selected;    ///< requests routed to this node
+  uint32_t failures;    ///< failed probes and requests
+} node_set_stats_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Add a node to the node set
+ *
+ * Requests of the HTTP client to any node of the set are sent to the fastest healthy node and fail over to the next
+ * one on connection errors. Health probes are never rerouted.
+ *
+ * @param[in] node The node endpoint
+ * @return int 0 on success
+ */
+int node_set_add(iota_client_conf_t const* node);
+
+/**
+ * @brief Probe the health and latency of all nodes
+ *
+ * @return int The number of healthy nodes
+ */
+int node_set_probe();
+
+/**
+ * @brief Probe the nodes periodically in a background task
+ *
+ * @param[in] interval_s The time between probes in seconds
+ * @return int 0 on success
+ */
+int node_set_start_probing(uint32_t interval_s);
+
+/**
+ * @brief Get the selection statistics of the nodes
+ *
+ * @param[out] stats An array of NODE_SET_MAX_NODES items
+ * @return size_t The number of nodes
+ */
+size_t node_set_get_stats(node_set_stats_t stats[]);
+
+/**
+ * @brief Pick the node for a request, used by the HTTP client
+ *
+ * @param[in] config The request configuration
+ * @param[in] tried A bit mask of the nodes that already failed this request
+ * @param[out] node The endpoint of the picked node
+ * @return int The index of the node, -1 if the request is not routed or all nodes were tried
+ */
+int node_set_route(http_client_config_t const* config, uint32_t tried, iota_client_conf_t* node);
+
+/**
+ * @brief Report the result of a routed request, used by the HTTP client
+ *
+ * @param[in] node The index of the node
+ * @param[in] ok The node responded
+ */
+void node_set_report(int node, bool ok);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
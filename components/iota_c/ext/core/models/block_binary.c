@@ -0,0 +1,85 @@
+// Copyright 2022 IOTA Stiftung
+// SPDX-License-Identifier: Apache-2.0
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "core/models/block_binary.h"
+#include "core/models/payloads/tagged_data.h"
+#include "core/models/payloads/transaction.h"
+
+// protocol version, parents count, payload length and nonce
+#define BLOCK_BINARY_MIN_LEN (sizeof(uint8_t) + sizeof(uint8_t) + sizeof(uint32_t) + sizeof(uint64_t))
+
+int core_block_from_binary(byte_t const buf[], size_t len, core_block_t** blk) {
+  if (buf == NULL || blk == NULL) {
+    printf("[%s:%d] invalid parameters\n", __func__, __LINE__);
+    return -1;
+  }
+  *blk = NULL;
+
+  if (len < BLOCK_BINARY_MIN_LEN) {
+    printf("[%s:%d] block is too short\n", __func__, __LINE__);
+    return -1;
+  }
+
+  size_t offset = 0;
+  uint8_t version = buf[offset++];
+  uint8_t parents_len = buf[offset++];
+  if (parents_len == 0 || parents_len > BLOCK_MAX_PARENTS ||
+      len - BLOCK_BINARY_MIN_LEN < (size_t)parents_len * IOTA_BLOCK_ID_BYTES) {
+    printf("[%s:%d] invalid parents\n", __func__, __LINE__);
+    return -1;
+  }
+  byte_t const* parents = buf + offset;
+  offset += parents_len * IOTA_BLOCK_ID_BYTES;
+
+  uint32_t payload_len = 0;
+  memcpy(&payload_len, buf + offset, sizeof(payload_len));
+  offset += sizeof(payload_len);
+  if (payload_len != len - offset - sizeof(uint64_t)) {
+    printf("[%s:%d] invalid payload length\n", __func__, __LINE__);
+    return -1;
+  }
+  byte_t const* payload = buf + offset;
+  offset += payload_len;
+
+  uint32_t payload_type = CORE_BLOCK_PAYLOAD_UNKNOWN;
+  if (payload_len > 0) {
+    if (payload_len < sizeof(payload_type)) {
+      printf("[%s:%d] invalid payload\n", __func__, __LINE__);
+      return -1;
+    }
+    memcpy(&payload_type, payload, sizeof(payload_type));
+    if (payload_type != CORE_BLOCK_PAYLOAD_TRANSACTION && payload_type != CORE_BLOCK_PAYLOAD_TAGGED) {
+      return 1;
+    }
+  }
+
+  core_block_t* b = core_block_new(version);
+  if (b == NULL) {
+    printf("[%s:%d] OOM\n", __func__, __LINE__);
+    return -1;
+  }
+  for (uint8_t i = 0; i < parents_len; i++) {
+    core_block_add_parent(b, parents + i * IOTA_BLOCK_ID_BYTES);
+  }
+
+  // the payload deserializers do not modify the buffer
+  if (payload_type == CORE_BLOCK_PAYLOAD_TRANSACTION) {
+    b->payload = tx_payload_deserialize((byte_t*)payload, payload_len);
+  } else if (payload_type == CORE_BLOCK_PAYLOAD_TAGGED) {
+    b->payload = tagged_data_deserialize((byte_t*)payload, payload_len);
+  }
+  if (payload_len > 0 && b->payload == NULL) {
+    printf("[%s:%d] deserialize payload failed\n", __func__, __LINE__);
+    core_block_free(b);
+    return -1;
+  }
+  b->payload_type = payload_type;
+  memcpy(&b->nonce, buf + offset, sizeof(b->nonce));
+
+  *blk = b;
+  return 0;
+}
@@ -0,0 +1,34 @@
+// Copyright 2022 IOTA Stiftung
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef __CORE_MODELS_BLOCK_BINARY_H__
+#define __CORE_MODELS_BLOCK_BINARY_H__
+
+#include <stddef.h>
+
+#include "core/models/block.h"
+
+// the media type of binary serialized objects in the node API
+#define IOTA_BINARY_MEDIA_TYPE "application/vnd.iota.serializer-v1"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Deserialize a block from its binary form
+ *
+ * Supports blocks without payload, with a transaction payload and with a tagged data payload.
+ *
+ * @param[in] buf The serialized block
+ * @param[in] len The length of the serialized block
+ * @param[out] blk The deserialized block, free it with core_block_free()
+ * @return int 0 on success, 1 if the payload type is not supported, -1 on malformed data
+ */
+int core_block_from_binary(byte_t const buf[], size_t len, core_block_t** blk);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,232 @@
+// Copyright 2022 IOTA Stiftung
+// SPDX-License-Identifier: Apache-2.0
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "esp_heap_caps.h"
+
+#include "core/utils/arena.h"
+
+#define ARENA_ALIGN 8
+#define ARENA_MAGIC 0x616e7261
+#define ARENA_ALLOC_MAGIC 0x61726e61
+// no allocation can be rolled back
+#define ARENA_NO_LAST SIZE_MAX
+
+// precedes each allocation. Heap memory is preceded by a header of the heap, which holds an address or a poison
+// pattern, so the magic tells allocations of arenas from heap memory without looking the pointer up.
+typedef struct {
+  uint32_t size;   ///< the size of the allocation, realloc() copies that much
+  uint32_t magic;  ///< ARENA_ALLOC_MAGIC
+} alloc_hdr_t;
+
+typedef struct arena_chunk {
+  struct arena_chunk* prev;  ///< the chunk filled before, NULL for the first one
+  size_t size;               ///< the capacity of the chunk
+  size_t used;               ///< the bytes taken from the chunk
+  size_t last;               ///< the offset of the last allocation, it can grow in place or be rolled back
+  size_t mark;               ///< the bytes taken before the last allocation
+  uint8_t data[];            ///< the allocations
+} arena_chunk_t;
+
+struct arena {
+  uint32_t magic;        ///< marks the arena for arena_of()
+  bool psram;            ///< chunks are allocated from external RAM
+  size_t chunk_size;     ///< the size of further chunks
+  arena_chunk_t* chunk;  ///< the chunk allocations are taken from
+  arena_chunk_t* first;  ///< the first chunk, it follows the arena
+};
+
+// the arena used by the routed allocations of the task, see arena_enter()
+static __thread arena_t* task_arena = NULL;
+
+static void* chunk_malloc(size_t size, bool psram) {
+  void* p = NULL;
+  if (psram) {
+    p = heap_caps_malloc(size, MALLOC_CAP_SPIRAM);
+  }
+  if (p == NULL) {
+    p = heap_caps_malloc(size, MALLOC_CAP_DEFAULT);
+  }
+  return p;
+}
+
+static void chunk_init(arena_chunk_t* c, size_t size, arena_chunk_t* prev) {
+  c->prev = prev;
+  c->size = size;
+  c->used = 0;
+  c->last = ARENA_NO_LAST;
+  c->mark = 0;
+}
+
+static uint8_t* align_up(uint8_t* p) {
+  return (uint8_t*)(((uintptr_t)p + ARENA_ALIGN - 1) & ~(uintptr_t)(ARENA_ALIGN - 1));
+}
+
+// the aligned allocation of size bytes in the chunk, NULL if the chunk is full
+static uint8_t* chunk_take(arena_chunk_t* c, size_t size) {
+  uint8_t* p = align_up(c->data + c->used + sizeof(alloc_hdr_t));
+  if (size > UINT32_MAX || p + size > c->data + c->size || p + size < p) {
+    return NULL;
+  }
+  alloc_hdr_t* hdr = (alloc_hdr_t*)p - 1;
+  hdr->size = size;
+  hdr->magic = ARENA_ALLOC_MAGIC;
+  c->mark = c->used;
+  c->last = p - c->data;
+  c->used = c->last + size;
+  return p;
+}
+
+static bool arena_memory(void const* p) { return ((alloc_hdr_t const*)p - 1)->magic == ARENA_ALLOC_MAGIC; }
+
+// the chunk of the task arena if p is its last allocation, only that one can grow in place or be rolled back
+static arena_chunk_t* last_chunk(void const* p) {
+  arena_chunk_t* c = task_arena ? task_arena->chunk : NULL;
+  return c && c->last != ARENA_NO_LAST && (uint8_t const*)p == c->data + c->last ? c : NULL;
+}
+
+arena_t* arena_new(size_t size, bool psram) {
+  arena_t* arena = chunk_malloc(sizeof(arena_t) + sizeof(arena_chunk_t) + size, psram);
+  if (arena == NULL) {
+    return NULL;
+  }
+  arena->magic = ARENA_MAGIC;
+  arena->psram = psram;
+  arena->chunk_size = size;
+  arena->first = (arena_chunk_t*)(arena + 1);
+  arena->chunk = arena->first;
+  chunk_init(arena->first, size, NULL);
+  return arena;
+}
+
+void* arena_alloc(arena_t* arena, size_t size) {
+  if (arena == NULL) {
+    return NULL;
+  }
+  uint8_t* p = chunk_take(arena->chunk, size);
+  if (p == NULL) {
+    // the next chunk fits at least the allocation
+    size_t chunk_size = size + sizeof(alloc_hdr_t) + ARENA_ALIGN;
+    chunk_size = chunk_size > arena->chunk_size ? chunk_size : arena->chunk_size;
+    arena_chunk_t* c = chunk_malloc(sizeof(arena_chunk_t) + chunk_size, arena->psram);
+    if (c == NULL) {
+      return NULL;
+    }
+    chunk_init(c, chunk_size, arena->chunk);
+    arena->chunk = c;
+    p = chunk_take(c, size);
+  }
+  return p;
+}
+
+arena_t* arena_enter(arena_t* arena) {
+  arena_t* prev = task_arena;
+  task_arena = arena;
+  return prev;
+}
+
+arena_t* arena_of(void const* first) {
+  if (first == NULL) {
+    return NULL;
+  }
+  // the arena is 4-byte aligned like all heap memory, it precedes the header and the padding of the first allocation
+  for (size_t pad = 0; pad < ARENA_ALIGN; pad += sizeof(uint32_t)) {
+    arena_t* arena = (arena_t*)((uint8_t const*)first - pad - sizeof(alloc_hdr_t) - sizeof(arena_chunk_t) -
+                                sizeof(arena_t));
+    if (arena->magic == ARENA_MAGIC && align_up(arena->first->data + sizeof(alloc_hdr_t)) == first) {
+      return arena;
+    }
+  }
+  return NULL;
+}
+
+size_t arena_used(arena_t const* arena) {
+  size_t used = 0;
+  for (arena_chunk_t const* c = arena ? arena->chunk : NULL; c; c = c->prev) {
+    used += c->used;
+  }
+  return used;
+}
+
+void arena_free(arena_t* arena) {
+  if (arena == NULL) {
+    return;
+  }
+  if (task_arena == arena) {
+    task_arena = NULL;
+  }
+  arena->magic = 0;
+  for (arena_chunk_t* c = arena->chunk; c != arena->first;) {
+    arena_chunk_t* prev = c->prev;
+    heap_caps_free(c);
+    c = prev;
+  }
+  heap_caps_free(arena);
+}
+
+void* arena_route_malloc(size_t size) { return task_arena ? arena_alloc(task_arena, size) : malloc(size); }
+
+void* arena_route_calloc(size_t n, size_t size) {
+  if (task_arena == NULL) {
+    return calloc(n, size);
+  }
+  if (size && n > SIZE_MAX / size) {
+    return NULL;
+  }
+  void* p = arena_alloc(task_arena, n * size);
+  if (p) {
+    memset(p, 0, n * size);
+  }
+  return p;
+}
+
+void* arena_route_realloc(void* ptr, size_t size) {
+  if (ptr == NULL) {
+    return arena_route_malloc(size);
+  }
+  if (!arena_memory(ptr)) {
+    // heap memory stays on the heap
+    return realloc(ptr, size);
+  }
+  alloc_hdr_t* hdr = (alloc_hdr_t*)ptr - 1;
+  arena_chunk_t* c = last_chunk(ptr);
+  // the last allocation grows in place, e.g. buffers that are appended to
+  if (c && size <= UINT32_MAX && (uint8_t*)ptr + size <= c->data + c->size) {
+    hdr->size = size;
+    c->used = c->last + size;
+    return ptr;
+  }
+  if (size <= hdr->size) {
+    return ptr;
+  }
+  if (task_arena == NULL) {
+    // the arena of the memory is unknown, it must not end up on the heap
+    printf("[%s:%d] arena memory grown outside of its arena\n", __func__, __LINE__);
+    return NULL;
+  }
+  void* p = arena_alloc(task_arena, size);
+  if (p) {
+    memcpy(p, ptr, hdr->size);
+  }
+  return p;
+}
+
+void arena_route_free(void* ptr) {
+  if (ptr == NULL) {
+    return;
+  }
+  if (!arena_memory(ptr)) {
+    free(ptr);
+    return;
+  }
+  // the last allocation is rolled back, e.g. temporary strings of the parsers, anything else waits for arena_free()
+  arena_chunk_t* c = last_chunk(ptr);
+  if (c) {
+    c->used = c->mark;
+    c->last = ARENA_NO_LAST;
+  }
+}
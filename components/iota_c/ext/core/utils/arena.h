@@ -0,0 +1,117 @@
+// Copyright 2022 IOTA Stiftung
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef __CORE_UTILS_ARENA_H__
+#define __CORE_UTILS_ARENA_H__
+
+#include <stdbool.h>
+#include <stddef.h>
+
+/**
+ * @brief A region allocations are taken from one after another and released all at once
+ *
+ * The region starts with the given size and grows by further chunks once it is full.
+ *
+ */
+typedef struct arena arena_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Create an arena
+ *
+ * @param[in] size The size of the first chunk
+ * @param[in] psram Allocate the chunks from external RAM if it is available
+ * @return arena_t* NULL on errors
+ */
+arena_t* arena_new(size_t size, bool psram);
+
+/**
+ * @brief Allocate from an arena
+ *
+ * @param[in] arena The arena
+ * @param[in] size The size of the allocation
+ * @return void* NULL if a further chunk cannot be allocated
+ */
+void* arena_alloc(arena_t* arena, size_t size);
+
+/**
+ * @brief Route the allocations of the calling task to an arena
+ *
+ * Only the allocations of the sources compiled with core/utils/arena_route.h are routed, i.e. the parsers and the
+ * models of iota.c. Allocations of other tasks and of the rest of the application, e.g. the cJSON tree while it is
+ * parsed, stay on the heap.
+ *
+ * @param[in] arena The arena, NULL to use the heap again
+ * @return arena_t* The arena used by the task before, to be restored with arena_enter()
+ */
+arena_t* arena_enter(arena_t* arena);
+
+/**
+ * @brief Find the arena of its first allocation
+ *
+ * @param[in] first The first allocation of an arena
+ * @return arena_t* NULL if the memory is not the first allocation of an arena
+ */
+arena_t* arena_of(void const* first);
+
+/**
+ * @brief The number of bytes taken from the chunks of an arena, including headers and padding
+ *
+ * @param[in] arena The arena
+ * @return size_t The bytes in use
+ */
+size_t arena_used(arena_t const* arena);
+
+/**
+ * @brief malloc() of the routed sources, taken from the arena of the task if one was entered
+ *
+ * @param[in] size The size of the allocation
+ * @return void* NULL on errors
+ */
+void* arena_route_malloc(size_t size);
+
+/**
+ * @brief calloc() of the routed sources
+ *
+ * @param[in] n The number of elements
+ * @param[in] size The size of an element
+ * @return void* NULL on errors
+ */
+void* arena_route_calloc(size_t n, size_t size);
+
+/**
+ * @brief realloc() of the routed sources, heap memory stays on the heap and arena memory in the arena
+ *
+ * Arena memory only grows while an arena is entered.
+ *
+ * @param[in] ptr The memory, NULL for a new allocation
+ * @param[in] size The new size
+ * @return void* NULL on errors
+ */
+void* arena_route_realloc(void* ptr, size_t size);
+
+/**
+ * @brief free() of the routed sources
+ *
+ * Heap memory is freed, memory of any arena is left to arena_free(). Only the last allocation of the entered arena is
+ * rolled back.
+ *
+ * @param[in] ptr The memory, can be NULL
+ */
+void arena_route_free(void* ptr);
+
+/**
+ * @brief Release an arena and all memory allocated from it
+ *
+ * @param[in] arena The arena
+ */
+void arena_free(arena_t* arena);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,19 @@
+// Copyright 2022 IOTA Stiftung
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef __CORE_UTILS_ARENA_ROUTE_H__
+#define __CORE_UTILS_ARENA_ROUTE_H__
+
+// Force-included into the iota.c sources that build response objects, see CMakeLists.txt. Their allocations are taken
+// from the arena the task entered, everything else in the application allocates from the heap as usual.
+
+#include <stdlib.h>
+
+#include "core/utils/arena.h"
+
+#define malloc(size) arena_route_malloc(size)
+#define calloc(n, size) arena_route_calloc(n, size)
+#define realloc(ptr, size) arena_route_realloc(ptr, size)
+#define free(ptr) arena_route_free(ptr)
+
+#endif
@@ -0,0 +1,109 @@
+// Copyright 2022 IOTA Stiftung
+// SPDX-License-Identifier: Apache-2.0
+
+#include <stdint.h>
+#include <string.h>
+
+#include "core/utils/byte_buffer.h"
+#include "core/utils/hex_codec.h"
+
+// words stored into character and byte buffers
+typedef uint16_t __attribute__((__may_alias__)) hex_pair_t;
+typedef uint32_t __attribute__((__may_alias__)) hex_word_t;
+
+#define HEX_DIGIT(n) ((n) < 10 ? '0' + (n) : 'a' + (n)-10)
+// the two characters of a byte in memory order, the targets are little-endian
+#define HEX_PAIR(b) ((uint16_t)(HEX_DIGIT((b) >> 4) | HEX_DIGIT((b)&0xf) << 8))
+// the value of a hex digit plus one, 0 for other characters
+#define HEX_VALUE(c)                           \
+  ((c) >= '0' && (c) <= '9'   ? (c) - '0' + 1  \
+   : (c) >= 'a' && (c) <= 'f' ? (c) - 'a' + 11 \
+   : (c) >= 'A' && (c) <= 'F' ? (c) - 'A' + 11 \
+                              : 0)
+
+#define HEX_TABLE4(m, i) m(i), m(i + 1), m(i + 2), m(i + 3)
+#define HEX_TABLE16(m, i) HEX_TABLE4(m, i), HEX_TABLE4(m, i + 4), HEX_TABLE4(m, i + 8), HEX_TABLE4(m, i + 12)
+#define HEX_TABLE64(m, i) HEX_TABLE16(m, i), HEX_TABLE16(m, i + 16), HEX_TABLE16(m, i + 32), HEX_TABLE16(m, i + 48)
+#define HEX_TABLE256(m) HEX_TABLE64(m, 0), HEX_TABLE64(m, 64), HEX_TABLE64(m, 128), HEX_TABLE64(m, 192)
+
+static uint16_t const hex_pairs[256] = {HEX_TABLE256(HEX_PAIR)};
+static uint8_t const hex_values[256] = {HEX_TABLE256(HEX_VALUE)};
+
+void hex_encode(uint8_t const bin[], size_t bin_len, char str[]) {
+  size_t i = 0;
+  if (((uintptr_t)str & 1) == 0) {
+    // a single pair aligns the output to a word, e.g. after a 0x prefix
+    if (((uintptr_t)str & 3) == 2 && bin_len > 0) {
+      *(hex_pair_t*)str = hex_pairs[bin[0]];
+      i = 1;
+    }
+    hex_word_t* out = (hex_word_t*)(str + i * 2);
+    for (; i + 4 <= bin_len; i += 4, out += 2) {
+      out[0] = hex_pairs[bin[i]] | (uint32_t)hex_pairs[bin[i + 1]] << 16;
+      out[1] = hex_pairs[bin[i + 2]] | (uint32_t)hex_pairs[bin[i + 3]] << 16;
+    }
+  }
+  for (; i < bin_len; i++) {
+    uint16_t pair = hex_pairs[bin[i]];
+    str[i * 2] = (char)(pair & 0xff);
+    str[i * 2 + 1] = (char)(pair >> 8);
+  }
+}
+
+int hex_decode(char const str[], size_t str_len, uint8_t bin[]) {
+  if (str_len & 1) {
+    return -1;
+  }
+  uint8_t const* s = (uint8_t const*)str;
+  size_t len = str_len / 2;
+  size_t i = 0;
+  // invalid characters set the high bits, they are checked once at the end
+  uint8_t invalid = 0;
+  if (((uintptr_t)bin & 3) == 0) {
+    // four bytes are collected and stored as a word
+    for (; i + 4 <= len; i += 4, s += 8) {
+      uint32_t word = 0;
+      for (size_t k = 0; k < 4; k++) {
+        uint8_t hi = hex_values[s[k * 2]] - 1;
+        uint8_t lo = hex_values[s[k * 2 + 1]] - 1;
+        invalid |= hi | lo;
+        word |= (uint32_t)(uint8_t)(hi << 4 | lo) << (k * 8);
+      }
+      *(hex_word_t*)(bin + i) = word;
+    }
+  }
+  for (; i < len; i++, s += 2) {
+    uint8_t hi = hex_values[s[0]] - 1;
+    uint8_t lo = hex_values[s[1]] - 1;
+    invalid |= hi | lo;
+    bin[i] = (uint8_t)(hi << 4 | lo);
+  }
+  return (invalid & 0xf0) ? -1 : 0;
+}
+
+// hex_2_bin() and bin_2_hex() are wrapped at link time, see CMakeLists.txt
+int __real_hex_2_bin(char const str[], size_t str_len, char const* prefix, byte_t bin[], size_t bin_len);
+int __real_bin_2_hex(byte_t const bin[], size_t bin_len, char const* prefix, char str_buf[], size_t buf_len);
+
+// well-formed input is converted here, anything else gets the checks and messages of the original
+int __wrap_hex_2_bin(char const str[], size_t str_len, char const* prefix, byte_t bin[], size_t bin_len) {
+  size_t prefix_len = prefix ? strlen(prefix) : 0;
+  if (str && bin && str_len >= prefix_len && (prefix_len == 0 || memcmp(str, prefix, prefix_len) == 0) &&
+      (str_len - prefix_len) / 2 <= bin_len && hex_decode(str + prefix_len, str_len - prefix_len, bin) == 0) {
+    return 0;
+  }
+  return __real_hex_2_bin(str, str_len, prefix, bin, bin_len);
+}
+
+int __wrap_bin_2_hex(byte_t const bin[], size_t bin_len, char const* prefix, char str_buf[], size_t buf_len) {
+  size_t prefix_len = prefix ? strlen(prefix) : 0;
+  if (bin && str_buf && bin_len < SIZE_MAX / 4 && buf_len > prefix_len + bin_len * 2) {
+    if (prefix_len) {
+      memcpy(str_buf, prefix, prefix_len);
+    }
+    hex_encode(bin, bin_len, str_buf + prefix_len);
+    str_buf[prefix_len + bin_len * 2] = '\0';
+    return 0;
+  }
+  return __real_bin_2_hex(bin, bin_len, prefix, str_buf, buf_len);
+}
@@ -0,0 +1,39 @@
+// Copyright 2022 IOTA Stiftung
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef __CORE_UTILS_HEX_CODEC_H__
+#define __CORE_UTILS_HEX_CODEC_H__
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Encode bytes as lowercase hex characters
+ *
+ * Two characters are looked up per byte and stored a word at a time where the output is aligned.
+ *
+ * @param[in] bin The bytes
+ * @param[in] bin_len The number of bytes
+ * @param[out] str A buffer of 2 * bin_len characters, it is not NULL terminated
+ */
+void hex_encode(uint8_t const bin[], size_t bin_len, char str[]);
+
+/**
+ * @brief Decode hex characters of either case into bytes
+ *
+ * @param[in] str The hex characters, without a prefix
+ * @param[in] str_len The number of characters, an even number
+ * @param[out] bin A buffer of str_len / 2 bytes
+ * @return int 0 on success, -1 if the length is odd or a character is not a hex digit
+ */
+int hex_decode(char const str[], size_t str_len, uint8_t bin[]);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
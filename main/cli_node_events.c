@@ -10,6 +10,7 @@
 #include "esp_log.h"
 #include "esp_system.h"
 #include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
 #include "freertos/task.h"
 
 #include "client/api/events/node_event.h"
@@ -18,8 +19,11 @@
 #include "client/api/events/sub_outputs_payload.h"
 #include "client/api/events/sub_serialized_output.h"
 
+#include "client/api/restful/confirm_tracker.h"
 #include "client/api/restful/get_block_metadata.h"
 #include "client/api/restful/get_output.h"
+#include "client/api/restful/tip_pool.h"
+#include "client/network/dns_cache.h"
 
 #include "cli_node_events.h"
 
@@ -37,12 +41,21 @@ event_client_handle_t client;
 bool is_client_running = false;
 int event_select_g = 0;
 
+// the broker address the client was started with, empty if it was given the host name
+static char events_ip[DNS_CACHE_IP_LEN];
+// guards starting and stopping the client
+static SemaphoreHandle_t events_lock = NULL;
+// taken while a restart of the client is pending
+static SemaphoreHandle_t events_restart = NULL;
+
 void process_event_data(event_client_event_t *event);
+static void events_check_address(bool failed);
 
 void callback(event_client_event_t *event) {
   switch (event->event_id) {
     case NODE_EVENT_ERROR:
       printf("Node event network error : %s\n", (char *)event->data);
+      events_check_address(true);
       break;
     case NODE_EVENT_CONNECTED:
       printf("Node event network connected\n");
@@ -91,6 +104,7 @@ void callback(event_client_event_t *event) {
       break;
     case NODE_EVENT_DISCONNECTED:
       printf("Node event network disconnected\n");
+      events_check_address(false);
       break;
     case NODE_EVENT_SUBSCRIBED:
       printf("Subscribed topic\n");
@@ -162,6 +176,11 @@ void process_event_data(event_client_event_t *event) {
     events_milestone_payload_t res = {};
     if (parse_milestone_payload((char *)data_buff, &res) == 0) {
       printf("Index :%u\nTimestamp : %u\n", res.index, res.timestamp);
+      // a new milestone references the current tips
+      tip_pool_refresh();
+      if (!strcmp(topic_buff, TOPIC_MILESTONE_CONFIRMED)) {
+        confirm_tracker_milestone(res.index);
+      }
     }
   }
   // check for topic blocks
@@ -197,14 +216,21 @@ void process_event_data(event_client_event_t *event) {
   free(data_buff);
 }
 
-int node_events(int event_select) {
+static int node_events_locked(int event_select) {
   if ((event_select == 0) && is_client_running) {
     event_destroy(client);
     is_client_running = false;
   } else if ((event_select > 0) && !is_client_running) {
     event_select_g = event_select;
-    event_client_config_t config = {
-        .host = EVENTS_HOST, .port = EVENTS_PORT, .client_id = EVENTS_CLIENT_ID, .keepalive = EVENTS_KEEP_ALIVE};
+    // the MQTT client reconnects to this address without resolving the broker host, events_check_address() starts a
+    // new client once the cached address changes
+    if (dns_cache_resolve(EVENTS_HOST, events_ip, sizeof(events_ip)) != 0) {
+      events_ip[0] = '\0';
+    }
+    event_client_config_t config = {.host = events_ip[0] ? events_ip : EVENTS_HOST,
+                                    .port = EVENTS_PORT,
+                                    .client_id = EVENTS_CLIENT_ID,
+                                    .keepalive = EVENTS_KEEP_ALIVE};
     client = event_init(&config);
     event_register_cb(client, &callback);
     int rc = event_start(client);
@@ -219,6 +245,49 @@ int node_events(int event_select) {
   return 0;
 }
 
+int node_events(int event_select) {
+  xSemaphoreTake(events_lock, portMAX_DELAY);
+  int ret = node_events_locked(event_select);
+  xSemaphoreGive(events_lock);
+  return ret;
+}
+
+// the client cannot be destroyed on its own task
+static void events_restart_task(void *arg) {
+  xSemaphoreTake(events_lock, portMAX_DELAY);
+  if (is_client_running) {
+    int event_select = event_select_g;
+    node_events_locked(0);
+    node_events_locked(event_select);
+  }
+  xSemaphoreGive(events_lock);
+  xSemaphoreGive(events_restart);
+  vTaskDelete(NULL);
+}
+
+// runs on the MQTT task whenever the connection is lost, the cache resolves the broker again once its entry expired
+static void events_check_address(bool failed) {
+  if (failed) {
+    // like a failed HTTP connection, the next lookup resolves the host again
+    dns_cache_expire(EVENTS_HOST);
+  }
+  // events_lock is held while the client is destroyed, which waits for this task
+  if (xSemaphoreTake(events_restart, 0) != pdTRUE) {
+    return;
+  }
+  char ip[DNS_CACHE_IP_LEN];
+  if (dns_cache_resolve(EVENTS_HOST, ip, sizeof(ip)) != 0 || strcmp(ip, events_ip) == 0) {
+    xSemaphoreGive(events_restart);
+    return;
+  }
+  printf("Broker address changed to %s, reconnecting\n", ip);
+  if (xTaskCreate(events_restart_task, "events_restart", CONFIG_IOTA_CLIENT_TASK_STACK_SIZE, NULL, tskIDLE_PRIORITY + 5,
+                  NULL) != pdPASS) {
+    printf("Failed to create the events restart task\n");
+    xSemaphoreGive(events_restart);
+  }
+}
+
 /* 'get_events_data' command */
 static struct {
   struct arg_str *event_select;
@@ -254,6 +323,10 @@ static int fn_get_node_events(int argc, char **argv) {
 }
 
 void register_node_events() {
+  events_lock = xSemaphoreCreateMutex();
+  events_restart = xSemaphoreCreateBinary();
+  ESP_ERROR_CHECK(events_lock && events_restart ? ESP_OK : ESP_ERR_NO_MEM);
+  xSemaphoreGive(events_restart);
   node_events_args.event_select = arg_str1(NULL, NULL, "<Events Select>", "Events Select");
   node_events_args.end = arg_end(2);
   const esp_console_cmd_t node_events_cmd = {
@@ -1,21 +1,43 @@
 // Copyright 2022 IOTA Stiftung
 // SPDX-License-Identifier: Apache-2.0
 
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
 #include "esp_console.h"
+#include "esp_heap_caps.h"
 #include "esp_log.h"
 #include "esp_system.h"
+#include "esp_timer.h"
 #include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
 #include "freertos/task.h"
 
 #include "argtable3/argtable3.h"
 #include "cli_restful.h"
+#include "client/api/restful/confirm_tracker.h"
 #include "client/api/restful/get_block.h"
+#include "client/api/restful/get_block_binary.h"
 #include "client/api/restful/get_block_metadata.h"
 #include "client/api/restful/get_node_info.h"
 #include "client/api/restful/get_output.h"
+#include "client/api/restful/get_outputs_batch.h"
 #include "client/api/restful/get_tips.h"
+#include "client/api/restful/outputs_id_iter.h"
+#include "client/api/restful/outputs_query.h"
+#include "client/api/restful/rest_async.h"
 #include "client/api/restful/send_tagged_data.h"
+#include "client/api/restful/single_flight.h"
+#include "client/api/restful/tip_pool.h"
 #include "client/client_service.h"
+#include "client/network/dns_cache.h"
+#include "client/network/http.h"
+#include "client/network/http_cache.h"
+#include "client/network/http_pool.h"
+#include "client/network/http_stats.h"
+#include "client/network/node_set.h"
 
 static const char *TAG = "restful";
 
@@ -100,6 +122,7 @@ static void register_api_tips() {
 /* 'api_get_blk' command */
 static struct {
   struct arg_str *blk_id;
+  struct arg_lit *binary;
   struct arg_end *end;
 } api_get_blk_args;
 
@@ -115,7 +138,11 @@ static int fn_api_get_blk(int argc, char **argv) {
     return -1;
   }
 
-  nerrors = get_block_by_id(&ctx, api_get_blk_args.blk_id->sval[0], blk);
+  if (api_get_blk_args.binary->count) {
+    nerrors = get_block_by_id_binary(&ctx, api_get_blk_args.blk_id->sval[0], blk);
+  } else {
+    nerrors = get_block_by_id(&ctx, api_get_blk_args.blk_id->sval[0], blk);
+  }
   if (nerrors == 0) {
     if (blk->is_error) {
       printf("Get block API response: %s\n", blk->u.error->msg);
@@ -160,11 +187,12 @@ static int fn_api_get_blk(int argc, char **argv) {
 
 static void register_api_get_blk() {
   api_get_blk_args.blk_id = arg_str1(NULL, NULL, "<Block ID>", "Block ID");
-  api_get_blk_args.end = arg_end(2);
+  api_get_blk_args.binary = arg_lit0("b", "binary", "Request the binary serialized block");
+  api_get_blk_args.end = arg_end(3);
   const esp_console_cmd_t api_get_blk_cmd = {
       .command = "api_get_blk",
       .help = "Get a block from a given block ID",
-      .hint = " <Block ID>",
+      .hint = " <Block ID> [-b]",
       .func = &fn_api_get_blk,
       .argtable = &api_get_blk_args,
   };
@@ -184,22 +212,18 @@ static int fn_api_blk_meta(int argc, char **argv) {
     return -1;
   }
 
-  res_block_meta_t *res = block_meta_new();
-  if (!res) {
-    printf("Allocate metadata response failed\n");
-    return -1;
+  // shares the request with identical calls in flight
+  res_block_meta_t *res = NULL;
+  nerrors = get_block_metadata_shared(&ctx, api_blk_meta_args.blk_id->sval[0], &res);
+  if (nerrors) {
+    printf("get_block_metadata error %d\n", nerrors);
   } else {
-    nerrors = get_block_metadata(&ctx, api_blk_meta_args.blk_id->sval[0], res);
-    if (nerrors) {
-      printf("get_block_metadata error %d\n", nerrors);
+    if (res->is_error) {
+      printf("%s\n", res->u.error->msg);
     } else {
-      if (res->is_error) {
-        printf("%s\n", res->u.error->msg);
-      } else {
-        print_block_metadata(res, 0);
-      }
+      print_block_metadata(res, 0);
     }
-    block_meta_free(res);
+    single_flight_release(res);
   }
   return nerrors;
 }
@@ -220,9 +244,68 @@ static void register_api_blk_meta() {
 /* 'api_get_output' command */
 static struct {
   struct arg_str *output_id;
+  struct arg_lit *background;
+  struct arg_int *timeout;
   struct arg_end *end;
 } api_get_output_args;
 
+typedef struct {
+  char *output_id;
+  res_output_t *res;
+} async_output_t;
+
+static void async_output_free(async_output_t *req) {
+  single_flight_release(req->res);
+  free(req->output_id);
+  free(req);
+}
+
+static int async_get_output(iota_client_conf_t const *conf, void *arg) {
+  async_output_t *req = (async_output_t *)arg;
+  return get_output_shared(conf, req->output_id, &req->res);
+}
+
+// runs on a worker task once the output was received
+static void async_output_done(int ret, void *arg) {
+  async_output_t *req = (async_output_t *)arg;
+  printf("\n%s\n", req->output_id);
+  if (ret == REST_ASYNC_ERR_TIMEOUT) {
+    printf("get_output timed out\n");
+  } else if (ret != 0) {
+    printf("get_output error\n");
+  } else if (req->res->is_error) {
+    printf("%s\n", req->res->u.error->msg);
+  } else {
+    dump_get_output_response(req->res, 0);
+  }
+  async_output_free(req);
+}
+
+static int get_output_background(char const *output_id, uint32_t timeout_ms) {
+  async_output_t *req = calloc(1, sizeof(async_output_t));
+  if (req == NULL) {
+    printf("Allocate request failed\n");
+    return -1;
+  }
+  req->output_id = strdup(output_id);
+  if (req->output_id == NULL) {
+    printf("Allocate output ID failed\n");
+    async_output_free(req);
+    return -1;
+  }
+
+  rest_async_req_t *handle = rest_async_submit(&ctx, async_get_output, req, async_output_done, timeout_ms);
+  if (handle == NULL) {
+    printf("rest_async_submit error\n");
+    async_output_free(req);
+    return -1;
+  }
+  // the callback owns the request
+  rest_async_release(handle);
+  printf("get_output queued\n");
+  return 0;
+}
+
 static int fn_api_get_output(int argc, char **argv) {
   int nerrors = arg_parse(argc, argv, (void **)&api_get_output_args);
   if (nerrors != 0) {
@@ -230,48 +313,203 @@ static int fn_api_get_output(int argc, char **argv) {
     return -1;
   }
 
-  res_output_t *res = get_output_response_new();
-  if (!res) {
-    printf("Allocate output response failed\n");
-    return -1;
-  } else {
-    nerrors = get_output(&ctx, api_get_output_args.output_id->sval[0], res);
-    if (nerrors != 0) {
-      printf("get_output error\n");
+  if (api_get_output_args.background->count) {
+    int timeout_ms = api_get_output_args.timeout->count ? api_get_output_args.timeout->ival[0] : 0;
+    if (timeout_ms < 0) {
+      printf("invalid timeout\n");
       return -1;
-    } else {
-      if (res->is_error) {
-        printf("%s\n", res->u.error->msg);
-      } else {
-        dump_get_output_response(res, 0);
-      }
     }
-    get_output_response_free(res);
+    return get_output_background(api_get_output_args.output_id->sval[0], timeout_ms);
   }
 
+  // shares the request with identical calls in flight, e.g. a background request of the same output
+  res_output_t *res = NULL;
+  nerrors = get_output_shared(&ctx, api_get_output_args.output_id->sval[0], &res);
+  if (nerrors != 0) {
+    printf("get_output error\n");
+    return -1;
+  }
+  if (res->is_error) {
+    printf("%s\n", res->u.error->msg);
+  } else {
+    dump_get_output_response(res, 0);
+  }
+  single_flight_release(res);
+
   return nerrors;
 }
 
 static void register_api_get_output() {
   api_get_output_args.output_id = arg_str1(NULL, NULL, "<Output ID>", "An output ID");
-  api_get_output_args.end = arg_end(2);
+  api_get_output_args.background = arg_lit0("a", "async", "Return at once and print the output when it arrives");
+  api_get_output_args.timeout = arg_int0("t", "timeout", "<ms>", "Timeout of the background request");
+  api_get_output_args.end = arg_end(4);
   const esp_console_cmd_t api_get_output_cmd = {
       .command = "api_get_output",
       .help = "Get the output object from a given output ID",
-      .hint = " <Output ID>",
+      .hint = " <Output ID> [-a [-t <ms>]]",
       .func = &fn_api_get_output,
       .argtable = &api_get_output_args,
   };
   ESP_ERROR_CHECK(esp_console_cmd_register(&api_get_output_cmd));
 }
 
+/* 'api_get_outputs' command */
+#define API_GET_OUTPUTS_MAX 16
+
+static struct {
+  struct arg_str *output_ids;
+  struct arg_int *concurrency;
+  struct arg_end *end;
+} api_get_outputs_args;
+
+static int fn_api_get_outputs(int argc, char **argv) {
+  int nerrors = arg_parse(argc, argv, (void **)&api_get_outputs_args);
+  if (nerrors != 0) {
+    arg_print_errors(stderr, api_get_outputs_args.end, argv[0]);
+    return -1;
+  }
+
+  size_t count = api_get_outputs_args.output_ids->count;
+  int concurrency = api_get_outputs_args.concurrency->count ? api_get_outputs_args.concurrency->ival[0] : 0;
+  if (concurrency < 0 || concurrency > UINT8_MAX) {
+    printf("invalid concurrency\n");
+    return -1;
+  }
+
+  output_batch_item_t results[API_GET_OUTPUTS_MAX] = {};
+  TickType_t start = xTaskGetTickCount();
+  nerrors = get_outputs_batch(&ctx, api_get_outputs_args.output_ids->sval, count, concurrency, results);
+  if (nerrors != 0) {
+    printf("get_outputs_batch error\n");
+    return -1;
+  }
+  uint32_t elapsed = (xTaskGetTickCount() - start) * portTICK_PERIOD_MS;
+
+  for (size_t i = 0; i < count; i++) {
+    printf("%s\n", api_get_outputs_args.output_ids->sval[i]);
+    if (results[i].ret != 0) {
+      printf("get_output error %d\n", results[i].ret);
+      nerrors = -1;
+    } else if (results[i].res->is_error) {
+      printf("%s\n", results[i].res->u.error->msg);
+    } else {
+      dump_get_output_response(results[i].res, 0);
+    }
+  }
+  printf("%zu outputs in %" PRIu32 " ms\n", count, elapsed);
+  get_outputs_batch_free(results, count);
+  return nerrors;
+}
+
+static void register_api_get_outputs() {
+  api_get_outputs_args.output_ids = arg_strn(NULL, NULL, "<Output ID>", 1, API_GET_OUTPUTS_MAX, "Output IDs, up to 16");
+  api_get_outputs_args.concurrency = arg_int0("c", "concurrency", "<N>", "Requests in flight");
+  api_get_outputs_args.end = arg_end(API_GET_OUTPUTS_MAX + 2);
+  const esp_console_cmd_t api_get_outputs_cmd = {
+      .command = "api_get_outputs",
+      .help = "Get the output objects of the given output IDs concurrently",
+      .hint = " <Output ID>... [-c <N>]",
+      .func = &fn_api_get_outputs,
+      .argtable = &api_get_outputs_args,
+  };
+  ESP_ERROR_CHECK(esp_console_cmd_register(&api_get_outputs_cmd));
+}
+
+/* 'api_outputs' command */
+static struct {
+  struct arg_str *address;
+  struct arg_int *page_size;
+  struct arg_lit *prefetch;
+  struct arg_lit *spendable;
+  struct arg_str *tag;
+  struct arg_end *end;
+} api_outputs_args;
+
+static int fn_api_outputs(int argc, char **argv) {
+  int nerrors = arg_parse(argc, argv, (void **)&api_outputs_args);
+  if (nerrors != 0) {
+    arg_print_errors(stderr, api_outputs_args.end, argv[0]);
+    return -1;
+  }
+
+  outputs_query_t filters = {.address = api_outputs_args.address->sval[0]};
+  if (api_outputs_args.spendable->count) {
+    outputs_query_spendable(&filters, api_outputs_args.address->sval[0]);
+  }
+  filters.tag = api_outputs_args.tag->count ? api_outputs_args.tag->sval[0] : NULL;
+  char query[256] = {};
+  if (outputs_query_str(&filters, query, sizeof(query)) < 0) {
+    printf("invalid filters\n");
+    return -1;
+  }
+  int page_size = api_outputs_args.page_size->count ? api_outputs_args.page_size->ival[0] : 100;
+  if (page_size <= 0 || page_size > UINT16_MAX) {
+    printf("invalid page size\n");
+    return -1;
+  }
+
+  outputs_id_iter_t *it = outputs_id_iter_new(&ctx, query, page_size, api_outputs_args.prefetch->count > 0);
+  if (it == NULL) {
+    printf("outputs_id_iter_new error\n");
+    return -1;
+  }
+
+  char output_id[OUTPUTS_ID_HEX_LEN + 1] = {};
+  size_t count = 0;
+  while ((nerrors = outputs_id_iter_next(it, output_id)) == 0) {
+    printf("%s\n", output_id);
+    count++;
+  }
+
+  if (nerrors < 0) {
+    res_err_t const *error = outputs_id_iter_error(it);
+    printf("%s\n", error ? error->msg : "outputs_id_iter_next error");
+  } else {
+    printf("%zu output IDs at ledger index %" PRIu32 "\n", count, outputs_id_iter_ledger_index(it));
+    nerrors = 0;
+  }
+  outputs_id_iter_free(it);
+  return nerrors;
+}
+
+static void register_api_outputs() {
+  api_outputs_args.address = arg_str1(NULL, NULL, "<Address>", "Bech32 address");
+  api_outputs_args.page_size = arg_int0("p", "page", "<Size>", "Output IDs per request, default 100");
+  api_outputs_args.prefetch = arg_lit0("f", "prefetch", "Fetch the next page in the background");
+  api_outputs_args.spendable =
+      arg_lit0("s", "spendable", "Skip outputs with storage deposit return, timelock or expiration conditions");
+  api_outputs_args.tag = arg_str0("t", "tag", "<Tag>", "Only outputs with this hex encoded tag");
+  api_outputs_args.end = arg_end(6);
+  const esp_console_cmd_t api_outputs_cmd = {
+      .command = "api_outputs",
+      .help = "Get basic output IDs of a given address",
+      .hint = " <Address> [-p <Size>] [-f] [-s] [-t <Tag>]",
+      .func = &fn_api_outputs,
+      .argtable = &api_outputs_args,
+  };
+  ESP_ERROR_CHECK(esp_console_cmd_register(&api_outputs_cmd));
+}
+
 /* 'api_send_blk' command */
+// blocks that are not final by then are reported as expired
+#define CONFIRM_TIMEOUT_S 120
+
 static struct {
   struct arg_str *tag;
   struct arg_str *data;
+  struct arg_lit *wait;
   struct arg_end *end;
 } api_send_tag_args;
 
+static void print_confirmation(char const blk_id[], confirm_state_e state, uint32_t milestone_index, void *ctx) {
+  printf("Block %s: %s", blk_id, confirm_state_str(state));
+  if (milestone_index) {
+    printf(" by milestone %" PRIu32, milestone_index);
+  }
+  printf("\n");
+}
+
 static int fn_api_send_tagged_data_str(int argc, char **argv) {
   int nerrors = arg_parse(argc, argv, (void **)&api_send_tag_args);
   if (nerrors != 0) {
@@ -293,6 +531,11 @@ static int fn_api_send_tagged_data_str(int argc, char **argv) {
       res_err_free(res.u.error);
     } else {
       printf("Block ID: %s\n", res.u.blk_id);
+      if (api_send_tag_args.wait->count &&
+          (confirm_tracker_start(&ctx, CONFIG_IOTA_CONFIRM_INTERVAL_MS) != 0 ||
+           confirm_tracker_add(res.u.blk_id, CONFIRM_TIMEOUT_S, print_confirmation, NULL) != 0)) {
+        printf("track block failed\n");
+      }
     }
   }
   return nerrors;
@@ -301,17 +544,528 @@ static int fn_api_send_tagged_data_str(int argc, char **argv) {
 static void register_api_send_tagged_data_str() {
   api_send_tag_args.tag = arg_str1(NULL, NULL, "<Tag>", "Tag");
   api_send_tag_args.data = arg_str1(NULL, NULL, "<Data>", "Tagged Data");
-  api_send_tag_args.end = arg_end(3);
+  api_send_tag_args.wait = arg_lit0("w", "wait", "Print the state of the block once it is final");
+  api_send_tag_args.end = arg_end(4);
   const esp_console_cmd_t api_send_tag_cmd = {
       .command = "api_send_tagged_str",
       .help = "Send out tagged data string to the Tangle",
-      .hint = " <Tag> <Data>",
+      .hint = " <Tag> <Data> [-w]",
       .func = &fn_api_send_tagged_data_str,
       .argtable = &api_send_tag_args,
   };
   ESP_ERROR_CHECK(esp_console_cmd_register(&api_send_tag_cmd));
 }
 
+/* 'http_pool' command */
+static struct {
+  struct arg_lit *reset;
+  struct arg_lit *clear;
+  struct arg_end *end;
+} http_pool_args;
+
+static int fn_http_pool(int argc, char **argv) {
+  int nerrors = arg_parse(argc, argv, (void **)&http_pool_args);
+  if (nerrors != 0) {
+    arg_print_errors(stderr, http_pool_args.end, argv[0]);
+    return -1;
+  }
+
+  http_pool_stats_t stats = {};
+  http_pool_get_stats(&stats);
+  printf("connections: %u open, %u in use\n", stats.open, stats.in_use);
+  printf("requests: %" PRIu32 ", errors: %" PRIu32 "\n", stats.requests, stats.errors);
+  printf("reused: %" PRIu32 ", missed: %" PRIu32 "\n", stats.reused, stats.missed);
+  printf("expired: %" PRIu32 ", evicted: %" PRIu32 ", stale: %" PRIu32 "\n", stats.expired, stats.evicted, stats.stale);
+  if (stats.compressed) {
+    printf("compressed: %" PRIu32 " responses, %" PRIu64 " -> %" PRIu64 " bytes (%.2fx), inflate %" PRIu64 " ms\n",
+           stats.compressed, stats.compressed_bytes, stats.inflated_bytes,
+           (double)stats.inflated_bytes / stats.compressed_bytes, stats.inflate_us / 1000);
+  }
+  printf("tls handshakes: %" PRIu32 " resumed, %" PRIu32 " full\n", stats.tls_resumed, stats.tls_full);
+  printf("retries: %" PRIu32 ", hedged: %" PRIu32 ", hedge wins: %" PRIu32 "\n", stats.retries, stats.hedged,
+         stats.hedge_wins);
+#if CONFIG_IOTA_HTTP2
+  printf("http2: %" PRIu32 " connections, %" PRIu32 " streams, %u in flight, %" PRIu32 " sent with HTTP/1.1\n",
+         stats.h2_sessions, stats.h2_streams, stats.h2_active, stats.h2_fallbacks);
+#endif
+  http_cache_stats_t cache = {};
+  http_cache_get_stats(&cache);
+  printf("cache: %" PRIu32 " hits, %" PRIu32 " misses, %" PRIu32 " evictions, %" PRIu32 " entries, %zu/%zu bytes\n",
+         cache.hits, cache.misses, cache.evictions, cache.entries, cache.bytes, cache.budget);
+  single_flight_stats_t flights = {};
+  single_flight_get_stats(&flights);
+  printf("coalesced: %" PRIu32 " calls, %" PRIu32 " joined, %" PRIu32 " shared results held\n", flights.calls,
+         flights.joined, flights.results);
+  dns_cache_stats_t dns = {};
+  dns_cache_get_stats(&dns);
+  printf("dns: %" PRIu32 " hits, %" PRIu32 " misses, %" PRIu32 " refreshes, %" PRIu32 " stale, %" PRIu32
+         " failures, %u entries\n",
+         dns.hits, dns.misses, dns.refreshes, dns.stale, dns.failures, dns.entries);
+  if (http_pool_args.reset->count) {
+    http_pool_reset_stats();
+    http_cache_reset_stats();
+    dns_cache_reset_stats();
+  }
+  if (http_pool_args.clear->count) {
+    http_cache_clear();
+  }
+  return 0;
+}
+
+static void register_http_pool() {
+  http_pool_args.reset = arg_lit0("r", "reset", "Reset counters after printing");
+  http_pool_args.clear = arg_lit0("c", "clear", "Clear the response cache");
+  http_pool_args.end = arg_end(3);
+  const esp_console_cmd_t http_pool_cmd = {
+      .command = "http_pool",
+      .help = "Show HTTP connection pool, response cache, coalescing and DNS cache counters",
+      .hint = " [-r] [-c]",
+      .func = &fn_http_pool,
+      .argtable = &http_pool_args,
+  };
+  ESP_ERROR_CHECK(esp_console_cmd_register(&http_pool_cmd));
+}
+
+/* 'bench_api' command */
+#define BENCH_API_MAX_COUNT 500
+#define BENCH_API_MAX_CONCURRENCY 8
+#define BENCH_API_OUTPUTS_PAGE_SIZE 100
+
+static struct {
+  struct arg_int *count;
+  struct arg_int *concurrency;
+  struct arg_lit *http1;
+  struct arg_str *output_id;
+  struct arg_str *blk_id;
+  struct arg_str *address;
+  struct arg_end *end;
+} bench_api_args;
+
+static struct {
+  char output_id[OUTPUTS_ID_HEX_LEN + 1];
+  char blk_id[2 + IOTA_BLOCK_ID_BYTES * 2 + 1];
+  char address[128];
+} bench_params;
+
+static int bench_node_info() {
+  res_node_info_t *info = res_node_info_new();
+  if (info == NULL) {
+    return -1;
+  }
+  int ret = get_node_info(&ctx, info);
+  ret = ret == 0 && !info->is_error ? 0 : -1;
+  res_node_info_free(info);
+  return ret;
+}
+
+static int bench_get_output() {
+  res_output_t *res = get_output_response_new();
+  if (res == NULL) {
+    return -1;
+  }
+  int ret = get_output(&ctx, bench_params.output_id, res);
+  ret = ret == 0 && !res->is_error ? 0 : -1;
+  get_output_response_free(res);
+  return ret;
+}
+
+static int bench_outputs_id() {
+  char query[160] = {};
+  snprintf(query, sizeof(query), "address=%s", bench_params.address);
+  outputs_id_iter_t *it = outputs_id_iter_new(&ctx, query, BENCH_API_OUTPUTS_PAGE_SIZE, false);
+  if (it == NULL) {
+    return -1;
+  }
+  char output_id[OUTPUTS_ID_HEX_LEN + 1] = {};
+  int ret = 0;
+  while ((ret = outputs_id_iter_next(it, output_id)) == 0) {
+    // only the requests are measured
+  }
+  outputs_id_iter_free(it);
+  return ret == 1 ? 0 : -1;
+}
+
+static int bench_get_block() {
+  res_block_t *blk = res_block_new();
+  if (blk == NULL) {
+    return -1;
+  }
+  int ret = get_block_by_id(&ctx, bench_params.blk_id, blk);
+  ret = ret == 0 && !blk->is_error ? 0 : -1;
+  res_block_free(blk);
+  return ret;
+}
+
+static int bench_send_block() {
+  char const *tag = "bench_api";
+  char const *data = "esp32 client benchmark";
+  res_send_block_t res = {};
+  int ret = send_tagged_data_block(&ctx, 2, (byte_t *)tag, strlen(tag), (byte_t *)data, strlen(data), &res);
+  if (ret == 0 && res.is_error) {
+    res_err_free(res.u.error);
+    ret = -1;
+  }
+  return ret;
+}
+
+static const struct {
+  char const *name;
+  int (*fn)();
+} bench_api_cases[] = {
+    {"node_info", bench_node_info},
+    {"output", bench_get_output},
+    {"outputs_id", bench_outputs_id},
+    {"block", bench_get_block},
+    {"send_block", bench_send_block},
+};
+
+static int cmp_u32(void const *a, void const *b) {
+  uint32_t x = *(uint32_t const *)a, y = *(uint32_t const *)b;
+  return x < y ? -1 : x > y;
+}
+
+static double bench_percentile_ms(uint32_t const sorted_us[], size_t n, uint8_t pct) {
+  size_t rank = (n * pct + 99) / 100;
+  return sorted_us[rank ? rank - 1 : 0] / 1000.0;
+}
+
+typedef struct {
+  int (*fn)();             ///< the request of the case
+  size_t count;            ///< the requests to send
+  size_t next;             ///< the next request to send
+  uint32_t errors;         ///< failed requests
+  uint32_t *latency_us;    ///< the latency of each request
+  SemaphoreHandle_t lock;  ///< guards next and errors
+  SemaphoreHandle_t done;  ///< given by each worker task once no request is left
+} bench_run_t;
+
+static void bench_run_requests(bench_run_t *run) {
+  for (;;) {
+    xSemaphoreTake(run->lock, portMAX_DELAY);
+    size_t i = run->next < run->count ? run->next++ : run->count;
+    xSemaphoreGive(run->lock);
+    if (i == run->count) {
+      return;
+    }
+    int64_t t = esp_timer_get_time();
+    int ret = run->fn();
+    run->latency_us[i] = esp_timer_get_time() - t;
+    if (ret != 0) {
+      xSemaphoreTake(run->lock, portMAX_DELAY);
+      run->errors++;
+      xSemaphoreGive(run->lock);
+    }
+  }
+}
+
+static void bench_api_worker(void *arg) {
+  bench_run_t *run = (bench_run_t *)arg;
+  bench_run_requests(run);
+  xSemaphoreGive(run->done);
+  vTaskDelete(NULL);
+}
+
+// sends the requests of a case from the calling task and concurrency - 1 worker tasks
+static void bench_api_run(char const *name, int (*fn)(), size_t count, size_t concurrency, uint32_t latency_us[]) {
+  bench_run_t run = {.fn = fn, .count = count, .latency_us = latency_us};
+  run.lock = xSemaphoreCreateMutex();
+  run.done = xSemaphoreCreateCounting(BENCH_API_MAX_CONCURRENCY, 0);
+  if (run.lock == NULL || run.done == NULL) {
+    printf("%-10s out of memory\n", name);
+    if (run.lock) {
+      vSemaphoreDelete(run.lock);
+    }
+    if (run.done) {
+      vSemaphoreDelete(run.done);
+    }
+    return;
+  }
+
+  size_t free_before = heap_caps_get_free_size(MALLOC_CAP_8BIT);
+  size_t min_before = heap_caps_get_minimum_free_size(MALLOC_CAP_8BIT);
+  int64_t start = esp_timer_get_time();
+  size_t workers = 0;
+  for (size_t i = 1; i < concurrency; i++) {
+    if (xTaskCreate(bench_api_worker, "bench_api", CONFIG_IOTA_CLIENT_TASK_STACK_SIZE, &run, uxTaskPriorityGet(NULL),
+                    NULL) != pdPASS) {
+      printf("create worker task failed, %zu requests in flight\n", workers + 1);
+      break;
+    }
+    workers++;
+  }
+  bench_run_requests(&run);
+  while (workers--) {
+    xSemaphoreTake(run.done, portMAX_DELAY);
+  }
+  int64_t elapsed_us = esp_timer_get_time() - start;
+  size_t min_after = heap_caps_get_minimum_free_size(MALLOC_CAP_8BIT);
+  vSemaphoreDelete(run.lock);
+  vSemaphoreDelete(run.done);
+
+  qsort(latency_us, count, sizeof(uint32_t), cmp_u32);
+  printf("%-10s %5zu %6" PRIu32 " %8.1f %8.1f %8.1f %8.1f %8.1f", name, count, run.errors, count * 1e6 / elapsed_us,
+         bench_percentile_ms(latency_us, count, 50), bench_percentile_ms(latency_us, count, 90),
+         bench_percentile_ms(latency_us, count, 99), latency_us[count - 1] / 1000.0);
+  // the low water mark of the heap only moves if this case needed more than anything before
+  if (min_after < min_before) {
+    printf(" %9zu\n", free_before - min_after);
+  } else {
+    printf(" %9s\n", "-");
+  }
+}
+
+static int fn_bench_api(int argc, char **argv) {
+  int nerrors = arg_parse(argc, argv, (void **)&bench_api_args);
+  if (nerrors != 0) {
+    arg_print_errors(stderr, bench_api_args.end, argv[0]);
+    return -1;
+  }
+
+  int count = bench_api_args.count->count ? bench_api_args.count->ival[0] : 20;
+  if (count <= 0 || count > BENCH_API_MAX_COUNT) {
+    printf("count must be 1 to %d\n", BENCH_API_MAX_COUNT);
+    return -1;
+  }
+  int concurrency = bench_api_args.concurrency->count ? bench_api_args.concurrency->ival[0] : 1;
+  if (concurrency <= 0 || concurrency > BENCH_API_MAX_CONCURRENCY) {
+    printf("concurrency must be 1 to %d\n", BENCH_API_MAX_CONCURRENCY);
+    return -1;
+  }
+  // the default IDs are only known to the mock node
+  memset(&bench_params, 0, sizeof(bench_params));
+  snprintf(bench_params.output_id, sizeof(bench_params.output_id), "0x%0*d", OUTPUTS_ID_HEX_LEN - 2, 0);
+  snprintf(bench_params.blk_id, sizeof(bench_params.blk_id), "0x%0*d", IOTA_BLOCK_ID_BYTES * 2, 0);
+  strcpy(bench_params.address, "rms1mock");
+  if (bench_api_args.output_id->count) {
+    snprintf(bench_params.output_id, sizeof(bench_params.output_id), "%s", bench_api_args.output_id->sval[0]);
+  }
+  if (bench_api_args.blk_id->count) {
+    snprintf(bench_params.blk_id, sizeof(bench_params.blk_id), "%s", bench_api_args.blk_id->sval[0]);
+  }
+  if (bench_api_args.address->count) {
+    snprintf(bench_params.address, sizeof(bench_params.address), "%s", bench_api_args.address->sval[0]);
+  }
+
+  uint32_t *latency_us = malloc(count * sizeof(uint32_t));
+  if (latency_us == NULL) {
+    printf("Allocate latency buffer failed\n");
+    return -1;
+  }
+  // both transports start without open connections, every request goes to the node
+  bool http2 = http_pool_set_http2(bench_api_args.http1->count == 0);
+  bool cache = http_cache_set_enabled(false);
+  http_pool_flush();
+  printf("%s:%u, %d requests per case, %d in flight\n", ctx.host, ctx.port, count, concurrency);
+  printf("%-10s %5s %6s %8s %8s %8s %8s %8s %9s\n", "case", "count", "errors", "req/s", "p50(ms)", "p90(ms)",
+         "p99(ms)", "max(ms)", "heap_peak");
+  for (size_t i = 0; i < sizeof(bench_api_cases) / sizeof(bench_api_cases[0]); i++) {
+    bench_api_run(bench_api_cases[i].name, bench_api_cases[i].fn, count, concurrency, latency_us);
+  }
+  http_pool_set_http2(http2);
+  http_cache_set_enabled(cache);
+  free(latency_us);
+  return 0;
+}
+
+static void register_bench_api() {
+  bench_api_args.count = arg_int0("n", "count", "<N>", "Requests per case, default 20");
+  bench_api_args.concurrency = arg_int0("c", "concurrency", "<N>", "Requests in flight, default 1");
+  bench_api_args.http1 = arg_lit0("1", "http1", "Use the HTTP/1.1 connection pool even if HTTP/2 is enabled");
+  bench_api_args.output_id = arg_str0("o", "output", "<Output ID>", "Output ID to get, any ID works on the mock node");
+  bench_api_args.blk_id = arg_str0("b", "block", "<Block ID>", "Block ID to get, any ID works on the mock node");
+  bench_api_args.address = arg_str0("a", "address", "<Address>", "Bech32 address of the output IDs query");
+  bench_api_args.end = arg_end(7);
+  const esp_console_cmd_t bench_api_cmd = {
+      .command = "bench_api",
+      .help = "Benchmark node_info, output, outputs_id, block and send_block requests against the node",
+      .hint = " [-n <N>] [-c <N>] [-1] [-o <Output ID>] [-b <Block ID>] [-a <Address>]",
+      .func = &fn_bench_api,
+      .argtable = &bench_api_args,
+  };
+  ESP_ERROR_CHECK(esp_console_cmd_register(&bench_api_cmd));
+}
+
+/* 'api_stats' command */
+static struct {
+  struct arg_lit *reset;
+  struct arg_end *end;
+} api_stats_args;
+
+static int fn_api_stats(int argc, char **argv) {
+  int nerrors = arg_parse(argc, argv, (void **)&api_stats_args);
+  if (nerrors != 0) {
+    arg_print_errors(stderr, api_stats_args.end, argv[0]);
+    return -1;
+  }
+
+  http_endpoint_stats_t *stats = malloc(HTTP_STATS_MAX_ENDPOINTS * sizeof(http_endpoint_stats_t));
+  if (stats == NULL) {
+    printf("Allocate endpoint stats failed\n");
+    return -1;
+  }
+  size_t len = http_stats_get(stats);
+  for (size_t i = 0; i < len; i++) {
+    printf("%s %s: %" PRIu32 " requests, %" PRIu32 " errors\n", stats[i].method, stats[i].path, stats[i].requests,
+           stats[i].errors);
+    printf("  %-8s %6s %8s %8s %8s %8s\n", "phase", "count", "avg(ms)", "p50(ms)", "p90(ms)", "max(ms)");
+    for (size_t p = 0; p < HTTP_PHASE_MAX; p++) {
+      http_histogram_t const *h = &stats[i].phases[p];
+      if (h->count == 0) {
+        continue;
+      }
+      printf("  %-8s %6" PRIu32 " %8.1f %8" PRIu32 " %8" PRIu32 " %8.1f\n", http_phase_str(p), h->count,
+             (double)h->sum_us / h->count / 1000, http_stats_percentile_ms(h, 50), http_stats_percentile_ms(h, 90),
+             (double)h->max_us / 1000);
+    }
+  }
+  if (len == 0) {
+    printf("no requests recorded\n");
+  }
+  free(stats);
+
+  if (api_stats_args.reset->count) {
+    http_stats_reset();
+  }
+  return 0;
+}
+
+static void register_api_stats() {
+  api_stats_args.reset = arg_lit0("r", "reset", "Reset the statistics after printing");
+  api_stats_args.end = arg_end(2);
+  const esp_console_cmd_t api_stats_cmd = {
+      .command = "api_stats",
+      .help = "Show latency histograms of the REST endpoints per phase",
+      .hint = " [-r]",
+      .func = &fn_api_stats,
+      .argtable = &api_stats_args,
+  };
+  ESP_ERROR_CHECK(esp_console_cmd_register(&api_stats_cmd));
+}
+
+/* 'node_stats' command */
+static struct {
+  struct arg_lit *probe;
+  struct arg_end *end;
+} node_stats_args;
+
+static int fn_node_stats(int argc, char **argv) {
+  int nerrors = arg_parse(argc, argv, (void **)&node_stats_args);
+  if (nerrors != 0) {
+    arg_print_errors(stderr, node_stats_args.end, argv[0]);
+    return -1;
+  }
+
+  if (node_stats_args.probe->count) {
+    printf("%d healthy nodes\n", node_set_probe());
+  }
+
+  node_set_stats_t stats[NODE_SET_MAX_NODES] = {};
+  size_t len = node_set_get_stats(stats);
+  if (len == 0) {
+    printf("no backup nodes, requests go to %s:%u\n", ctx.host, ctx.port);
+    return 0;
+  }
+  printf("node\thealthy\tlatency(ms)\tselected\tfailures\n");
+  for (size_t i = 0; i < len; i++) {
+    printf("%s%s:%u\t%s\t%" PRIu32 "\t%" PRIu32 "\t%" PRIu32 "\n", stats[i].use_tls ? "https://" : "", stats[i].host,
+           stats[i].port, stats[i].healthy ? "yes" : "no", stats[i].latency_ms, stats[i].selected, stats[i].failures);
+  }
+  return 0;
+}
+
+static void register_node_stats() {
+  node_stats_args.probe = arg_lit0("p", "probe", "Probe the nodes now");
+  node_stats_args.end = arg_end(2);
+  const esp_console_cmd_t node_stats_cmd = {
+      .command = "node_stats",
+      .help = "Show health, latency and selection counters of the nodes",
+      .hint = " [-p]",
+      .func = &fn_node_stats,
+      .argtable = &node_stats_args,
+  };
+  ESP_ERROR_CHECK(esp_console_cmd_register(&node_stats_cmd));
+}
+
+/* 'tip_pool' command */
+// the defaults of the options are the configured values
+#define TIP_POOL_STR0(x) #x
+#define TIP_POOL_STR(x) TIP_POOL_STR0(x)
+
+static struct {
+  struct arg_lit *start;
+  struct arg_lit *stop;
+  struct arg_int *interval;
+  struct arg_int *max_age;
+  struct arg_end *end;
+} tip_pool_args;
+
+static int fn_tip_pool(int argc, char **argv) {
+  int nerrors = arg_parse(argc, argv, (void **)&tip_pool_args);
+  if (nerrors != 0) {
+    arg_print_errors(stderr, tip_pool_args.end, argv[0]);
+    return -1;
+  }
+
+  if (tip_pool_args.stop->count) {
+    tip_pool_stop();
+  } else if (tip_pool_args.start->count) {
+    uint32_t interval =
+        tip_pool_args.interval->count ? tip_pool_args.interval->ival[0] : CONFIG_IOTA_TIP_POOL_INTERVAL_MS;
+    uint32_t max_age = tip_pool_args.max_age->count ? tip_pool_args.max_age->ival[0] : CONFIG_IOTA_TIP_POOL_MAX_AGE_MS;
+    if (tip_pool_start(&ctx, interval, max_age) != 0) {
+      printf("start tip pool failed\n");
+      return -1;
+    }
+  }
+
+  tip_pool_stats_t stats = {};
+  tip_pool_get_stats(&stats);
+  printf("tips: %" PRIu32 ", age: %" PRIu32 " ms\n", stats.tips, stats.age_ms);
+  printf("refreshes: %" PRIu32 ", failures: %" PRIu32 "\n", stats.refreshes, stats.failures);
+  printf("blocks: %" PRIu32 " from the pool, %" PRIu32 " without fresh tips\n", stats.hits, stats.misses);
+  return 0;
+}
+
+static void register_tip_pool() {
+  tip_pool_args.start = arg_lit0("s", "start", "Start refreshing tips in the background");
+  tip_pool_args.stop = arg_lit0("x", "stop", "Stop the tip pool");
+  tip_pool_args.interval = arg_int0("i", "interval", "<ms>",
+                                     "Refresh interval, " TIP_POOL_STR(CONFIG_IOTA_TIP_POOL_INTERVAL_MS) " by default");
+  tip_pool_args.max_age = arg_int0("a", "max-age", "<ms>",
+                                    "Maximum tip age, " TIP_POOL_STR(CONFIG_IOTA_TIP_POOL_MAX_AGE_MS) " by default");
+  tip_pool_args.end = arg_end(5);
+  const esp_console_cmd_t tip_pool_cmd = {
+      .command = "tip_pool",
+      .help = "Show, start or stop the pool of prefetched tips",
+      .hint = " [-s [-i <ms>] [-a <ms>]] [-x]",
+      .func = &fn_tip_pool,
+      .argtable = &tip_pool_args,
+  };
+  ESP_ERROR_CHECK(esp_console_cmd_register(&tip_pool_cmd));
+}
+
+/* 'confirm_stats' command */
+static int fn_confirm_stats(int argc, char **argv) {
+  confirm_tracker_stats_t stats = {};
+  confirm_tracker_get_stats(&stats);
+  printf("pending: %" PRIu32 ", confirmed: %" PRIu32 ", reattach: %" PRIu32 ", expired: %" PRIu32 "\n", stats.pending,
+         stats.confirmed, stats.reattach, stats.expired);
+  printf("metadata requests: %" PRIu32 ", unresolved: %" PRIu32 ", node info requests: %" PRIu32
+         ", confirmed milestone: %" PRIu32 "\n",
+         stats.polls, stats.unresolved, stats.info_polls, stats.milestone);
+  return 0;
+}
+
+static void register_confirm_stats() {
+  const esp_console_cmd_t confirm_stats_cmd = {
+      .command = "confirm_stats",
+      .help = "Show the counters of the block confirmation tracker",
+      .hint = NULL,
+      .func = &fn_confirm_stats,
+  };
+  ESP_ERROR_CHECK(esp_console_cmd_register(&confirm_stats_cmd));
+}
+
 void register_restful_commands() {
   // restful api's
   register_api_node_info();
@@ -319,11 +1073,66 @@ void register_restful_commands() {
   register_api_get_blk();
   register_api_blk_meta();
   register_api_get_output();
+  register_api_get_outputs();
+  register_api_outputs();
   register_api_send_tagged_data_str();
+  register_http_pool();
+  register_api_stats();
+  register_bench_api();
+  register_node_stats();
+  register_tip_pool();
+  register_confirm_stats();
+}
+
+// parse "[http[s]://]host[:port]" entries of the backup nodes
+static void add_backup_nodes(char const *urls) {
+  char const *p = urls;
+  while (*p) {
+    size_t len = strcspn(p, ",");
+    iota_client_conf_t node = {.port = 14265, .use_tls = false};
+    char const *host = p;
+    if (strncmp(host, "https://", 8) == 0) {
+      host += 8;
+      node.use_tls = true;
+      node.port = 443;
+    } else if (strncmp(host, "http://", 7) == 0) {
+      host += 7;
+    }
+    size_t host_len = p + len - host;
+    char const *port = memchr(host, ':', host_len);
+    if (port) {
+      node.port = atoi(port + 1);
+      host_len = port - host;
+    }
+    if (host_len > 0 && host_len < sizeof(node.host)) {
+      memcpy(node.host, host, host_len);
+      if (node_set_add(&node) != 0) {
+        ESP_LOGE(TAG, "Add node %s failed\n", node.host);
+      }
+    }
+    p += len;
+    p += *p == ',' ? 1 : 0;
+  }
 }
 
 void set_resftul_node_endpoint() {
   strcpy(ctx.host, NODE_HOST);
   ctx.port = NODE_PORT;
   ctx.use_tls = NODE_USE_TLS;
+  http_client_init();
+  http_cache_clear();
+  if (rest_async_init() != 0) {
+    ESP_LOGE(TAG, "start asynchronous request workers failed");
+  }
+
+  if (strlen(CONFIG_IOTA_NODE_URLS_EXTRA) > 0) {
+    node_set_add(&ctx);
+    add_backup_nodes(CONFIG_IOTA_NODE_URLS_EXTRA);
+    node_set_probe();
+    node_set_start_probing(CONFIG_IOTA_NODE_PROBE_INTERVAL);
+  }
+
+#if CONFIG_IOTA_TIP_POOL
+  tip_pool_start(&ctx, CONFIG_IOTA_TIP_POOL_INTERVAL_MS, CONFIG_IOTA_TIP_POOL_MAX_AGE_MS);
+#endif
 }
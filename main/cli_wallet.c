@@ -1,14 +1,26 @@
 // Copyright 2021 IOTA Stiftung
 // SPDX-License-Identifier: Apache-2.0
 
+#include <inttypes.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
 #include "argtable3/argtable3.h"
 #include "core/address.h"
 #include "esp_console.h"
 #include "esp_log.h"
+#include "esp_timer.h"
 #include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
 #include "freertos/task.h"
+#include "nvs.h"
 
 #include "cli_wallet.h"
+#include "client/api/restful/get_outputs_batch.h"
+#include "client/api/restful/ledger_sync.h"
+#include "client/api/restful/outputs_id_iter.h"
+#include "client/api/restful/outputs_query.h"
 #include "core/utils/bech32.h"
 #include "sdkconfig.h"
 #include "wallet/bip39.h"
@@ -28,10 +40,220 @@
 
 #define Mi 1000000
 
+#define NODE_PARAMS_NVS_NAMESPACE "wallet"
+#define NODE_PARAMS_NVS_KEY "node_params"
+#define NODE_PARAMS_CACHE_VERSION 1
+// 2020-01-01, an earlier time means the clock is not set
+#define NODE_PARAMS_MIN_TIME 1577836800
+
 static const char *TAG = "wallet";
 
 iota_wallet_t *wallet = NULL;
 
+// protocol parameters of the node, persisted in NVS
+typedef struct {
+  uint8_t version;                                          ///< the layout version of the cache
+  int64_t updated_at;                                       ///< the time of the last update, 0 if the clock was not set
+  char host[sizeof(((iota_wallet_t *)0)->endpoint.host)];   ///< the node the parameters were fetched from
+  uint16_t port;                                            ///< the port of the node
+  uint8_t protocol_version;                                 ///< the protocol version
+  uint64_t network_id;                                      ///< the network ID
+  char bech32HRP[sizeof(((iota_wallet_t *)0)->bech32HRP)];  ///< the bech32 HRP
+  byte_cost_config_t byte_cost;                             ///< the byte cost configuration
+} node_params_t;
+
+// the parameters of the wallet, only used by the console task
+static node_params_t node_params = {};
+
+// guards the parameters fetched in the background until the console task applies them to the wallet
+static SemaphoreHandle_t node_params_lock = NULL;
+static node_params_t node_params_fetched = {};
+static bool node_params_refreshing = false;
+
+/* protocol parameters cache */
+static void node_params_from_wallet(iota_wallet_t const *w, node_params_t *params) {
+  memset(params, 0, sizeof(node_params_t));
+  params->version = NODE_PARAMS_CACHE_VERSION;
+  time_t now = time(NULL);
+  params->updated_at = now >= NODE_PARAMS_MIN_TIME ? now : 0;
+  strncpy(params->host, w->endpoint.host, sizeof(params->host) - 1);
+  params->port = w->endpoint.port;
+  params->protocol_version = w->protocol_version;
+  params->network_id = w->network_id;
+  memcpy(params->bech32HRP, w->bech32HRP, sizeof(params->bech32HRP));
+  memcpy(&params->byte_cost, &w->byte_cost, sizeof(params->byte_cost));
+}
+
+static void node_params_to_wallet(node_params_t const *params, iota_wallet_t *w) {
+  w->protocol_version = params->protocol_version;
+  w->network_id = params->network_id;
+  memcpy(w->bech32HRP, params->bech32HRP, sizeof(w->bech32HRP));
+  memcpy(&w->byte_cost, &params->byte_cost, sizeof(w->byte_cost));
+}
+
+static bool node_params_changed(node_params_t const *a, node_params_t const *b) {
+  return a->protocol_version != b->protocol_version || a->network_id != b->network_id ||
+         memcmp(a->bech32HRP, b->bech32HRP, sizeof(a->bech32HRP)) != 0 ||
+         memcmp(&a->byte_cost, &b->byte_cost, sizeof(a->byte_cost)) != 0;
+}
+
+static bool node_params_stale(node_params_t const *params) {
+  time_t now = time(NULL);
+  // without a clock the age is unknown
+  if (params->updated_at == 0 || now < NODE_PARAMS_MIN_TIME) {
+    return true;
+  }
+  return now - params->updated_at > CONFIG_WALLET_NODE_PARAMS_TTL;
+}
+
+static int node_params_load(iota_wallet_t const *w, node_params_t *params) {
+  nvs_handle_t handle;
+  if (nvs_open(NODE_PARAMS_NVS_NAMESPACE, NVS_READONLY, &handle) != ESP_OK) {
+    return -1;
+  }
+  size_t len = sizeof(node_params_t);
+  esp_err_t err = nvs_get_blob(handle, NODE_PARAMS_NVS_KEY, params, &len);
+  nvs_close(handle);
+
+  if (err != ESP_OK || len != sizeof(node_params_t) || params->version != NODE_PARAMS_CACHE_VERSION) {
+    return -1;
+  }
+  // parameters of another node are not used
+  if (strcmp(params->host, w->endpoint.host) != 0 || params->port != w->endpoint.port) {
+    return -1;
+  }
+  return 0;
+}
+
+static int node_params_save(node_params_t const *params) {
+  nvs_handle_t handle;
+  esp_err_t err = nvs_open(NODE_PARAMS_NVS_NAMESPACE, NVS_READWRITE, &handle);
+  if (err == ESP_OK) {
+    err = nvs_set_blob(handle, NODE_PARAMS_NVS_KEY, params, sizeof(node_params_t));
+    if (err == ESP_OK) {
+      err = nvs_commit(handle);
+    }
+    nvs_close(handle);
+  }
+  if (err != ESP_OK) {
+    ESP_LOGE(TAG, "Failed to save node parameters: %s\n", esp_err_to_name(err));
+    return -1;
+  }
+  return 0;
+}
+
+static iota_wallet_t *wallet_copy() {
+  iota_wallet_t *tmp = malloc(sizeof(iota_wallet_t));
+  if (!tmp) {
+    ESP_LOGE(TAG, "OOM\n");
+    return NULL;
+  }
+  memcpy(tmp, wallet, sizeof(iota_wallet_t));
+  return tmp;
+}
+
+// the copy holds the seed
+static void wallet_copy_free(iota_wallet_t *tmp) {
+  if (tmp) {
+    memset(tmp, 0, sizeof(iota_wallet_t));
+    free(tmp);
+  }
+}
+
+// fetches the parameters with a copy of the wallet and frees the copy, the wallet itself is not touched
+static int node_params_fetch_with(iota_wallet_t *tmp, node_params_t *params) {
+  int ret = wallet_update_node_config(tmp);
+  node_params_from_wallet(tmp, params);
+  wallet_copy_free(tmp);
+  if (ret != 0) {
+    ESP_LOGE(TAG, "Failed to update a node configuration!\n");
+    return -1;
+  }
+  return 0;
+}
+
+// must run on the console task, which signs and sends with the wallet
+static int node_params_update(node_params_t const *params) {
+  if (node_params.version == NODE_PARAMS_CACHE_VERSION && node_params_changed(&node_params, params)) {
+    ESP_LOGW(TAG, "Protocol parameters of the node changed\n");
+  }
+  node_params_to_wallet(params, wallet);
+  node_params = *params;
+  return node_params_save(params);
+}
+
+static int node_params_fetch() {
+  iota_wallet_t *tmp = wallet_copy();
+  node_params_t params;
+  if (!tmp || node_params_fetch_with(tmp, &params) != 0) {
+    return -1;
+  }
+  return node_params_update(&params);
+}
+
+// applies the parameters of a background refresh, called by the wallet commands before they use the wallet
+static void node_params_apply() {
+  node_params_t params = {};
+  xSemaphoreTake(node_params_lock, portMAX_DELAY);
+  if (node_params_fetched.version == NODE_PARAMS_CACHE_VERSION) {
+    params = node_params_fetched;
+    node_params_fetched.version = 0;
+  }
+  xSemaphoreGive(node_params_lock);
+  if (params.version == NODE_PARAMS_CACHE_VERSION) {
+    node_params_update(&params);
+  }
+}
+
+static void node_params_refresh_task(void *arg) {
+  node_params_t params;
+  int ret = node_params_fetch_with((iota_wallet_t *)arg, &params);
+  xSemaphoreTake(node_params_lock, portMAX_DELAY);
+  if (ret == 0) {
+    node_params_fetched = params;
+  }
+  node_params_refreshing = false;
+  xSemaphoreGive(node_params_lock);
+  vTaskDelete(NULL);
+}
+
+static void node_params_refresh() {
+  xSemaphoreTake(node_params_lock, portMAX_DELAY);
+  bool refreshing = node_params_refreshing;
+  node_params_refreshing = true;
+  xSemaphoreGive(node_params_lock);
+  if (refreshing) {
+    return;
+  }
+  // the copy is taken here, the console task is the only one that changes the wallet
+  iota_wallet_t *tmp = wallet_copy();
+  if (!tmp || xTaskCreate(node_params_refresh_task, "node_params", CONFIG_IOTA_CLIENT_TASK_STACK_SIZE, tmp,
+                          tskIDLE_PRIORITY + 5, NULL) != pdPASS) {
+    ESP_LOGE(TAG, "Failed to create the node parameters task\n");
+    wallet_copy_free(tmp);
+    xSemaphoreTake(node_params_lock, portMAX_DELAY);
+    node_params_refreshing = false;
+    xSemaphoreGive(node_params_lock);
+  }
+}
+
+static int node_params_init() {
+  node_params_lock = xSemaphoreCreateMutex();
+  if (node_params_lock == NULL) {
+    ESP_LOGE(TAG, "OOM\n");
+    return -1;
+  }
+  if (CONFIG_WALLET_NODE_PARAMS_TTL > 0 && node_params_load(wallet, &node_params) == 0) {
+    node_params_to_wallet(&node_params, wallet);
+    if (node_params_stale(&node_params)) {
+      ESP_LOGI(TAG, "Cached node parameters are stale, refreshing in the background\n");
+      node_params_refresh();
+    }
+    return 0;
+  }
+  return node_params_fetch();
+}
+
 static void dump_address(iota_wallet_t *w, uint32_t index, bool is_change) {
   char bech32_addr[BECH32_MAX_STRING_LEN + 1];
   address_t address;
@@ -68,6 +290,7 @@ static int fn_get_address(int argc, char **argv) {
     arg_print_errors(stderr, get_addr_args.end, argv[0]);
     return -1;
   }
+  node_params_apply();
   uint32_t start = (uint32_t)get_addr_args.idx_start->dval[0];
   uint32_t count = (uint32_t)get_addr_args.idx_count->dval[0];
   bool is_change = get_addr_args.is_change->ival[0];
@@ -108,6 +331,7 @@ static int fn_wallet_send_token(int argc, char **argv) {
     arg_print_errors(stderr, wallet_send_token_args.end, argv[0]);
     return -1;
   }
+  node_params_apply();
 
   uint32_t const sender_addr_index = wallet_send_token_args.sender_index->dval[0];      // address index of a sender
   uint32_t const receiver_addr_index = wallet_send_token_args.receiver_index->dval[0];  // address index of a receiver
@@ -152,6 +376,8 @@ static int fn_wallet_send_token(int argc, char **argv) {
   if (blk_res.is_error) {
     ESP_LOGE(TAG, "Error: %s\n", blk_res.u.error->msg);
     res_err_free(blk_res.u.error);
+    // the block may be rejected because the protocol parameters changed
+    node_params_refresh();
     return -1;
   }
 
@@ -176,12 +402,276 @@ static void register_wallet_send_token() {
   ESP_ERROR_CHECK(esp_console_cmd_register(&wallet_send_token_cmd));
 }
 
+/* 'wallet_balance' command */
+#define WALLET_BALANCE_PAGE_SIZE 100
+// outputs fetched concurrently by get_outputs_batch()
+#define WALLET_BALANCE_BATCH 16
+
+static struct {
+  struct arg_dbl *index;
+  struct arg_lit *all;
+  struct arg_end *end;
+} wallet_balance_args;
+
+// the basic outputs of an address found by the indexer
+typedef struct {
+  uint64_t balance;       ///< the sum of the amounts
+  size_t count;           ///< the number of outputs
+  uint32_t ledger_index;  ///< the ledger index of the indexer response
+} address_scan_t;
+
+static int wallet_address(uint32_t index, address_t *addr, char bech32_addr[], size_t len) {
+  if (wallet_ed25519_address_from_index(wallet, false, index, addr) != 0 ||
+      address_to_bech32(addr, wallet->bech32HRP, bech32_addr, len) != 0) {
+    ESP_LOGE(TAG, "Failed to get the address!\n");
+    return -1;
+  }
+  return 0;
+}
+
+// adds the amounts of the basic outputs of a batch, they are also watched by ls if it is not NULL
+static int scan_add_outputs(char const *const output_ids[], size_t count, address_scan_t *scan, ledger_sync_t *ls) {
+  output_batch_item_t results[WALLET_BALANCE_BATCH] = {};
+  int ret = get_outputs_batch(&wallet->endpoint, output_ids, count, 0, results);
+  for (size_t i = 0; ret == 0 && i < count; i++) {
+    if (results[i].ret != 0 || results[i].res->is_error) {
+      ESP_LOGE(TAG, "Failed to get output %s\n", output_ids[i]);
+      ret = -1;
+    } else if (results[i].res->u.data->output->output_type == OUTPUT_BASIC) {
+      uint64_t amount = ((output_basic_t *)results[i].res->u.data->output->output)->amount;
+      scan->balance += amount;
+      ret = ls ? ledger_sync_watch_output(ls, output_ids[i], amount) : 0;
+    }
+  }
+  get_outputs_batch_free(results, count);
+  return ret;
+}
+
+static int address_scan(char const bech32_addr[], bool all, address_scan_t *scan, ledger_sync_t *ls) {
+  memset(scan, 0, sizeof(address_scan_t));
+  // the node filters out outputs with conditions, so the amount of every remaining output can be spent
+  outputs_query_t filters = {.address = bech32_addr};
+  if (!all) {
+    outputs_query_spendable(&filters, bech32_addr);
+  }
+  char query[256] = {};
+  if (outputs_query_str(&filters, query, sizeof(query)) < 0) {
+    return -1;
+  }
+
+  outputs_id_iter_t *it = outputs_id_iter_new(&wallet->endpoint, query, WALLET_BALANCE_PAGE_SIZE, true);
+  if (it == NULL) {
+    ESP_LOGE(TAG, "Failed to create the output ID iterator!\n");
+    return -1;
+  }
+
+  char output_ids[WALLET_BALANCE_BATCH][OUTPUTS_ID_HEX_LEN + 1];
+  char const *batch[WALLET_BALANCE_BATCH];
+  size_t batch_len = 0;
+  int ret;
+  while ((ret = outputs_id_iter_next(it, output_ids[batch_len])) == 0) {
+    batch[batch_len] = output_ids[batch_len];
+    scan->count++;
+    if (++batch_len == WALLET_BALANCE_BATCH) {
+      batch_len = 0;
+      if (scan_add_outputs(batch, WALLET_BALANCE_BATCH, scan, ls) != 0) {
+        break;
+      }
+    }
+  }
+  if (ret == 1) {
+    // the last output IDs
+    ret = batch_len ? scan_add_outputs(batch, batch_len, scan, ls) : 0;
+  } else if (ret < 0) {
+    res_err_t const *error = outputs_id_iter_error(it);
+    ESP_LOGE(TAG, "%s\n", error ? error->msg : "Failed to get the output IDs!");
+  } else {
+    // a batch failed
+    ret = -1;
+  }
+  scan->ledger_index = outputs_id_iter_ledger_index(it);
+  outputs_id_iter_free(it);
+  return ret;
+}
+
+static int fn_wallet_balance(int argc, char **argv) {
+  int nerrors = arg_parse(argc, argv, (void **)&wallet_balance_args);
+  if (nerrors != 0) {
+    arg_print_errors(stderr, wallet_balance_args.end, argv[0]);
+    return -1;
+  }
+  node_params_apply();
+
+  address_t addr;
+  char bech32_addr[BECH32_MAX_STRING_LEN + 1] = {};
+  if (wallet_address((uint32_t)wallet_balance_args.index->dval[0], &addr, bech32_addr, sizeof(bech32_addr)) != 0) {
+    return -1;
+  }
+
+  int64_t start = esp_timer_get_time();
+  address_scan_t scan;
+  if (address_scan(bech32_addr, wallet_balance_args.all->count > 0, &scan, NULL) != 0) {
+    return -1;
+  }
+  printf("Address: %s\n", bech32_addr);
+  printf("%s: %" PRIu64 " in %zu outputs at ledger index %" PRIu32 "\n",
+         wallet_balance_args.all->count ? "Basic outputs" : "Spendable", scan.balance, scan.count, scan.ledger_index);
+  printf("Took %" PRId64 " ms\n", (esp_timer_get_time() - start) / 1000);
+  return 0;
+}
+
+static void register_wallet_balance() {
+  wallet_balance_args.index = arg_dbl1(NULL, NULL, "<index>", "address index");
+  wallet_balance_args.all =
+      arg_lit0("a", "all", "Include outputs with storage deposit return, timelock or expiration conditions");
+  wallet_balance_args.end = arg_end(3);
+  const esp_console_cmd_t wallet_balance_cmd = {
+      .command = "wallet_balance",
+      .help = "Get the balance of an address from the filtered basic outputs of the indexer",
+      .hint = " <index> [-a]",
+      .func = &fn_wallet_balance,
+      .argtable = &wallet_balance_args,
+  };
+  ESP_ERROR_CHECK(esp_console_cmd_register(&wallet_balance_cmd));
+}
+
+/* 'wallet_sync' command */
+static struct {
+  struct arg_dbl *index;
+  struct arg_lit *reset;
+  struct arg_end *end;
+} wallet_sync_args;
+
+// the outputs of one address kept current with the UTXO changes of the milestones
+static ledger_sync_t *ledger = NULL;
+static uint32_t ledger_addr_index = 0;
+
+static void print_ledger_change(char const output_id[], uint64_t amount, bool spent, uint32_t milestone_index,
+                                void *ctx) {
+  printf("%c%" PRIu64 " %s at milestone %" PRIu32 "\n", spent ? '-' : '+', amount, output_id, milestone_index);
+}
+
+static int ledger_seed(uint32_t index) {
+  address_t addr;
+  char bech32_addr[BECH32_MAX_STRING_LEN + 1] = {};
+  if (wallet_address(index, &addr, bech32_addr, sizeof(bech32_addr)) != 0) {
+    return -1;
+  }
+
+  ledger_sync_free(ledger);
+  ledger = ledger_sync_new(&wallet->endpoint, print_ledger_change, NULL);
+  address_scan_t scan;
+  if (ledger == NULL || ledger_sync_watch_address(ledger, &addr) != 0 ||
+      address_scan(bech32_addr, false, &scan, ledger) != 0) {
+    ESP_LOGE(TAG, "Failed to seed the outputs!\n");
+    ledger_sync_free(ledger);
+    ledger = NULL;
+    return -1;
+  }
+  ledger_sync_set_index(ledger, scan.ledger_index);
+  ledger_addr_index = index;
+  printf("Address: %s\n", bech32_addr);
+  printf("Seeded %zu outputs at ledger index %" PRIu32 "\n", scan.count, scan.ledger_index);
+  return 0;
+}
+
+static int fn_wallet_sync(int argc, char **argv) {
+  int nerrors = arg_parse(argc, argv, (void **)&wallet_sync_args);
+  if (nerrors != 0) {
+    arg_print_errors(stderr, wallet_sync_args.end, argv[0]);
+    return -1;
+  }
+  node_params_apply();
+
+  uint32_t index = (uint32_t)wallet_sync_args.index->dval[0];
+  int64_t start = esp_timer_get_time();
+  // the indexer is only queried once, later calls apply the milestones since the last one
+  if ((ledger == NULL || ledger_addr_index != index || wallet_sync_args.reset->count) && ledger_seed(index) != 0) {
+    return -1;
+  }
+  int ret = ledger_sync_catch_up(ledger, 0);
+  if (ret != 0) {
+    ESP_LOGE(TAG, "Failed to apply milestone %" PRIu32 ", use -r if it was pruned\n", ledger_sync_index(ledger) + 1);
+  }
+
+  ledger_sync_stats_t stats = {};
+  ledger_sync_get_stats(ledger, &stats);
+  printf("Spendable: %" PRIu64 " in %zu outputs at milestone %" PRIu32 "\n", ledger_sync_balance(ledger),
+         ledger_sync_outputs(ledger), ledger_sync_index(ledger));
+  printf("Applied %" PRIu32 " milestones, fetched %" PRIu32 " of %" PRIu32 " created outputs\n", stats.milestones,
+         stats.fetched, stats.created);
+  printf("Took %" PRId64 " ms\n", (esp_timer_get_time() - start) / 1000);
+  return ret;
+}
+
+static void register_wallet_sync() {
+  wallet_sync_args.index = arg_dbl1(NULL, NULL, "<index>", "address index");
+  wallet_sync_args.reset = arg_lit0("r", "reset", "Seed the outputs from the indexer again");
+  wallet_sync_args.end = arg_end(3);
+  const esp_console_cmd_t wallet_sync_cmd = {
+      .command = "wallet_sync",
+      .help = "Keep the balance of an address current with the UTXO changes of each milestone",
+      .hint = " <index> [-r]",
+      .func = &fn_wallet_sync,
+      .argtable = &wallet_sync_args,
+  };
+  ESP_ERROR_CHECK(esp_console_cmd_register(&wallet_sync_cmd));
+}
+
+/* 'wallet_node_params' command */
+static struct {
+  struct arg_lit *refresh;
+  struct arg_end *end;
+} wallet_node_params_args;
+
+static int fn_wallet_node_params(int argc, char **argv) {
+  int nerrors = arg_parse(argc, argv, (void **)&wallet_node_params_args);
+  if (nerrors != 0) {
+    arg_print_errors(stderr, wallet_node_params_args.end, argv[0]);
+    return -1;
+  }
+
+  node_params_apply();
+  // a refresh in the background may still finish later, it fetches the same parameters
+  if (wallet_node_params_args.refresh->count && node_params_fetch() != 0) {
+    return -1;
+  }
+
+  printf("Node: %s:%u\n", node_params.host, node_params.port);
+  printf("Protocol version: %u\n", wallet->protocol_version);
+  printf("Network ID: %" PRIu64 "\n", wallet->network_id);
+  printf("Bech32 HRP: %s\n", wallet->bech32HRP);
+  if (node_params.updated_at) {
+    printf("Updated %" PRId64 " seconds ago%s\n", (int64_t)time(NULL) - node_params.updated_at,
+           node_params_stale(&node_params) ? " (stale)" : "");
+  } else {
+    printf("Update time unknown\n");
+  }
+  return 0;
+}
+
+static void register_wallet_node_params() {
+  wallet_node_params_args.refresh = arg_lit0("r", "refresh", "Fetch the parameters from the node");
+  wallet_node_params_args.end = arg_end(2);
+  const esp_console_cmd_t wallet_node_params_cmd = {
+      .command = "wallet_node_params",
+      .help = "Show the cached protocol parameters of the node",
+      .hint = " [-r]",
+      .func = &fn_wallet_node_params,
+      .argtable = &wallet_node_params_args,
+  };
+  ESP_ERROR_CHECK(esp_console_cmd_register(&wallet_node_params_cmd));
+}
+
 //============= Public functions====================
 
 void register_wallet_commands() {
   // wallet APIs
   register_wallet_send_token();
   register_wallet_get_address();
+  register_wallet_balance();
+  register_wallet_sync();
+  register_wallet_node_params();
 }
 
 int init_wallet() {
@@ -201,8 +691,8 @@ int init_wallet() {
     return -1;
   }
 
-  if (wallet_update_node_config(wallet) != 0) {
-    ESP_LOGE(TAG, "Failed to update a node configuration!\n");
+  // protocol parameters are cached in NVS and refreshed in the background once they are older than the TTL
+  if (node_params_init() != 0) {
     wallet_destroy(wallet);
     return -1;
   }
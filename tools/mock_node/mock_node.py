@@ -0,0 +1,263 @@
+#!/usr/bin/env python3
+# Copyright 2022 IOTA Stiftung
+# SPDX-License-Identifier: Apache-2.0
+"""A stand-in IOTA node serving recorded responses of the REST endpoints used by the client.
+
+Any block or output ID is accepted and answered with the fixture of its endpoint. Latency, bandwidth and errors can
+be injected to benchmark the client without a live node, e.g.
+
+    python3 tools/mock_node/mock_node.py --port 14265 --latency-ms 20 --jitter-ms 10 --error-rate 0.05
+"""
+
+import argparse
+import gzip
+import hashlib
+import json
+import os
+import random
+import re
+import signal
+import socket
+import ssl
+import struct
+import sys
+import threading
+import time
+from http.server import BaseHTTPRequestHandler, ThreadingHTTPServer
+from urllib.parse import parse_qs, urlparse
+
+FIXTURES_DIR = os.path.join(os.path.dirname(os.path.abspath(__file__)), "fixtures")
+BINARY_MEDIA_TYPE = "application/vnd.iota.serializer-v1"
+TAGGED_DATA_PAYLOAD = 5
+PAGE_SIZE_MAX = 1000
+
+
+def hex_bytes(value):
+    return bytes.fromhex(value[2:] if value.startswith("0x") else value)
+
+
+def block_to_binary(block):
+    """Serialize a block with a tagged data payload, other payloads are not supported."""
+    payload = b""
+    if block.get("payload"):
+        if block["payload"]["type"] != TAGGED_DATA_PAYLOAD:
+            return None
+        tag = hex_bytes(block["payload"]["tag"])
+        data = hex_bytes(block["payload"]["data"])
+        payload = struct.pack("<IB", TAGGED_DATA_PAYLOAD, len(tag)) + tag + struct.pack("<I", len(data)) + data
+    parents = b"".join(hex_bytes(p) for p in block["parents"])
+    return (struct.pack("<BB", block["protocolVersion"], len(block["parents"])) + parents +
+            struct.pack("<I", len(payload)) + payload + struct.pack("<Q", int(block["nonce"])))
+
+
+def block_id(body):
+    return "0x" + hashlib.blake2b(body, digest_size=32).hexdigest()
+
+
+class Stats:
+    """Request counters printed on exit."""
+
+    def __init__(self):
+        self.lock = threading.Lock()
+        self.requests = {}
+        self.errors = 0
+        self.drops = 0
+
+    def count(self, method, path):
+        route = re.sub(r"/0x[0-9a-fA-F]+", "/{id}", path)
+        route = re.sub(r"/\d+(/|$)", r"/{index}\1", route)
+        with self.lock:
+            key = method + " " + route
+            self.requests[key] = self.requests.get(key, 0) + 1
+
+    def dump(self):
+        for key, count in sorted(self.requests.items()):
+            print("%8d  %s" % (count, key))
+        print("injected errors: %d, dropped connections: %d" % (self.errors, self.drops))
+
+
+class MockNode:
+    """The responses and the fault injection settings."""
+
+    def __init__(self, args):
+        self.args = args
+        self.fixtures = {}
+        for name in ("info", "block", "block_metadata", "output"):
+            with open(os.path.join(args.fixtures, name + ".json")) as f:
+                self.fixtures[name] = json.load(f)
+        self.block_binary = block_to_binary(self.fixtures["block"])
+        self.output_ids = [
+            "0x" + hashlib.blake2b(struct.pack("<I", i), digest_size=32).hexdigest() + struct.pack("<H", 0).hex()
+            for i in range(args.outputs)
+        ]
+        self.stats = Stats()
+        self.rng = random.Random(args.seed)
+        self.rng_lock = threading.Lock()
+
+    def chance(self, rate):
+        with self.rng_lock:
+            return rate > 0 and self.rng.random() < rate
+
+    def delay(self):
+        with self.rng_lock:
+            jitter = self.rng.uniform(-self.args.jitter_ms, self.args.jitter_ms) if self.args.jitter_ms else 0
+        latency = max(0.0, self.args.latency_ms + jitter) / 1000
+        if latency:
+            time.sleep(latency)
+
+    def tips(self):
+        parents = self.fixtures["block"]["parents"]
+        return {"tips": parents}
+
+    def outputs_page(self, query):
+        page_size = min(int(query.get("pageSize", ["100"])[0]), PAGE_SIZE_MAX)
+        cursor = query.get("cursor", [""])[0]
+        offset = int(cursor.split(".")[0], 16) if cursor else 0
+        items = self.output_ids[offset:offset + page_size]
+        page = {"ledgerIndex": self.fixtures["info"]["status"]["confirmedMilestone"]["index"], "pageSize": page_size,
+                "items": items}
+        if offset + page_size < len(self.output_ids):
+            page["cursor"] = "%08x.%d" % (offset + page_size, page_size)
+        return page
+
+
+class Handler(BaseHTTPRequestHandler):
+    protocol_version = "HTTP/1.1"
+    server_version = "mock-node"
+    node = None
+
+    def log_message(self, fmt, *args):
+        if self.node.args.verbose:
+            sys.stderr.write("%s %s\n" % (self.address_string(), fmt % args))
+
+    def send_body(self, status, body, content_type="application/json"):
+        if self.node.args.gzip and "gzip" in self.headers.get("Accept-Encoding", ""):
+            body = gzip.compress(body)
+            encoding = "gzip"
+        else:
+            encoding = None
+        self.send_response(status)
+        self.send_header("Content-Type", content_type)
+        self.send_header("Content-Length", str(len(body)))
+        if encoding:
+            self.send_header("Content-Encoding", encoding)
+        self.end_headers()
+
+        bandwidth = self.node.args.bandwidth
+        if bandwidth <= 0:
+            self.wfile.write(body)
+            return
+        # throttle the body in chunks
+        chunk = 512
+        for i in range(0, len(body), chunk):
+            self.wfile.write(body[i:i + chunk])
+            self.wfile.flush()
+            time.sleep(min(chunk, len(body) - i) / bandwidth)
+
+    def send_json(self, status, obj):
+        self.send_body(status, json.dumps(obj, separators=(",", ":")).encode())
+
+    def send_error_json(self, status, message):
+        self.send_json(status, {"error": {"code": str(status), "message": message}})
+
+    def inject_faults(self):
+        """Returns True if the request was answered by a fault."""
+        self.node.delay()
+        if self.node.chance(self.node.args.drop_rate):
+            with self.node.stats.lock:
+                self.node.stats.drops += 1
+            self.close_connection = True
+            self.connection.shutdown(socket.SHUT_RDWR)
+            return True
+        if self.node.chance(self.node.args.error_rate):
+            with self.node.stats.lock:
+                self.node.stats.errors += 1
+            self.send_error_json(500, "injected error")
+            return True
+        return False
+
+    def do_GET(self):
+        url = urlparse(self.path)
+        path = url.path
+        self.node.stats.count("GET", path)
+        if self.inject_faults():
+            return
+
+        fixtures = self.node.fixtures
+        if path == "/health":
+            self.send_body(503 if self.node.args.unhealthy else 200, b"")
+        elif path == "/api/core/v2/info":
+            self.send_json(200, fixtures["info"])
+        elif path == "/api/core/v2/tips":
+            self.send_json(200, self.node.tips())
+        elif re.fullmatch(r"/api/core/v2/blocks/0x[0-9a-fA-F]{64}", path):
+            if BINARY_MEDIA_TYPE in self.headers.get("Accept", "") and self.node.block_binary:
+                self.send_body(200, self.node.block_binary, BINARY_MEDIA_TYPE)
+            else:
+                self.send_json(200, fixtures["block"])
+        elif re.fullmatch(r"/api/core/v2/blocks/0x[0-9a-fA-F]{64}/metadata", path):
+            meta = dict(fixtures["block_metadata"], blockId=path.split("/")[5])
+            self.send_json(200, meta)
+        elif re.fullmatch(r"/api/core/v2/outputs/0x[0-9a-fA-F]{68}", path):
+            self.send_json(200, fixtures["output"])
+        elif re.fullmatch(r"/api/core/v2/outputs/0x[0-9a-fA-F]{68}/metadata", path):
+            self.send_json(200, fixtures["output"]["metadata"])
+        elif path == "/api/indexer/v1/outputs/basic":
+            self.send_json(200, self.node.outputs_page(parse_qs(url.query)))
+        else:
+            self.send_error_json(404, "no fixture for " + path)
+
+    def do_POST(self):
+        path = urlparse(self.path).path
+        body = self.rfile.read(int(self.headers.get("Content-Length", "0")))
+        self.node.stats.count("POST", path)
+        if self.inject_faults():
+            return
+
+        if path == "/api/core/v2/blocks":
+            # not the ID the protocol defines, but unique per block
+            self.send_json(201, {"blockId": block_id(body)})
+        else:
+            self.send_error_json(404, "no fixture for " + path)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("--host", default="0.0.0.0", help="listen address")
+    parser.add_argument("--port", type=int, default=14265, help="listen port")
+    parser.add_argument("--fixtures", default=FIXTURES_DIR, help="directory of the recorded responses")
+    parser.add_argument("--latency-ms", type=float, default=0, help="delay before each response")
+    parser.add_argument("--jitter-ms", type=float, default=0, help="random variation of the delay")
+    parser.add_argument("--bandwidth", type=int, default=0, help="response body bytes per second, 0 for unlimited")
+    parser.add_argument("--error-rate", type=float, default=0, help="share of requests answered with HTTP 500")
+    parser.add_argument("--drop-rate", type=float, default=0, help="share of connections closed without a response")
+    parser.add_argument("--outputs", type=int, default=250, help="output IDs returned by the indexer")
+    parser.add_argument("--gzip", action="store_true", help="compress responses if the client accepts gzip")
+    parser.add_argument("--unhealthy", action="store_true", help="answer /health with 503")
+    parser.add_argument("--cert", help="certificate file to serve HTTPS")
+    parser.add_argument("--key", help="private key file of the certificate")
+    parser.add_argument("--seed", type=int, default=None, help="seed of the fault injection")
+    parser.add_argument("-v", "--verbose", action="store_true", help="log each request")
+    args = parser.parse_args()
+
+    Handler.node = MockNode(args)
+    server = ThreadingHTTPServer((args.host, args.port), Handler)
+    server.daemon_threads = True
+    scheme = "http"
+    if args.cert:
+        ctx = ssl.SSLContext(ssl.PROTOCOL_TLS_SERVER)
+        ctx.load_cert_chain(args.cert, args.key)
+        server.socket = ctx.wrap_socket(server.socket, server_side=True)
+        scheme = "https"
+    print("mock node on %s://%s:%d" % (scheme, args.host, args.port), flush=True)
+    signal.signal(signal.SIGTERM, lambda *_: sys.exit(0))
+    try:
+        server.serve_forever()
+    except (KeyboardInterrupt, SystemExit):
+        pass
+    server.server_close()
+    Handler.node.stats.dump()
+
+
+if __name__ == "__main__":
+    main()